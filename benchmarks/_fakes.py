@@ -0,0 +1,97 @@
+"""
+Synthetic data for benchmarks, built on scippneutron.tof.fakes so that no Mantid
+installation or downloaded files are needed
+"""
+import os
+from typing import Optional
+
+import numpy as np
+import scipp as sc
+
+from scippneutron.tof import fakes
+
+EVENT_COUNTS = [10**5, 10**7, 10**9]
+# 10^9 events need tens of GB of memory, so large parametrisations are skipped
+# unless enabled with this environment variable
+MAX_EVENTS = int(float(os.environ.get('SCIPPNEUTRON_BENCHMARK_MAX_EVENTS', 1e7)))
+
+# 10 s at 14 Hz
+N_PULSES = 140
+MONITOR_DISTANCE = sc.scalar(46.0, unit='m')
+DETECTOR_DISTANCE = sc.scalar(60.0, unit='m')
+
+
+def skip_if_too_large(n_events: int) -> None:
+    if n_events > MAX_EVENTS:
+        # asv skips benchmarks whose setup raises NotImplementedError
+        raise NotImplementedError(
+            f'{n_events} events exceed SCIPPNEUTRON_BENCHMARK_MAX_EVENTS={MAX_EVENTS}'
+        )
+
+
+def source() -> fakes.FakeSource:
+    return fakes.FakeSource(
+        frequency=sc.scalar(14.0, unit='Hz'), run_length=sc.scalar(10.0, unit='s')
+    )
+
+
+def pulse() -> fakes.FakePulse:
+    return fakes.FakePulse(
+        time_min=sc.scalar(0.0, unit='ms'),
+        time_max=sc.scalar(3.0, unit='ms'),
+        wavelength_min=sc.scalar(0.1, unit='angstrom'),
+        wavelength_max=sc.scalar(10.0, unit='angstrom'),
+    )
+
+
+def beamline() -> fakes.FakeBeamline:
+    return fakes.FakeBeamline(
+        source=source(),
+        pulse=pulse(),
+        choppers=fakes.psc_choppers,
+        monitors={'monitor': MONITOR_DISTANCE},
+        detectors={'detector': DETECTOR_DISTANCE},
+        time_of_flight_origin='psc1',
+    )
+
+
+def wrapped_events(
+    name: str, n_events: int, n_pixels: Optional[int] = None
+) -> sc.DataArray:
+    """
+    About n_events events of a monitor or detector of beamline(),
+    binned by pulse as in NXevent_data
+    """
+    generator = beamline().bulk_events(
+        name,
+        pulses_per_chunk=N_PULSES,
+        # Pulse sizes are uniform in [0, events_per_pulse)
+        events_per_pulse=2 * n_events // N_PULSES + 1,
+        n_pixels=n_pixels,
+    )
+    return generator.chunk(0)
+
+
+def tof_events(n_events: int, n_pixels: int, dtype: str = 'float64') -> sc.DataArray:
+    """
+    About n_events detector events with a tof coord, binned by spectrum,
+    with pixels on a circle around the sample
+    """
+    events = wrapped_events('detector', n_events, n_pixels).bins.concat().value
+    events.coords['tof'] = events.coords.pop('event_time_offset').to(
+        unit='us', dtype=dtype
+    )
+    events.data = events.data.to(dtype=dtype)
+    da = events.group(sc.arange('event_id', n_pixels, unit=None, dtype='int32'))
+    da = da.rename_dims(event_id='spectrum')
+    theta = np.linspace(0.1, 2.5, n_pixels)
+    da.coords['position'] = sc.vectors(
+        dims=['spectrum'],
+        values=np.stack([2 * np.sin(theta), np.zeros(n_pixels), 2 * np.cos(theta)], 1),
+        unit='m',
+    )
+    da.coords['sample_position'] = sc.vector([0.0, 0.0, 0.0], unit='m')
+    da.coords['source_position'] = sc.vector(
+        [0.0, 0.0, -DETECTOR_DISTANCE.value + 2.0], unit='m'
+    )
+    return da
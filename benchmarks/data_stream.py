@@ -0,0 +1,293 @@
+import asyncio
+import datetime
+import multiprocessing as mp
+import threading
+import time
+
+import numpy as np
+import scipp as sc
+from streaming_data_types.eventdata_ev42 import serialise_ev42
+from streaming_data_types.logdata_f142 import serialise_f142
+from streaming_data_types.sample_environment_senv import Location, serialise_senv
+from streaming_data_types.timestamps_tdct import serialise_tdct
+
+from scippneutron._utils import get_attrs
+from scippneutron.data_streaming._consumer import FakeMessage
+from scippneutron.data_streaming._consumer_type import ConsumerType
+from scippneutron.data_streaming._data_buffer import StreamedDataBuffer
+from scippneutron.data_streaming.data_stream import _data_stream
+from scippneutron.io.nexus._json_nexus import StreamInfo
+
+# Synthetic data sources, messages are sent for each of them
+_EVENT_SOURCE = "benchmark_detector"
+_METADATA_STREAMS = [
+    StreamInfo("benchmark", "f142", "benchmark_log", np.float64, "K"),
+    StreamInfo("benchmark", "senv", "benchmark_sample_env", np.int64, "V"),
+    StreamInfo("benchmark", "tdct", "benchmark_chopper", np.int64, "ns"),
+]
+# Number of event messages per metadata message of each type
+_EVENT_MESSAGES_PER_METADATA_MESSAGE = 10
+
+
+def _event_payload(n_events: int, pulse_time_ns: int, message_id: int = 0) -> bytes:
+    rng = np.random.default_rng(message_id)
+    return serialise_ev42(
+        _EVENT_SOURCE,
+        message_id,
+        pulse_time_ns,
+        rng.integers(0, 71_000_000, n_events, dtype=np.int32),
+        rng.integers(0, 100_000, n_events, dtype=np.int32),
+    )
+
+
+def _metadata_payloads(timestamp_ns: int) -> list:
+    return [
+        serialise_f142(1.5, "benchmark_log", timestamp_ns),
+        serialise_senv(
+            "benchmark_sample_env",
+            -1,
+            datetime.datetime.fromtimestamp(timestamp_ns * 1e-9, datetime.timezone.utc),
+            100,
+            0,
+            np.arange(100, dtype=np.int64),
+            Location.Start,
+        ),
+        serialise_tdct(
+            "benchmark_chopper", np.arange(10, dtype=np.uint64) + timestamp_ns
+        ),
+    ]
+
+
+def _payloads(n_event_messages: int, events_per_message: int) -> list:
+    payloads = []
+    for message_id in range(n_event_messages):
+        payloads.append(_event_payload(events_per_message, time.time_ns(), message_id))
+        if message_id % _EVENT_MESSAGES_PER_METADATA_MESSAGE == 0:
+            payloads.extend(_metadata_payloads(time.time_ns()))
+    return payloads
+
+
+class _DiscardQueue:
+    def put(self, _):
+        pass
+
+
+class StreamedDataBufferIngest:
+    """
+    Deserialising and buffering a batch of payloads as consumers do in the
+    data consumption process, without any queues or processes involved
+    """
+
+    params = ([2**16, 2**20], [100, 10_000])
+    param_names = ['event_buffer_size', 'events_per_message']
+    timeout = 300
+    n_event_messages = 100
+
+    def setup(self, event_buffer_size, events_per_message):
+        self.payloads = _payloads(self.n_event_messages, events_per_message)
+        self.buffer = StreamedDataBuffer(
+            _DiscardQueue(),
+            event_buffer_size=event_buffer_size,
+            slow_metadata_buffer_size=1000,
+            fast_metadata_buffer_size=100_000,
+            chopper_buffer_size=10_000,
+            interval_s=3600.0,
+            run_id="",
+        )
+        self.buffer.init_metadata_buffers(_METADATA_STREAMS)
+        # The emit thread frees buffers when the batch does not fit in them
+        self.buffer.start()
+
+    def teardown(self, event_buffer_size, events_per_message):
+        self.buffer.stop()
+
+    def _ingest_and_emit(self):
+        self.buffer.new_data_batch(self.payloads)
+        self.buffer._emit_data()
+
+    def time_ingest_and_emit(self, event_buffer_size, events_per_message):
+        self._ingest_and_emit()
+
+    def track_events_per_second(self, event_buffer_size, events_per_message):
+        n_repeats = 5
+        start = time.perf_counter()
+        for _ in range(n_repeats):
+            self._ingest_and_emit()
+        elapsed = time.perf_counter() - start
+        return n_repeats * self.n_event_messages * events_per_message / elapsed
+
+    track_events_per_second.unit = "events/s"
+
+
+class _NoQueryConsumer:
+    # Only needed to find run start messages, which are not used here
+    pass
+
+
+class _StreamStats:
+    def __init__(self):
+        self.n_events = 0
+        self.n_metadata_chunks = 0
+        self.elapsed_s = np.nan
+        self.latencies_s = []
+        self.queue_depths = []
+
+
+def _queue_depth(queue: mp.Queue) -> float:
+    try:
+        return queue.qsize()
+    except NotImplementedError:
+        # Not available on macOS
+        return np.nan
+
+
+def _run_data_stream(
+    event_buffer_size: int,
+    interval_s: float,
+    n_event_messages: int,
+    events_per_message: int,
+    messages_per_second: float = np.inf,
+) -> _StreamStats:
+    """
+    Feed messages to data_stream through a FakeConsumer at the given rate
+    and collect statistics on the chunks it yields, until all events
+    have been yielded.
+    The metadata streams are set up as for StreamedDataBufferIngest,
+    so that their messages are buffered like the events.
+    """
+    ctx = mp.get_context("spawn")
+    data_queue, instruction_queue, message_queue = (ctx.Queue() for _ in range(3))
+    stats = _StreamStats()
+    n_expected_events = n_event_messages * events_per_message
+    template = _event_payload(events_per_message, 0)
+
+    def feed():
+        for message_id in range(n_event_messages):
+            if np.isfinite(messages_per_second):
+                time.sleep(1.0 / messages_per_second)
+                # Payloads carry the time they are sent as the pulse time
+                # so that the latency to data_stream can be measured
+                payload = _event_payload(events_per_message, time.time_ns(), message_id)
+            else:
+                payload = template
+            message_queue.put(FakeMessage(payload))
+            if message_id % _EVENT_MESSAGES_PER_METADATA_MESSAGE == 0:
+                for metadata_payload in _metadata_payloads(time.time_ns()):
+                    message_queue.put(FakeMessage(metadata_payload))
+
+    async def consume():
+        stream = _data_stream(
+            data_queue,
+            instruction_queue,
+            kafka_broker="",
+            topics=["benchmark"],
+            interval=interval_s * sc.units.s,
+            event_buffer_size=event_buffer_size,
+            slow_metadata_buffer_size=1000,
+            fast_metadata_buffer_size=100_000,
+            chopper_buffer_size=10_000,
+            consumer_type=ConsumerType.FAKE,
+            test_message_queue=message_queue,
+            query_consumer=_NoQueryConsumer(),
+            timeout=600.0 * sc.units.s,
+            stream_info=_METADATA_STREAMS,
+        )
+        feeder = threading.Thread(target=feed)
+        start = time.perf_counter()
+        feeder.start()
+        try:
+            async for chunk in stream:
+                now_ns = time.time_ns()
+                stats.queue_depths.append(_queue_depth(data_queue))
+                if any(
+                    len(get_attrs(chunk)[stream.source_name].value)
+                    for stream in _METADATA_STREAMS
+                    if stream.source_name in get_attrs(chunk)
+                ):
+                    stats.n_metadata_chunks += 1
+                n_chunk_events = chunk.sizes['event']
+                if n_chunk_events == 0:
+                    continue
+                stats.n_events += n_chunk_events
+                pulse_times = chunk.coords['pulse_time'].values
+                stats.latencies_s.append((now_ns - int(pulse_times.min())) * 1e-9)
+                if stats.n_events >= n_expected_events:
+                    break
+            stats.elapsed_s = time.perf_counter() - start
+        finally:
+            await stream.aclose()
+            feeder.join()
+
+    asyncio.run(consume())
+    if stats.n_metadata_chunks == 0:
+        raise RuntimeError("data_stream yielded no metadata")
+    return stats
+
+
+class DataStreamThroughput:
+    """
+    Sustained rate of events from a FakeConsumer to the chunks yielded by
+    data_stream, when messages are fed as fast as possible
+    """
+
+    params = ([2**16, 2**20], [0.1, 1.0])
+    param_names = ['event_buffer_size', 'interval_s']
+    timeout = 600
+    n_event_messages = 2000
+    events_per_message = 1000
+
+    def setup(self, event_buffer_size, interval_s):
+        self.stats = _run_data_stream(
+            event_buffer_size,
+            interval_s,
+            self.n_event_messages,
+            self.events_per_message,
+        )
+
+    def track_events_per_second(self, event_buffer_size, interval_s):
+        return self.stats.n_events / self.stats.elapsed_s
+
+    track_events_per_second.unit = "events/s"
+
+    def track_max_queue_depth(self, event_buffer_size, interval_s):
+        return np.max(self.stats.queue_depths)
+
+    track_max_queue_depth.unit = "chunks"
+
+
+class DataStreamLatency:
+    """
+    Time from a message being put in the FakeConsumer's queue to its events
+    being yielded by data_stream, when messages are fed at a steady rate
+    """
+
+    params = ([2**16, 2**20], [0.1, 1.0])
+    param_names = ['event_buffer_size', 'interval_s']
+    timeout = 600
+    n_event_messages = 500
+    events_per_message = 1000
+    messages_per_second = 200.0
+
+    def setup(self, event_buffer_size, interval_s):
+        self.stats = _run_data_stream(
+            event_buffer_size,
+            interval_s,
+            self.n_event_messages,
+            self.events_per_message,
+            self.messages_per_second,
+        )
+
+    def track_median_latency(self, event_buffer_size, interval_s):
+        return np.median(self.stats.latencies_s)
+
+    track_median_latency.unit = "s"
+
+    def track_max_latency(self, event_buffer_size, interval_s):
+        return np.max(self.stats.latencies_s)
+
+    track_max_latency.unit = "s"
+
+    def track_max_queue_depth(self, event_buffer_size, interval_s):
+        return np.max(self.stats.queue_depths)
+
+    track_max_queue_depth.unit = "chunks"
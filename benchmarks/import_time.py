@@ -0,0 +1,14 @@
+class Import:
+    """
+    Import of scippneutron in a fresh interpreter, as in short-lived workers
+    """
+
+    def timeraw_import_scippneutron(self):
+        return "import scippneutron"
+
+    def timeraw_import_scippneutron_and_load_nexus(self):
+        return "import scippneutron; scippneutron.load_nexus"
+
+    def timeraw_import_scipp(self):
+        # Baseline, scippneutron cannot be imported faster than this
+        return "import scipp"
@@ -0,0 +1,92 @@
+import io
+import tempfile
+from pathlib import Path
+
+import numpy as np
+import scipp as sc
+
+from scippneutron.io import cif, xye
+
+
+def _reduced_powder_data(n_points: int) -> sc.DataArray:
+    rng = np.random.default_rng(0)
+    values = rng.uniform(0.0, 100.0, n_points)
+    return sc.DataArray(
+        sc.array(dims=['tof'], values=values, variances=values, unit='counts'),
+        coords={'tof': sc.linspace('tof', 1000.0, 20_000.0, n_points, unit='us')},
+    )
+
+
+class SaveXYE:
+    """
+    Writing and reading a 1d spectrum as an XYE file
+    """
+
+    params = [[10**3, 10**5, 10**7]]
+    param_names = ['n_points']
+    timeout = 300
+
+    def setup(self, n_points):
+        self.da = _reduced_powder_data(n_points)
+        self.tmpdir = tempfile.TemporaryDirectory()
+        self.path = Path(self.tmpdir.name) / 'data.xye'
+        xye.save_xye(self.path, self.da)
+
+    def teardown(self, n_points):
+        self.tmpdir.cleanup()
+
+    def time_save_xye(self, n_points):
+        xye.save_xye(io.StringIO(), self.da)
+
+    def time_load_xye(self, n_points):
+        xye.load_xye(self.path, dim='tof', unit='counts', coord_unit='us')
+
+    def peakmem_save_xye(self, n_points):
+        xye.save_xye(io.StringIO(), self.da)
+
+    def peakmem_load_xye(self, n_points):
+        xye.load_xye(self.path, dim='tof', unit='counts', coord_unit='us')
+
+
+class SaveCIF:
+    """
+    Writing reduced powder data to a CIF file
+    """
+
+    params = [[10**3, 10**5, 10**6]]
+    param_names = ['n_points']
+    timeout = 300
+
+    def setup(self, n_points):
+        self.block = cif.Block('reduced', [])
+        self.block.add_reduced_powder_data(_reduced_powder_data(n_points))
+
+    def time_save_cif(self, n_points):
+        cif.save_cif(io.StringIO(), self.block)
+
+    def peakmem_save_cif(self, n_points):
+        cif.save_cif(io.StringIO(), self.block)
+
+
+class SavePowderCalibration:
+    """
+    Writing a per-pixel calibration table to a CIF file
+    """
+
+    params = [[10**3, 10**6]]
+    param_names = ['n_pixels']
+    timeout = 300
+
+    def setup(self, n_pixels):
+        difc = sc.linspace('cal', 1000.0, 20_000.0, n_pixels, unit='us/angstrom')
+        cal = sc.DataArray(
+            difc, coords={'power': sc.ones(sizes=difc.sizes, dtype='int64')}
+        )
+        self.block = cif.Block('calibration', [])
+        self.block.add_powder_calibration(cal)
+
+    def time_save_cif(self, n_pixels):
+        cif.save_cif(io.StringIO(), self.block)
+
+    def peakmem_save_cif(self, n_pixels):
+        cif.save_cif(io.StringIO(), self.block)
@@ -1,4 +1,12 @@
+import json
+from typing import Optional
+
+import numpy as np
+
 import scippneutron as scn
+from scippneutron.io.nexus.load_nexus import json_nexus_group
+
+from . import _fakes
 
 
 class LoadNexus:
@@ -7,3 +15,76 @@ class LoadNexus:
 
     def time_load_event_nexus(self):
         scn.load_nexus(self.file_path)
+
+
+def _string_attribute(name: str, value: str) -> dict:
+    return {'string_size': len(value), 'type': 'string', 'name': name, 'values': value}
+
+
+def _dataset(name: str, values: np.ndarray, unit: Optional[str] = None) -> dict:
+    attributes = [] if unit is None else [_string_attribute('units', unit)]
+    return {
+        'module': 'dataset',
+        'config': {
+            'name': name,
+            'values': values.tolist(),
+            'size': list(values.shape),
+            'type': str(values.dtype),
+        },
+        'attributes': attributes,
+    }
+
+
+def _event_data_json(n_events: int) -> str:
+    """JSON NeXus entry with an NXevent_data group of fake detector events"""
+    events = _fakes.wrapped_events('detector', n_events, n_pixels=1000)
+    constituents = events.bins.constituents
+    content = constituents['data']
+    event_data = {
+        'type': 'group',
+        'name': 'events_0',
+        'children': [
+            _dataset('event_id', content.coords['event_id'].values),
+            _dataset(
+                'event_time_offset',
+                content.coords['event_time_offset']
+                .to(unit='ns', dtype='int64')
+                .values,
+                unit='ns',
+            ),
+            _dataset(
+                'event_time_zero',
+                events.coords['event_time_zero'].values.astype('int64'),
+                unit='ns',
+            ),
+            _dataset('event_index', constituents['begin'].values),
+        ],
+        'attributes': [_string_attribute('NX_class', 'NXevent_data')],
+    }
+    entry = {
+        'type': 'group',
+        'name': 'entry',
+        'children': [event_data],
+        'attributes': [_string_attribute('NX_class', 'NXentry')],
+    }
+    return json.dumps({'children': [entry]})
+
+
+class LoadNexusJSON:
+    """
+    Parsing and loading event data from a JSON NeXus structure,
+    as received from the file writer via the streaming system
+    """
+
+    params = [[10**4, 10**6]]
+    param_names = ['n_events']
+    timeout = 300
+
+    def setup(self, n_events):
+        self.json_string = _event_data_json(n_events)
+
+    def time_load_event_data(self, n_events):
+        json_nexus_group(json.loads(self.json_string))['entry/events_0'][()]
+
+    def peakmem_load_event_data(self, n_events):
+        json_nexus_group(json.loads(self.json_string))['entry/events_0'][()]
@@ -0,0 +1,130 @@
+import scipp as sc
+
+from scippneutron.tof import UnwrapPlan, chopper_cascade, fakes, unwrap
+
+from . import _fakes
+from ._fakes import EVENT_COUNTS, skip_if_too_large
+
+
+class ChopperCascade:
+    """
+    Propagation of the source pulse through the WFM choppers of tof.fakes
+    """
+
+    params = [[1, 100, 10_000]]
+    param_names = ['n_distances']
+
+    def setup(self, n_distances):
+        self.pulse = _fakes.pulse()
+        self.choppers = list(fakes.wfm_choppers.values())
+        self.frames = self.pulse.chop(self.choppers)
+        self.distances = sc.linspace('detector', 20.0, 40.0, n_distances, unit='m')
+
+    def time_chop(self, n_distances):
+        self.pulse.chop(self.choppers)
+
+    def time_bounds_at_each_distance(self, n_distances):
+        for i in range(n_distances):
+            frame = self.frames[self.distances['detector', i]]
+            frame.bounds()
+            frame.subbounds()
+
+    def time_bounds_at_all_distances(self, n_distances):
+        self.frames.at(self.distances)
+
+    def peakmem_bounds_at_all_distances(self, n_distances):
+        self.frames.at(self.distances)
+
+
+class ChopperPhaseScan:
+    """
+    Chopping with many delays of one chopper at once
+    """
+
+    params = [[10, 1000]]
+    param_names = ['n_delays']
+
+    def setup(self, n_delays):
+        self.frame = _fakes.pulse().chop([])[0]
+        delays = sc.linspace('phase', -0.002, 0.002, n_delays, unit='s')
+        self.delays = {'wfm1': delays}
+
+    def time_chop_scan(self, n_delays):
+        chopper_cascade.chop_scan(self.frame, fakes.wfm_choppers, self.delays)
+
+
+class Unwrap:
+    """
+    Frame unwrapping and time-of-flight of monitor events from tof.fakes
+    """
+
+    params = [EVENT_COUNTS]
+    param_names = ['n_events']
+    timeout = 600
+
+    def setup(self, n_events):
+        skip_if_too_large(n_events)
+        self.events = _fakes.wrapped_events('monitor', n_events)
+        frames = _fakes.pulse().chop(fakes.psc_choppers.values())
+        self.frame_bounds = unwrap.frame_bounds(frames[_fakes.MONITOR_DISTANCE])
+        self.frame_period = _fakes.source().pulse_period
+        source_chopper = fakes.psc_choppers['psc1']
+        self.origin = unwrap.time_of_flight_origin_from_chopper(source_chopper)
+        self.plan = UnwrapPlan.from_frame_sequence(
+            frames, _fakes.MONITOR_DISTANCE, self.frame_period, source_chopper
+        )
+
+    def _unwrap_then_to_time_of_flight(self):
+        delta = unwrap.offset_from_wrapped(
+            unwrap.pulse_wrapped_time_offset(self.events),
+            self.frame_bounds,
+            self.frame_period,
+        )
+        unwrapped = unwrap.unwrap_data(self.events, delta)
+        unwrap.to_time_of_flight(unwrapped, self.origin, _fakes.MONITOR_DISTANCE)
+
+    def _fused(self):
+        unwrap.unwrap_to_time_of_flight(
+            self.events,
+            self.frame_bounds,
+            self.frame_period,
+            self.origin,
+            _fakes.MONITOR_DISTANCE,
+        )
+
+    def time_unwrap_then_to_time_of_flight(self, n_events):
+        self._unwrap_then_to_time_of_flight()
+
+    def time_unwrap_to_time_of_flight(self, n_events):
+        self._fused()
+
+    def time_unwrap_plan(self, n_events):
+        self.plan.apply(self.events)
+
+    def peakmem_unwrap_then_to_time_of_flight(self, n_events):
+        self._unwrap_then_to_time_of_flight()
+
+    def peakmem_unwrap_to_time_of_flight(self, n_events):
+        self._fused()
+
+    def peakmem_unwrap_plan(self, n_events):
+        self.plan.apply(self.events)
+
+
+class BulkEventGenerator:
+    """
+    Generation of fake events, the input of all event benchmarks
+    """
+
+    params = [EVENT_COUNTS]
+    param_names = ['n_events']
+    timeout = 600
+
+    def setup(self, n_events):
+        skip_if_too_large(n_events)
+
+    def time_generate(self, n_events):
+        _fakes.wrapped_events('detector', n_events, n_pixels=1000)
+
+    def peakmem_generate(self, n_events):
+        _fakes.wrapped_events('detector', n_events, n_pixels=1000)
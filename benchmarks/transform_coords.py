@@ -1,28 +1,63 @@
-from mantid.kernel import ConfigService
-
 import scippneutron as scn
 
-ConfigService.setLogLevel(1)
+from ._fakes import EVENT_COUNTS, skip_if_too_large, tof_events
 
 
 class TransformCoords:
-    def setup(self):
-        da = scn.load_with_mantid(scn.data.get_path('PG3_4844_event.nxs'))
-        self.var_tof = da
+    """
+    scn.convert of detector events from tof.fakes
+    """
+
+    params = (EVENT_COUNTS, [1000, 100_000], ['float32', 'float64'])
+    param_names = ['n_events', 'n_pixels', 'dtype']
+    timeout = 600
+
+    def setup(self, n_events, n_pixels, dtype):
+        skip_if_too_large(n_events)
+        self.var_tof = tof_events(n_events, n_pixels, dtype)
         self.var_wavelength = scn.convert(self.var_tof, "tof", "wavelength", False)
         self.var_energy = scn.convert(self.var_tof, "tof", "energy", False)
 
-    def time_wavelength_to_tof(self):
+    def time_wavelength_to_tof(self, n_events, n_pixels, dtype):
         scn.convert(self.var_tof, "tof", "wavelength", False)
 
-    def time_tof_to_wavelength(self):
+    def time_tof_to_wavelength(self, n_events, n_pixels, dtype):
         scn.convert(self.var_wavelength, "wavelength", "tof", False)
 
-    def time_tof_to_dspacing(self):
+    def time_tof_to_dspacing(self, n_events, n_pixels, dtype):
         scn.convert(self.var_tof, "tof", "dspacing", True)
 
-    def time_tof_to_energy(self):
+    def time_tof_to_energy(self, n_events, n_pixels, dtype):
         scn.convert(self.var_tof, "tof", "energy", False)
 
-    def time_energy_to_tof(self):
+    def time_energy_to_tof(self, n_events, n_pixels, dtype):
         scn.convert(self.var_energy, "energy", "tof", False)
+
+    def time_tof_to_Q_without_intermediates(self, n_events, n_pixels, dtype):
+        scn.convert(self.var_tof, "tof", "Q", True, keep_intermediate=False)
+
+    def time_tof_to_dspacing_chunked(self, n_events, n_pixels, dtype):
+        scn.convert_chunked(self.var_tof, "tof", "dspacing", True)
+
+    def peakmem_tof_to_dspacing(self, n_events, n_pixels, dtype):
+        scn.convert(self.var_tof, "tof", "dspacing", True)
+
+    def peakmem_tof_to_dspacing_chunked(self, n_events, n_pixels, dtype):
+        scn.convert_chunked(self.var_tof, "tof", "dspacing", True)
+
+
+class GeometryCacheHits:
+    """
+    Repeated conversions of chunks sharing the same geometry, as in streaming
+    """
+
+    params = [[1000, 100_000]]
+    param_names = ['n_pixels']
+
+    def setup(self, n_pixels):
+        self.var_tof = tof_events(10**5, n_pixels)
+        self.cache = scn.GeometryCache()
+        scn.convert(self.var_tof, "tof", "dspacing", True, geometry_cache=self.cache)
+
+    def time_tof_to_dspacing_cached(self, n_pixels):
+        scn.convert(self.var_tof, "tof", "dspacing", True, geometry_cache=self.cache)
@@ -29,19 +29,52 @@ from .beamline_components import (
     L2,
     two_theta,
 )
-from .core import convert
-from .mantid import (
-    from_mantid,
-    array_from_mantid,
-    to_mantid,
-    load_with_mantid,
-    load,
-    fit,
+from .core import (
+    GeometryCache,
+    compact_events,
+    conversion_graph,
+    convert,
+    convert_chunked,
+    deduce_conversion_graph,
+    map_chunked,
 )
-from .instrument_view import instrument_view
-from .io.nexus.load_nexus import load_nexus, load_nexus_json
-from .data_streaming.data_stream import data_stream
-from . import atoms
-from . import data
+from .instrument_view import PixelAggregation, instrument_view
+from .log_store import LogStore
 
 del importlib
+
+# Subsystems with heavy dependencies, e.g., h5py and scippnexus for loading
+# NeXus files or Kafka for streaming, are imported on first use of one of
+# their attributes, so that `import scippneutron` stays fast.
+_lazy_attributes = {
+    'from_mantid': 'mantid',
+    'array_from_mantid': 'mantid',
+    'to_mantid': 'mantid',
+    'load_with_mantid': 'mantid',
+    'load': 'mantid',
+    'fit': 'mantid',
+    'load_nexus': 'io.nexus.load_nexus',
+    'load_nexus_json': 'io.nexus.load_nexus',
+    'RunCache': 'io.cache',
+    'data_stream': 'data_streaming.data_stream',
+    'StreamAccumulator': 'data_streaming.accumulator',
+}
+_lazy_submodules = ('atoms', 'data', 'data_streaming', 'io', 'mantid', 'tof')
+
+
+def __getattr__(name: str):
+    from importlib import import_module
+
+    if name in _lazy_attributes:
+        module = import_module(f'.{_lazy_attributes[name]}', __name__)
+        value = getattr(module, name)
+    elif name in _lazy_submodules:
+        value = import_module(f'.{name}', __name__)
+    else:
+        raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
+    globals()[name] = value
+    return value
+
+
+def __dir__():
+    return sorted({*globals(), *_lazy_attributes, *_lazy_submodules})
@@ -5,8 +5,10 @@
 Internal utilities; do not use outside scippneutron!
 """
 
-from typing import MutableMapping
+import hashlib
+from typing import Any, MutableMapping, Optional, Tuple
 
+import numpy as np
 import scipp as sc
 from scipp.typing import VariableLike
 
@@ -30,6 +32,83 @@ def as_float_type(var: VariableLike, ref: VariableLike) -> VariableLike:
     return var.astype(float_dtype(ref), copy=False)
 
 
+def as_ns(time: sc.Variable) -> np.ndarray:
+    """Time stamps or durations as int64 nanoseconds"""
+    if time.dtype == sc.DType.datetime64:
+        return time.to(unit='ns', copy=False).values.astype(np.int64)
+    return time.to(unit='ns', dtype='int64', copy=False).values
+
+
+def is_unit_weights(data: sc.Variable) -> bool:
+    if not np.all(data.values == 1):
+        return False
+    return data.variances is None or bool(np.all(data.variances == 1))
+
+
+def per_event(
+    per_bin: np.ndarray, begin: np.ndarray, end: np.ndarray, n_events: int
+) -> np.ndarray:
+    """
+    Broadcast a value of each bin to the events of the bin in a buffer of
+    n_events, events which are in no bin get 0.
+    """
+    sizes = end - begin
+    if (
+        begin.size
+        and begin[0] == 0
+        and end[-1] == n_events
+        and np.array_equal(begin[1:], end[:-1])
+    ):
+        # The bins cover the buffer in order
+        return np.repeat(per_bin, sizes)
+    out = np.zeros(n_events, dtype=per_bin.dtype)
+    offsets = np.cumsum(sizes) - sizes
+    positions = np.arange(sizes.sum()) + np.repeat(begin - offsets, sizes)
+    out[positions] = np.repeat(per_bin, sizes)
+    return out
+
+
+def counting_sort(key: np.ndarray, n_keys: int) -> Tuple[np.ndarray, np.ndarray]:
+    """
+    Indices which stably sort key, and the number of elements of each key.
+
+    key must be in [0, n_keys). Sorts in O(n) by 16-bit digits,
+    numpy sorts 16-bit integers with a radix sort.
+    """
+    counts = np.bincount(key, minlength=n_keys)
+    order = np.arange(len(key))
+    for shift in range(0, max(int(n_keys - 1).bit_length(), 1), 16):
+        digit = (key[order] >> shift).astype(np.uint16)
+        order = order[np.argsort(digit, kind='stable')]
+    return order, counts
+
+
+def digest(array: np.ndarray) -> str:
+    array = np.ascontiguousarray(array)
+    return hashlib.blake2b(array.view(np.uint8), digest_size=16).hexdigest()
+
+
+def fingerprint(var: Any) -> Optional[Tuple]:
+    """
+    Key identifying the content of a variable,
+    None if it cannot be used as a cache key, e.g., time-dependent transforms
+    """
+    if not isinstance(var, sc.Variable) or var.bins is not None:
+        return None
+    values = var.values
+    if not isinstance(values, np.ndarray) or values.dtype.kind not in 'biufcmM':
+        return None
+    variances = None if var.variances is None else digest(var.variances)
+    return (
+        var.dims,
+        var.shape,
+        str(var.unit),
+        str(var.dtype),
+        digest(values),
+        variances,
+    )
+
+
 def get_attrs(da: sc.DataArray) -> MutableMapping[str, sc.Variable]:
     try:
         # During deprecation phase
@@ -23,9 +23,12 @@ This is useful for instance for monitors.
 In this case, ``Ltotal`` is the distance from source to detector.
 """
 
+import numpy as np
 import scipp as sc
 from scipp.typing import VariableLike
 
+from .._utils import as_ns, per_event
+
 
 def L1(*, incident_beam: VariableLike) -> VariableLike:
     """Compute the length of the incident beam.
@@ -233,3 +236,117 @@ def two_theta(
     b1 = incident_beam / L1(incident_beam=incident_beam)
     b2 = scattered_beam / L2(scattered_beam=scattered_beam)
     return 2 * sc.atan2(y=sc.norm(b1 - b2), x=sc.norm(b1 + b2))
+
+
+def _interval_index(table: sc.DataArray, time: sc.Variable) -> np.ndarray:
+    # Each entry of the table holds from its time until the next entry,
+    # times before the first entry use the first.
+    times = as_ns(table.coords['time'])
+    return np.maximum(np.searchsorted(times, as_ns(time), side='right') - 1, 0)
+
+
+def _at_pulse_time(
+    positions: sc.Variable, table: sc.DataArray, pulse_time: VariableLike
+) -> VariableLike:
+    # positions has the dim of the table and the dims of the component.
+    # Only the interval and component of each event are looked up, the
+    # transformations are not evaluated per event.
+    dim = table.dim
+    component = positions[dim, 0]
+    values = positions.transpose([dim, *component.dims]).values.reshape(
+        positions.sizes[dim], -1, 3
+    )
+    component_index = sc.array(
+        dims=component.dims,
+        values=np.arange(component.size).reshape(component.shape),
+        unit=None,
+    )
+    if pulse_time.bins is None:
+        sizes = {**component.sizes, **pulse_time.sizes}
+        index = component_index.broadcast(sizes=sizes).values
+        interval = _interval_index(table, pulse_time.broadcast(sizes=sizes))
+        return sc.vectors(
+            dims=list(sizes), values=values[interval, index], unit=positions.unit
+        )
+    constituents = pulse_time.bins.constituents
+    begin = constituents['begin']
+    events = constituents['data']
+    index = per_event(
+        component_index.broadcast(sizes=begin.sizes).values.ravel(),
+        begin.values.ravel(),
+        constituents['end'].values.ravel(),
+        events.size,
+    )
+    return sc.bins(
+        begin=begin,
+        end=constituents['end'],
+        dim=constituents['dim'],
+        data=sc.vectors(
+            dims=events.dims,
+            values=values[_interval_index(table, events), index],
+            unit=positions.unit,
+        ),
+    )
+
+
+def position_from_transformation_table(
+    *,
+    base_position: sc.Variable,
+    position_transformations: sc.Variable,
+    pulse_time: VariableLike,
+) -> VariableLike:
+    """Compute the position of a moving detector at the time of each pulse.
+
+    The positions of all pixels are computed once per entry of the table of
+    transformations and are then looked up for each pulse time.
+    Each transformation holds until the time of the next one;
+    pulses before the first entry use the first transformation.
+
+    Parameters
+    ----------
+    base_position:
+        Positions of the pixels before applying the transformations,
+        ``dtype=vector3``.
+    position_transformations:
+        Scalar holding a 1-D data array of transformations with a 'time' coord,
+        sorted by time, as loaded from a time-dependent ``depends_on`` chain
+        by :func:`scippneutron.load_nexus`.
+    pulse_time:
+        Time of the pulse of each event, dense or binned.
+
+    Returns
+    -------
+    :
+        ``position`` with the dims of ``base_position`` and ``pulse_time``,
+        binned if ``pulse_time`` is.
+    """
+    table = position_transformations.value
+    return _at_pulse_time(table.data * base_position, table, pulse_time)
+
+
+def sample_position_from_transformation_table(
+    *, sample_position_transformations: sc.Variable, pulse_time: VariableLike
+) -> VariableLike:
+    """Compute the position of a moving sample at the time of each pulse.
+
+    See :func:`position_from_transformation_table` for how the table is evaluated.
+
+    Parameters
+    ----------
+    sample_position_transformations:
+        Scalar holding a 1-D data array of transformations of the origin with
+        a 'time' coord, sorted by time.
+    pulse_time:
+        Time of the pulse of each event, dense or binned.
+
+    Returns
+    -------
+    :
+        ``sample_position`` with the dims of ``pulse_time``.
+    """
+    table = sample_position_transformations.value
+    transformations = table.data
+    if transformations.dtype != sc.DType.rotation3:
+        transformations = transformations.to(unit='m')
+    positions = transformations * sc.vector([0.0, 0.0, 0.0], unit='m')
+    return _at_pulse_time(positions, table, pulse_time)
@@ -107,7 +107,13 @@ _SCATTER_GRAPH_BEAMLINE = {
 }
 
 
-def beamline(scatter: bool) -> Graph:
+_TIME_DEPENDENT_GRAPH_BEAMLINE = {
+    'position': _kernels.position_from_transformation_table,
+    'sample_position': _kernels.sample_position_from_transformation_table,
+}
+
+
+def beamline(scatter: bool, *, time_dependent: bool = False) -> Graph:
     """Graph defining a straight beamline geometry.
 
     This can be used as part of transformation graphs that require, e.g., scattering
@@ -118,6 +124,13 @@ def beamline(scatter: bool) -> Graph:
     scatter:
         If True, a graph for scattering from ``sample_position`` is
         returned, else a graph without scattering.
+    time_dependent:
+        If True, the graph also computes ``position`` and ``sample_position``
+        of moving components at the ``pulse_time`` of each event from
+        ``position_transformations`` and ``sample_position_transformations``.
+        This is only used for components which have no position coord,
+        e.g., if the ``depends_on`` chain loaded by
+        :func:`scippneutron.load_nexus` is time-dependent.
 
     Returns
     -------
@@ -125,6 +138,13 @@ def beamline(scatter: bool) -> Graph:
         A dict defining a coordinate transformation graph.
     """
     if scatter:
-        return dict(_SCATTER_GRAPH_BEAMLINE)
+        graph = dict(_SCATTER_GRAPH_BEAMLINE)
     else:
-        return dict(_NO_SCATTER_GRAPH_BEAMLINE)
+        graph = dict(_NO_SCATTER_GRAPH_BEAMLINE)
+    if time_dependent:
+        graph['position'] = _TIME_DEPENDENT_GRAPH_BEAMLINE['position']
+        if scatter:
+            graph['sample_position'] = _TIME_DEPENDENT_GRAPH_BEAMLINE[
+                'sample_position'
+            ]
+    return graph
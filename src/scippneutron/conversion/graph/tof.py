@@ -55,6 +55,15 @@ _GRAPH_DYNAMICS_BY_ORIGIN = {
     },
 }
 
+# Replacements for nodes of _GRAPH_DYNAMICS_BY_ORIGIN which compute the target
+# directly from the origin rather than via an intermediate of the same size
+_GRAPH_FUSED_BY_ORIGIN = {
+    'tof': {
+        'Q': _kernels.Q_from_tof,
+        ('Qx', 'Qy', 'Qz'): _kernels.Q_elements_from_tof,
+    },
+}
+
 
 def _strip_elastic(start: str, keep: list) -> Graph:
     full_graph = elastic(start)
@@ -78,6 +87,28 @@ def elastic(start: str) -> Graph:
     return dict(_GRAPH_DYNAMICS_BY_ORIGIN[start])
 
 
+def elastic_fused(start: str) -> Graph:
+    """Graph for elastic scattering transformations without large intermediates.
+
+    Like :func:`elastic`, but targets which would otherwise be computed via
+    an intermediate coordinate of the same size as ``start``,
+    e.g., ``Q`` via ``wavelength``, are computed from ``start`` directly.
+    This saves memory and time for event data,
+    but the intermediate is then not available in the output.
+
+    Parameters
+    ----------
+    start:
+        Input coordinate. One of 'energy', 'tof', 'Q', or 'wavelength'.
+
+    Returns
+    -------
+    :
+        A dict defining a coordinate transformation graph.
+    """
+    return {**elastic(start), **_GRAPH_FUSED_BY_ORIGIN.get(start, {})}
+
+
 def kinematic(start: str) -> Graph:
     """Graph with pure kinematics.
 
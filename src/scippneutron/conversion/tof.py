@@ -349,6 +349,51 @@ def Q_from_wavelength(*, wavelength: Variable, two_theta: Variable) -> Variable:
     return _wavelength_Q_conversions(wavelength, two_theta)
 
 
+def Q_from_tof(*, tof: Variable, Ltotal: Variable, two_theta: Variable) -> Variable:
+    r"""Compute the absolute value of the momentum transfer from time-of-flight.
+
+    The result is
+
+    .. math::
+
+        Q = \frac{4 \pi m_n L_\mathsf{total} \sin \theta}{h t}
+
+    Where :math:`m_n` is the neutron mass and :math:`h` the Planck constant.
+
+    This is equivalent to computing the wavelength with
+    :func:`wavelength_from_tof` and then :func:`Q_from_wavelength`.
+    But the factor in front of :math:`1/t` only depends on the beamline
+    and is computed first, so there is only a single operation on ``tof``,
+    which avoids allocating a wavelength of the same size as ``tof``.
+
+    Parameters
+    ----------
+    tof:
+        Time-of-flight :math:`t`.
+    Ltotal:
+        Total beam length.
+    two_theta:
+        Scattering angle :math:`2 \theta`.
+
+    Returns
+    -------
+    :
+        Momentum transfer :math:`Q`.
+        Has unit 1/ångström.
+
+    See Also
+    --------
+    scippneutron.conversions.beamline:
+        Definitions of ``two_theta`` and ``Ltotal``.
+    """
+    c = sc.to_unit(
+        4 * const.pi * const.m_n / const.h,
+        elem_unit(tof) / sc.units.angstrom / elem_unit(Ltotal),
+        copy=False,
+    )
+    return as_float_type(c * Ltotal * sc.sin(two_theta / 2), tof) / tof
+
+
 def wavelength_from_Q(*, Q: Variable, two_theta: Variable) -> Variable:
     r"""Compute the wavelength from momentum transfer.
 
@@ -384,7 +429,7 @@ def wavelength_from_Q(*, Q: Variable, two_theta: Variable) -> Variable:
 def Q_elements_from_wavelength(
     *, wavelength: Variable, incident_beam: Variable, scattered_beam: Variable
 ) -> Tuple[Variable, Variable, Variable]:
-    r"""Compute them momentum transfer vector from wavelength.
+    r"""Compute the momentum transfer vector from wavelength.
 
     Computes the three components of the Q-vector :math:`Q_x, Q_y, Q_z`
     separately using
@@ -425,11 +470,65 @@ def Q_elements_from_wavelength(
     """
     e_i = incident_beam / sc.norm(incident_beam)
     e_f = scattered_beam / sc.norm(scattered_beam)
-    e = e_i - e_f
+    # Keep the precision of wavelength, e.g., float32 for compact events
+    e = as_float_type(e_i - e_f, wavelength)
     k = 2 * np.pi / wavelength
     return k * e.fields.x, k * e.fields.y, k * e.fields.z
 
 
+def Q_elements_from_tof(
+    *,
+    tof: Variable,
+    Ltotal: Variable,
+    incident_beam: Variable,
+    scattered_beam: Variable,
+) -> Tuple[Variable, Variable, Variable]:
+    r"""Compute the momentum transfer vector from time-of-flight.
+
+    Computes the three components of the Q-vector :math:`Q_x, Q_y, Q_z`
+    separately using
+
+    .. math::
+
+        \vec{Q} = \frac{2 \pi m_n L_\mathsf{total}}{h t}
+                  \left(\hat{e}_i - \hat{e}_f\right),
+
+    with the unit vectors as in :func:`Q_elements_from_wavelength`.
+    The vector in front of :math:`1/t` is computed first, so there is only
+    one operation on ``tof`` per component and no wavelength of the same
+    size as ``tof`` is allocated.
+
+    Parameters
+    ----------
+    tof:
+        Time-of-flight :math:`t`.
+    Ltotal:
+        Total beam length.
+    incident_beam:
+        Beam from source to sample. Expects ``dtype=vector3``.
+    scattered_beam:
+        Beam from sample to detector. Expects ``dtype=vector3``.
+
+    Returns
+    -------
+    Qx: scipp.Variable
+        x-component of the momentum transfer :math:`\vec{Q}`.
+    Qy: scipp.Variable
+        y-component of the momentum transfer :math:`\vec{Q}`.
+    Qz: scipp.Variable
+        z-component of the momentum transfer :math:`\vec{Q}`.
+    """
+    e_i = incident_beam / sc.norm(incident_beam)
+    e_f = scattered_beam / sc.norm(scattered_beam)
+    c = sc.to_unit(
+        2 * const.pi * const.m_n / const.h,
+        elem_unit(tof) / sc.units.angstrom / elem_unit(Ltotal),
+        copy=False,
+    )
+    k_e = as_float_type(c * Ltotal * (e_i - e_f), tof)
+    return k_e.fields.x / tof, k_e.fields.y / tof, k_e.fields.z / tof
+
+
 def dspacing_from_wavelength(*, wavelength: Variable, two_theta: Variable) -> Variable:
     r"""Compute the d-spacing from wavelength.
 
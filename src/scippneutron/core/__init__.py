@@ -6,4 +6,7 @@
 
 import os
 
+from .chunked import convert_chunked, map_chunked
+from .compact import compact_events
 from .conversions import conversion_graph, convert, deduce_conversion_graph
+from .geometry_cache import GeometryCache
@@ -0,0 +1,295 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
+"""
+Block-wise execution of operations on data with many pixels.
+
+The input is split along its pixel dimension into blocks holding a bounded
+number of events, blocks are processed by a pool of worker threads, and the
+results are written into an output which is allocated once.
+Temporaries of the processing function thus only ever exist for the blocks
+which are in flight, rather than for all events at once.
+"""
+
+import concurrent.futures
+import itertools
+import os
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+import numpy as np
+import scipp as sc
+
+from .conversions import convert
+from .geometry_cache import GeometryCache
+
+_PIXEL_DIMS = ('spectrum', 'detector_id')
+
+
+def _split_dim(data: sc.DataArray, dim: Optional[str]) -> str:
+    if dim is not None:
+        return dim
+    for candidate in _PIXEL_DIMS:
+        if candidate in data.dims:
+            return candidate
+    return data.dims[0]
+
+
+def _block_ranges(
+    items_per_pixel: np.ndarray, items_per_block: int
+) -> List[Tuple[int, int]]:
+    """
+    Consecutive ranges of pixels holding up to items_per_block items,
+    but at least one pixel each
+    """
+    total = np.cumsum(items_per_pixel)
+    edges = [0]
+    while edges[-1] < len(items_per_pixel):
+        start = total[edges[-1] - 1] if edges[-1] > 0 else 0
+        end = int(np.searchsorted(total, start + items_per_block, side='right'))
+        edges.append(max(end, edges[-1] + 1))
+    return list(zip(edges[:-1], edges[1:]))
+
+
+def _slice_argument(value: Any, dim: str, begin: int, end: int) -> Any:
+    if isinstance(value, (sc.Variable, sc.DataArray, sc.DataGroup)) and (
+        dim in value.dims
+    ):
+        return value[dim, begin:end]
+    return value
+
+
+def _empty_like(var: sc.Variable, dim: str, size: int) -> sc.Variable:
+    return sc.empty(
+        sizes={**var.sizes, dim: size},
+        dtype=var.dtype,
+        unit=var.unit,
+        with_variances=var.variances is not None,
+    )
+
+
+def _event_content(block: sc.DataArray) -> sc.DataArray:
+    """
+    Events of block, ordered by bin in the order of the dims of block,
+    without gaps between bins
+    """
+    constituents = block.bins.constituents
+    begin = constituents['begin'].values.ravel()
+    sizes = constituents['end'].values.ravel() - begin
+    content = constituents['data']
+    if np.array_equal(begin, np.cumsum(sizes) - sizes) and content.sizes[
+        constituents['dim']
+    ] == int(sizes.sum()):
+        return content
+    # Copying binned data drops unused parts of the buffer
+    return block.copy().bins.constituents['data']
+
+
+class _Output:
+    """Preallocated output, filled block by block"""
+
+    def __init__(
+        self,
+        template: sc.DataArray,
+        dim: str,
+        n_pixels: int,
+        bin_sizes: Optional[sc.Variable],
+    ):
+        self._dim = dim
+        self._bin_sizes = bin_sizes
+        self._coords = self._allocate(template.coords, dim, n_pixels)
+        self._aligned = {name: coord.aligned for name, coord in template.coords.items()}
+        self._masks = self._allocate(template.masks, dim, n_pixels)
+        if bin_sizes is None:
+            self._data = _empty_like(template.data, dim, n_pixels)
+            return
+        content = _event_content(template)
+        event_dim = template.bins.constituents['dim']
+        n_events = int(bin_sizes.sum().value)
+        self._event_dim = event_dim
+        self._event_data = _empty_like(content.data, event_dim, n_events)
+        self._event_coords = self._allocate(content.coords, event_dim, n_events)
+        self._event_masks = self._allocate(content.masks, event_dim, n_events)
+        events_per_pixel = bin_sizes.values.reshape(n_pixels, -1).sum(axis=1)
+        self._pixel_begin = np.concatenate([[0], np.cumsum(events_per_pixel)])
+
+    @staticmethod
+    def _allocate(variables, dim: str, size: int) -> Dict[str, sc.Variable]:
+        return {
+            name: _empty_like(var, dim, size) if dim in var.dims else var.copy()
+            for name, var in variables.items()
+        }
+
+    @staticmethod
+    def _write(
+        out: Dict[str, sc.Variable], variables, dim: str, begin: int, end: int
+    ) -> None:
+        for name, var in variables.items():
+            if dim in var.dims:
+                out[name][dim, begin:end] = var
+
+    def write(self, block: sc.DataArray, begin: int, end: int) -> None:
+        dim = self._dim
+        self._write(self._coords, block.coords, dim, begin, end)
+        self._write(self._masks, block.masks, dim, begin, end)
+        if self._bin_sizes is None:
+            self._data[dim, begin:end] = block.data
+            return
+        if not sc.identical(block.bins.size(), self._bin_sizes[dim, begin:end]):
+            raise ValueError(
+                'Operations applied block-wise must not change the number of events.'
+            )
+        content = _event_content(block)
+        event_dim = self._event_dim
+        event_begin = int(self._pixel_begin[begin])
+        event_end = int(self._pixel_begin[end])
+        self._event_data[event_dim, event_begin:event_end] = content.data
+        for out, variables in (
+            (self._event_coords, content.coords),
+            (self._event_masks, content.masks),
+        ):
+            self._write(out, variables, event_dim, event_begin, event_end)
+
+    def result(self) -> sc.DataArray:
+        if self._bin_sizes is None:
+            data = self._data
+        else:
+            events = sc.DataArray(
+                self._event_data, coords=self._event_coords, masks=self._event_masks
+            )
+            sizes = self._bin_sizes.values.ravel()
+            begin = sc.array(
+                dims=self._bin_sizes.dims,
+                values=(np.cumsum(sizes) - sizes).reshape(self._bin_sizes.shape),
+                unit=None,
+            )
+            data = sc.bins(begin=begin, dim=self._event_dim, data=events)
+        out = sc.DataArray(data, coords=self._coords, masks=self._masks)
+        for name, aligned in self._aligned.items():
+            out.coords.set_aligned(name, aligned)
+        return out
+
+
+def map_chunked(
+    func: Callable[..., sc.DataArray],
+    data: sc.DataArray,
+    *,
+    dim: Optional[str] = None,
+    items_per_block: int = 2**22,
+    max_workers: Optional[int] = None,
+    **kwargs: Any,
+) -> sc.DataArray:
+    """
+    Apply a function to blocks of pixels of data and combine the results.
+
+    The data is split along ``dim`` into blocks of consecutive pixels holding about
+    ``items_per_block`` events, or elements in the case of dense data.
+    Blocks are processed by a pool of threads and the results are written into an
+    output which is allocated when the first block is done.
+    At most ``max_workers`` blocks are processed at the same time,
+    so peak memory use of ``func`` is bounded by the block size.
+
+    ``func`` must return a data array with the same dims as its input,
+    and for binned data the same number of events in each bin,
+    as is the case for coordinate transformations such as
+    :py:func:`scippneutron.convert`.
+    The output has ``dim`` as its outermost dimension.
+
+    :param func: Function to apply to each block.
+    :param data: Input data.
+    :param dim: Dimension to split along. Defaults to ``spectrum`` or
+                ``detector_id`` if present, otherwise the first dimension of data.
+    :param items_per_block: Approximate number of events or elements per block.
+                            Blocks contain at least one pixel.
+    :param max_workers: Number of worker threads, defaults to the number of CPUs.
+    :param kwargs: Passed to ``func``. Variables, data arrays, and data groups
+                   which depend on ``dim``, such as pixel-dependent ``Ltotal``,
+                   are sliced to the pixels of each block.
+    :return: Combined result of all blocks.
+    """
+    dim = _split_dim(data, dim)
+    data = data.transpose([dim, *(d for d in data.dims if d != dim)])
+    n_pixels = data.sizes[dim]
+    if data.bins is None:
+        bin_sizes = None
+        items_per_pixel = np.full(n_pixels, data.size // max(n_pixels, 1))
+    else:
+        bin_sizes = data.bins.size()
+        items_per_pixel = bin_sizes.values.reshape(n_pixels, -1).sum(axis=1)
+    ranges = _block_ranges(items_per_pixel, items_per_block)
+    if len(ranges) <= 1:
+        return func(data, **kwargs)
+
+    def apply(begin: int, end: int) -> sc.DataArray:
+        return func(
+            data[dim, begin:end],
+            **{
+                key: _slice_argument(value, dim, begin, end)
+                for key, value in kwargs.items()
+            },
+        )
+
+    max_workers = max_workers or os.cpu_count() or 1
+    output = None
+    remaining = iter(ranges)
+    with concurrent.futures.ThreadPoolExecutor(max_workers=max_workers) as pool:
+        pending = {
+            pool.submit(apply, *block_range): block_range
+            for block_range in itertools.islice(remaining, max_workers)
+        }
+        while pending:
+            done, _ = concurrent.futures.wait(
+                pending, return_when=concurrent.futures.FIRST_COMPLETED
+            )
+            for future in done:
+                begin, end = pending.pop(future)
+                block = future.result()
+                if output is None:
+                    output = _Output(block, dim, n_pixels, bin_sizes)
+                output.write(block, begin, end)
+                for block_range in itertools.islice(remaining, 1):
+                    pending[pool.submit(apply, *block_range)] = block_range
+    return output.result()
+
+
+def convert_chunked(
+    data: sc.DataArray,
+    origin: str,
+    target: str,
+    scatter: bool,
+    keep_intermediate: bool = True,
+    geometry_cache: Optional[GeometryCache] = None,
+    *,
+    dim: Optional[str] = None,
+    items_per_block: int = 2**22,
+    max_workers: Optional[int] = None,
+) -> sc.DataArray:
+    """
+    Perform a unit conversion like :py:func:`scippneutron.convert`,
+    block by block over the pixels of the data.
+
+    See :py:func:`scippneutron.map_chunked` for how the data is split.
+    This bounds the memory used by temporaries of the conversion,
+    at the cost of some overhead per block. Datasets are not supported.
+
+    :param data: Input data.
+    :param origin: Name of the input coordinate.
+    :param target: Name of the output coordinate.
+    :param scatter: Choose whether to use scattering or non-scattering conversions.
+    :param keep_intermediate: See :py:func:`scippneutron.convert`.
+    :param geometry_cache: See :py:func:`scippneutron.convert`.
+    :param dim: Dimension to split along.
+    :param items_per_block: Approximate number of events or elements per block.
+    :param max_workers: Number of worker threads, defaults to the number of CPUs.
+    :return: A new scipp.DataArray with the new coordinate.
+    """
+    return map_chunked(
+        convert,
+        data,
+        dim=dim,
+        items_per_block=items_per_block,
+        max_workers=max_workers,
+        origin=origin,
+        target=target,
+        scatter=scatter,
+        keep_intermediate=keep_intermediate,
+        geometry_cache=geometry_cache,
+    )
@@ -0,0 +1,123 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
+"""
+Compact in-memory layout of event data.
+
+Unweighted events are commonly held with 16 bytes of weight and variance,
+float64 coords, and the 8 byte time of their pulse for every event,
+which is mostly redundant. In the compact layout
+
+- unit weights are stored as float32 ones without variances,
+- float64 coords are stored as float32 and int64 coords as int32 where the
+  values fit, except for absolute times, and
+- events of a flat table are binned by pulse, so that the int64 pulse time is
+  stored once per pulse while the events keep their int32 or float32 offset
+  from it, as in NXevent_data.
+"""
+
+from typing import Union
+
+import numpy as np
+import scipp as sc
+
+from .._utils import is_unit_weights
+
+# Absolute times need 64 bits, they are never narrowed
+_ABSOLUTE_TIME_COORDS = ('pulse_time', 'event_time_zero', 'time_zero')
+_PULSE_TIME_COORDS = ('pulse_time', 'event_time_zero')
+
+_INT32 = np.iinfo(np.int32)
+
+
+def _compact_weights(data: sc.Variable, float_dtype: str) -> sc.Variable:
+    if is_unit_weights(data):
+        return sc.ones(sizes=data.sizes, unit=data.unit, dtype=float_dtype)
+    if data.dtype == sc.DType.float64:
+        return data.to(dtype=float_dtype)
+    return data
+
+
+def _compact_coord(name: str, coord: sc.Variable, float_dtype: str) -> sc.Variable:
+    if coord.dtype == sc.DType.float64:
+        return coord.to(dtype=float_dtype)
+    if coord.dtype == sc.DType.int64 and name not in _ABSOLUTE_TIME_COORDS:
+        values = coord.values
+        if values.size == 0 or (
+            values.min() >= _INT32.min and values.max() <= _INT32.max
+        ):
+            return coord.to(dtype='int32')
+    return coord
+
+
+def _compact_table(events: sc.DataArray, float_dtype: str) -> sc.DataArray:
+    return sc.DataArray(
+        _compact_weights(events.data, float_dtype),
+        coords={
+            name: _compact_coord(name, coord, float_dtype)
+            for name, coord in events.coords.items()
+        },
+        masks=dict(events.masks),
+    )
+
+
+def _group_by_pulse(events: sc.DataArray, name: str) -> sc.DataArray:
+    pulse_time = events.coords[name]
+    values = pulse_time.values
+    if np.any(values[1:] < values[:-1]):
+        events = sc.sort(events, name)
+        values = events.coords[name].values
+    first_of_pulse = np.ones(values.size, dtype=bool)
+    first_of_pulse[1:] = values[1:] != values[:-1]
+    starts = np.flatnonzero(first_of_pulse)
+    content = events.copy(deep=False)
+    del content.coords[name]
+    return sc.DataArray(
+        sc.bins(
+            begin=sc.array(dims=['pulse'], values=starts, unit=None),
+            dim='event',
+            data=content,
+        ),
+        coords={
+            name: sc.array(
+                dims=['pulse'], values=values[starts], unit=pulse_time.unit
+            )
+        },
+    )
+
+
+def compact_events(
+    da: sc.DataArray, *, float_dtype: Union[str, sc.DType] = 'float32'
+) -> sc.DataArray:
+    """
+    Return the events of da in the compact layout, see the module docstring.
+
+    Histogramming events with implicit unit weights gives counts without
+    variances. For Poisson statistics the variances are equal to the counts,
+    so they can be restored with ``counts.variances = counts.values``.
+
+    The rounding error of float32 is a relative 6e-8, e.g., 4 ns for a time
+    offset of 70 ms. Pass ``float_dtype='float64'`` to keep float coords
+    unchanged.
+
+    :param da: A flat table of events with dim 'event' or binned events.
+      Flat tables with a 'pulse_time' or 'event_time_zero' coord per event
+      are binned by pulse, binned events keep their bins.
+    :param float_dtype: Dtype to store float64 coords and weights as.
+    :return: Events in the compact layout, the input is not modified.
+    """
+    if da.bins is None:
+        if da.dims != ('event',):
+            raise ValueError(
+                f"Expected a table of events with dim 'event', got dims {da.dims}."
+            )
+        events = _compact_table(da, float_dtype)
+        for name in _PULSE_TIME_COORDS:
+            if name in events.coords and events.coords[name].dims == ('event',):
+                return _group_by_pulse(events, name)
+        return events
+    constituents = da.bins.constituents
+    out = da.copy(deep=False)
+    out.data = sc.bins(
+        **{**constituents, 'data': _compact_table(constituents['data'], float_dtype)}
+    )
+    return out
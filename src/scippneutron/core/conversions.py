@@ -2,20 +2,21 @@
 # Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
 # @author Jan-Lukas Wynen
 
-from typing import Callable, Dict, Tuple, Union
+from typing import Callable, Dict, Optional, Tuple, Union
 
 import scipp as sc
 
 from ..conversion import graph as _graphs
+from .geometry_cache import GeometryCache
 
 
-def _inelastic_scatter_graph(energy_mode):
+def _inelastic_scatter_graph(energy_mode, time_dependent):
     inelastic_graph_factory = {
         'direct_inelastic': _graphs.tof.direct_inelastic,
         'indirect_inelastic': _graphs.tof.indirect_inelastic,
     }
     return {
-        **_graphs.beamline.beamline(scatter=True),
+        **_graphs.beamline.beamline(scatter=True, time_dependent=time_dependent),
         **inelastic_graph_factory[energy_mode](start='tof'),
     }
 
@@ -27,24 +28,33 @@ def _reachable_by(target, graph):
     )
 
 
-def _elastic_scatter_graph(origin, target):
-    scatter_graph_kinematics = _graphs.beamline.beamline(scatter=True)
+def _elastic_scatter_graph(origin, target, keep_intermediate, time_dependent):
+    scatter_graph_kinematics = _graphs.beamline.beamline(
+        scatter=True, time_dependent=time_dependent
+    )
     if _reachable_by(target, scatter_graph_kinematics):
         return dict(scatter_graph_kinematics)
-    return {**scatter_graph_kinematics, **_graphs.tof.elastic(origin)}
+    elastic = _graphs.tof.elastic if keep_intermediate else _graphs.tof.elastic_fused
+    return {**scatter_graph_kinematics, **elastic(origin)}
 
 
-def _scatter_graph(origin, target, energy_mode):
+def _scatter_graph(origin, target, energy_mode, keep_intermediate, time_dependent):
     graph = (
-        _elastic_scatter_graph(origin, target)
+        _elastic_scatter_graph(origin, target, keep_intermediate, time_dependent)
         if energy_mode == 'elastic'
-        else _inelastic_scatter_graph(energy_mode)
+        else _inelastic_scatter_graph(energy_mode, time_dependent)
     )
     return graph
 
 
 def conversion_graph(
-    origin: str, target: str, scatter: bool, energy_mode: str
+    origin: str,
+    target: str,
+    scatter: bool,
+    energy_mode: str,
+    keep_intermediate: bool = True,
+    geometry_cache: Optional[GeometryCache] = None,
+    time_dependent: bool = False,
 ) -> Dict[Union[str, Tuple[str]], Callable]:
     """
     Get a conversion graph for given parameters.
@@ -56,6 +66,17 @@ def conversion_graph(
     :param scatter: Choose whether to use scattering or non-scattering conversions.
     :param energy_mode: Select if energy is conserved. One of `'elastic'`,
                         `'direct_inelastic'`, `'indirect_inelastic'`.
+    :param keep_intermediate: If False, the graph computes targets directly from
+                              the origin where the default graph would compute
+                              an intermediate of the same size as the origin,
+                              e.g., ``Q`` from ``tof`` without ``wavelength``.
+    :param geometry_cache: If given, beamline quantities computed by the graph are
+                           cached in it and reused while the positions are the
+                           same.
+    :param time_dependent: If True, positions of moving components are computed
+                           at the pulse time of each event from tables of
+                           time-dependent transformations, see
+                           :py:func:`scippneutron.conversion.graph.beamline.beamline`.
     :return: Conversion graph.
     :seealso: :py:func:`scippneutron.convert`,
               :py:func:`scippneutron.deduce_conversion_graph`.
@@ -63,12 +84,26 @@ def conversion_graph(
 
     # Results are copied to ensure users do not modify the global dictionaries.
     if scatter:
-        return dict(_scatter_graph(origin, target, energy_mode))
+        graph = dict(
+            _scatter_graph(
+                origin, target, energy_mode, keep_intermediate, time_dependent
+            )
+        )
     else:
-        return {
-            **_graphs.beamline.beamline(scatter=False),
+        graph = {
+            **_graphs.beamline.beamline(scatter=False, time_dependent=time_dependent),
             **_graphs.tof.kinematic(start='tof'),
         }
+    if geometry_cache is not None:
+        return geometry_cache.wrap(graph)
+    return graph
+
+
+def _has_time_dependent_positions(data):
+    return any(
+        name not in data.coords and f'{name}_transformations' in data.coords
+        for name in ('position', 'sample_position')
+    )
 
 
 def _find_inelastic_inputs(data):
@@ -105,7 +140,12 @@ def _deduce_energy_mode(data, origin, target):
 
 
 def deduce_conversion_graph(
-    data: Union[sc.DataArray, sc.Dataset], origin: str, target: str, scatter: bool
+    data: Union[sc.DataArray, sc.Dataset],
+    origin: str,
+    target: str,
+    scatter: bool,
+    keep_intermediate: bool = True,
+    geometry_cache: Optional[GeometryCache] = None,
 ) -> Dict[Union[str, Tuple[str]], Callable]:
     """
     Get the conversion graph used by :py:func:`scippneutron.convert`
@@ -115,16 +155,29 @@ def deduce_conversion_graph(
     :param origin: Name of the input coordinate.
     :param target: Name of the output coordinate.
     :param scatter: Choose whether to use scattering or non-scattering conversions.
+    :param keep_intermediate: See :py:func:`scippneutron.conversion_graph`.
+    :param geometry_cache: See :py:func:`scippneutron.conversion_graph`.
     :return: Conversion graph.
     :seealso: :py:func:`scippneutron.convert`, :py:func:`scippneutron.conversion_graph`.
     """
     return conversion_graph(
-        origin, target, scatter, _deduce_energy_mode(data, origin, target)
+        origin,
+        target,
+        scatter,
+        _deduce_energy_mode(data, origin, target),
+        keep_intermediate=keep_intermediate,
+        geometry_cache=geometry_cache,
+        time_dependent=_has_time_dependent_positions(data),
     )
 
 
 def convert(
-    data: Union[sc.DataArray, sc.Dataset], origin: str, target: str, scatter: bool
+    data: Union[sc.DataArray, sc.Dataset],
+    origin: str,
+    target: str,
+    scatter: bool,
+    keep_intermediate: bool = True,
+    geometry_cache: Optional[GeometryCache] = None,
 ) -> Union[sc.DataArray, sc.Dataset]:
     """
     Perform a unit conversion from the given origin unit to target.
@@ -136,16 +189,33 @@ def convert(
     :param origin: Name of the input coordinate.
     :param target: Name of the output coordinate.
     :param scatter: Choose whether to use scattering or non-scattering conversions.
+    :param keep_intermediate: Keep intermediate coordinates in the output.
+                              If False, targets like ``Q`` are computed from
+                              ``tof`` in a single operation on the events,
+                              without allocating a ``wavelength`` for them.
+    :param geometry_cache: Reuse beamline quantities like ``L2`` and ``two_theta``
+                           from previous calls with the same cache if the
+                           positions are unchanged,
+                           see :py:class:`scippneutron.GeometryCache`.
     :return: A new scipp.DataArray or scipp.Dataset with the new coordinate.
     :seealso: :py:func:`scippneutron.deduce_conversion_graph` and
               :py:func:`scippneutron.conversion_graph` to inspect
               the possible conversions.
     """
 
-    graph = deduce_conversion_graph(data, origin, target, scatter)
+    graph = deduce_conversion_graph(
+        data,
+        origin,
+        target,
+        scatter,
+        keep_intermediate=keep_intermediate,
+        geometry_cache=geometry_cache,
+    )
 
     try:
-        converted = data.transform_coords(target, graph=graph)
+        converted = data.transform_coords(
+            target, graph=graph, keep_intermediate=keep_intermediate
+        )
     except KeyError as err:
         if err.args[0] == target:
             raise RuntimeError(
@@ -0,0 +1,113 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
+"""
+Reuse per-pixel beamline quantities between coordinate transformations.
+"""
+
+import functools
+import threading
+from collections import OrderedDict
+from typing import Any, Callable, Dict, Optional, Tuple, Union
+
+from .._utils import fingerprint
+from ..conversion import graph as _graphs
+
+Graph = Dict[Union[str, Tuple[str, ...]], Callable]
+
+
+def _beamline_nodes() -> set:
+    return set(_graphs.beamline.beamline(scatter=True)) | set(
+        _graphs.beamline.beamline(scatter=False)
+    )
+
+
+class GeometryCache:
+    """
+    Cache of beamline quantities such as ``L1``, ``L2``, ``Ltotal``,
+    and ``two_theta``, for converting many pieces of data which share
+    the same instrument geometry, e.g., the chunks of ``data_stream``.
+
+    Pass the cache to :py:func:`scippneutron.convert` or
+    :py:func:`scippneutron.conversion_graph`.
+    The beamline nodes of the graph are then only computed when their inputs,
+    ``position``, ``sample_position``, and ``source_position``, have
+    changed since a previous call. Inputs are compared by content, so a new
+    but equal ``position`` coord of every chunk still hits the cache,
+    while a change of time-dependent transformations leads to new positions
+    and thus to a recomputation.
+
+    Cached results are shared between all outputs which use them and must not
+    be modified in place. The cache may be used from multiple threads,
+    e.g., by :py:func:`scippneutron.convert_chunked`.
+
+    :param maxsize: Maximum number of cached results, the least recently used
+      ones are dropped first.
+    """
+
+    def __init__(self, maxsize: int = 16):
+        self._maxsize = maxsize
+        self._results: OrderedDict[Tuple, Any] = OrderedDict()
+        # Results are kept alive by _results, so their ids are not reused
+        self._keys_by_id: Dict[int, Tuple] = {}
+        self._lock = threading.Lock()
+        self.hits = 0
+        self.misses = 0
+
+    def clear(self):
+        with self._lock:
+            self._results.clear()
+            self._keys_by_id.clear()
+
+    def wrap(self, graph: Graph) -> Graph:
+        """
+        Return a copy of graph with cached versions of its beamline nodes
+        """
+        beamline_nodes = _beamline_nodes()
+        return {
+            key: self._cached(func) if key in beamline_nodes else func
+            for key, func in graph.items()
+        }
+
+    def _input_key(self, var: Any) -> Optional[Tuple]:
+        # Outputs of other cached nodes are identified without hashing them
+        key = self._keys_by_id.get(id(var))
+        if key is not None and self._results.get(key) is var:
+            return ('cached', key)
+        return fingerprint(var)
+
+    def _key(self, func: Callable, kwargs: Dict[str, Any]) -> Optional[Tuple]:
+        inputs = []
+        for name in sorted(kwargs):
+            input_key = self._input_key(kwargs[name])
+            if input_key is None:
+                return None
+            inputs.append((name, input_key))
+        return (func, tuple(inputs))
+
+    def _store(self, key: Tuple, result: Any):
+        self._results[key] = result
+        self._keys_by_id[id(result)] = key
+        while len(self._results) > self._maxsize:
+            _, dropped = self._results.popitem(last=False)
+            self._keys_by_id.pop(id(dropped), None)
+
+    def _cached(self, func: Callable) -> Callable:
+        # functools.wraps keeps the signature which transform_coords inspects
+        @functools.wraps(func)
+        def cached(**kwargs):
+            with self._lock:
+                key = self._key(func, kwargs)
+                if key is not None:
+                    if (result := self._results.get(key)) is not None:
+                        self._results.move_to_end(key)
+                        self.hits += 1
+                        return result
+                    self.misses += 1
+            # Compute without holding the lock, other threads may use other keys
+            result = func(**kwargs)
+            if key is not None:
+                with self._lock:
+                    self._store(key, result)
+            return result
+
+        return cached
@@ -31,12 +31,33 @@ from streaming_data_types.exceptions import WrongSchemaException
 from streaming_data_types.run_start_pl72 import RunStartInfo, deserialise_pl72
 
 from ._consumer_type import ConsumerType
+from ._metrics import StreamingMetrics
 
 
 class RunStartError(Exception):
     pass
 
 
+class FakeMessage:
+    """
+    Use in place of confluent_kafka.Message to feed a FakeConsumer
+    with payloads, for example in benchmarks
+    """
+
+    def __init__(self, payload: bytes, timestamp_ms: int = 0):
+        self._payload = payload
+        self._timestamp_ms = timestamp_ms
+
+    def value(self) -> bytes:
+        return self._payload
+
+    def error(self) -> None:
+        return None
+
+    def timestamp(self) -> Tuple[None, int]:
+        return None, self._timestamp_ms
+
+
 class FakeConsumer:
     """
     Use in place of confluent_kafka.Consumer
@@ -64,19 +85,46 @@ class FakeConsumer:
         except QueueEmpty:
             pass
 
+    def consume(self, num_messages: int, timeout: float) -> List:
+        msg = self.poll(timeout)
+        if msg is None:
+            return []
+        messages = [msg]
+        while len(messages) < num_messages:
+            try:
+                messages.append(self._input_queue.get_nowait())
+            except QueueEmpty:
+                break
+        return messages
+
     def close(self):
         pass
 
 
+# Maximum number of messages to get from the consumer in one go
+CONSUME_BATCH_SIZE = 1000
+# Maximum time to wait for a full batch of messages, in seconds
+CONSUME_BATCH_TIMEOUT_S = 0.1
+
+
 class KafkaConsumer:
+    """
+    Consumes messages from a single topic partition in a thread.
+    The callback is called with a list of the payloads of up to
+    batch_size messages at a time.
+    """
+
     def __init__(
         self,
         topic_partition: TopicPartition,
         consumer: Union[Consumer, FakeConsumer],
         callback: Callable,
         stop_time_ms: Optional[int] = None,
+        batch_size: int = CONSUME_BATCH_SIZE,
+        metrics: Optional[StreamingMetrics] = None,
     ):
         self._consumer = consumer
+        self._metrics = metrics
         # To consume messages the consumer must "subscribe" to one
         # or more topics or "assign" specific topic partitions, the
         # latter allows us to start consuming at an offset specified
@@ -87,6 +135,7 @@ class KafkaConsumer:
         # topic partition, they are not a bytes offset.
         self._consumer.assign([topic_partition])
         self._callback = callback
+        self._batch_size = batch_size
         self._reached_eop = False
         self.cancelled = False
         self._consume_data: Optional[threading.Thread] = None
@@ -125,38 +174,50 @@ class KafkaConsumer:
                         # after the stop time.
                         self.cancelled = True
                         break
-            msg = self._consumer.poll(timeout=2.0)
-            if msg is None:
+            # Get many messages at once, so that the buffer can
+            # deserialise them and write them to the buffer in a batch
+            messages = self._consumer.consume(
+                num_messages=self._batch_size, timeout=CONSUME_BATCH_TIMEOUT_S
+            )
+            if self._metrics is not None:
+                self._metrics.add_consumed(len(messages))
+            if not messages:
                 if reached_stop_time and at_end_of_partition:
                     self.cancelled = True
                     break
                 continue
-            if msg.error():
-                if msg.error().code() == KafkaError._PARTITION_EOF:
-                    at_end_of_partition = True
-                    if reached_stop_time:
-                        # Wall clock time is after run stop time and there
-                        # are no more messages available on Kafka for us to
-                        # consume, so cancel running the consumer.
-                        self.cancelled = True
-                        break
-                    continue
-                warn(f"Message error in consumer: {msg.error()}")
-                self.cancelled = True
-                break
 
-            at_end_of_partition = False
-            with self._stop_time_mutex:
-                if msg.timestamp()[1] > self._stop_time:
-                    reached_message_after_stop_time = True
-                    if reached_stop_time:
-                        # Wall clock time is after run stop time and remaining
-                        # messages on Kafka have timestamps after the stop
-                        # time, so cancel running the consumer.
-                        self.cancelled = True
-                        break
-                    continue
-            self._callback(msg.value())
+            payloads = []
+            for msg in messages:
+                if msg.error():
+                    if msg.error().code() == KafkaError._PARTITION_EOF:
+                        at_end_of_partition = True
+                        if reached_stop_time:
+                            # Wall clock time is after run stop time and there
+                            # are no more messages available on Kafka for us to
+                            # consume, so cancel running the consumer.
+                            self.cancelled = True
+                            break
+                        continue
+                    warn(f"Message error in consumer: {msg.error()}")
+                    self.cancelled = True
+                    break
+
+                at_end_of_partition = False
+                with self._stop_time_mutex:
+                    if msg.timestamp()[1] > self._stop_time:
+                        reached_message_after_stop_time = True
+                        if reached_stop_time:
+                            # Wall clock time is after run stop time and
+                            # remaining messages on Kafka have timestamps after
+                            # the stop time, so cancel running the consumer.
+                            self.cancelled = True
+                            break
+                        continue
+                payloads.append(msg.value())
+            # Messages before a reason to stop are still handled
+            if payloads:
+                self._callback(payloads)
 
     def stop(self):
         self.cancelled = True
@@ -238,6 +299,9 @@ def create_consumers(
     consumer_type_enum: ConsumerType,  # so we can inject fake consumer
     callback: Callable,
     test_message_queue: Optional[mp.Queue],
+    shard_index: int = 0,
+    n_shards: int = 1,
+    metrics: Optional[StreamingMetrics] = None,
 ) -> List[KafkaConsumer]:
     """
     Creates one consumer per TopicPartition that start consuming
@@ -246,6 +310,9 @@ def create_consumers(
     Having each consumer only be responsible for one partition
     greatly simplifies the logic around stopping at the end of
     the stream (making use of "end of partition" event)
+
+    If the partitions are consumed by n_shards processes, only consumers for
+    every n_shards-th partition, starting at shard_index, are created.
     """
     topic_partitions = []
     if consumer_type_enum == ConsumerType.REAL:
@@ -255,6 +322,9 @@ def create_consumers(
                 query_consumer.get_topic_partitions(topic, offset=start_time_ms)
             )
         topic_partitions = query_consumer.offsets_for_times(topic_partitions)
+        topic_partitions = sorted(
+            topic_partitions, key=lambda tp: (tp.topic, tp.partition)
+        )[shard_index::n_shards]
 
     # Run start messages are typically much larger than the
     # default maximum message size of 1MB. There are
@@ -275,7 +345,13 @@ def create_consumers(
 
     if consumer_type_enum == ConsumerType.REAL:
         consumers = [
-            KafkaConsumer(topic_partition, Consumer(config), callback, stop_time_ms)
+            KafkaConsumer(
+                topic_partition,
+                Consumer(config),
+                callback,
+                stop_time_ms,
+                metrics=metrics,
+            )
             for topic_partition in topic_partitions
         ]
     else:
@@ -285,6 +361,7 @@ def create_consumers(
                 FakeConsumer(test_message_queue),
                 callback,
                 stop_time_ms,
+                metrics=metrics,
             )
         ]
 
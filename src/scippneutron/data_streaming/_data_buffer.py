@@ -2,12 +2,14 @@
 # Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
 import multiprocessing as mp
 import threading
+import time
+from collections import deque
 from datetime import datetime
-from typing import Any, Callable, Dict, List, Optional, Tuple, Union
+from typing import Callable, Deque, Dict, List, Optional, Tuple, Union
 
 import numpy as np
 import scipp as sc
-from streaming_data_types.eventdata_ev42 import deserialise_ev42
+from streaming_data_types.eventdata_ev42 import EventData, deserialise_ev42
 from streaming_data_types.exceptions import WrongSchemaException
 from streaming_data_types.logdata_f142 import LogDataInfo, deserialise_f142
 from streaming_data_types.run_stop_6s4t import deserialise_6s4t
@@ -16,8 +18,11 @@ from streaming_data_types.sample_environment_senv import Response as FastSampleE
 from streaming_data_types.sample_environment_senv import deserialise_senv
 from streaming_data_types.timestamps_tdct import Timestamps, deserialise_tdct
 
+from .._utils import counting_sort, per_event
 from ..io.nexus._json_nexus import StreamInfo
-from ._serialisation import convert_to_pickleable_dict
+from ..log_store import LogStore
+from ._metrics import StreamingMetrics
+from ._shared_memory import SharedMemoryRing, serialise_data_chunk
 from ._stop_time import StopTimeUpdate
 from ._warnings import BufferSizeWarning, UnknownFlatbufferIdWarning
 
@@ -41,19 +46,66 @@ FAST_FB_ID = "senv"
 CHOPPER_FB_ID = "tdct"
 EVENT_FB_ID = "ev42"
 
+# Bytes per event held in an event buffer: tof (int32) and detector_id (int32).
+# Pulse times are stored once per message and weights are implicit, emitted
+# chunks hold both for every event, see _emitted_itemsizes.
+_EVENT_NBYTES = 4 + 4
 
-def _create_metadata_buffer_array(name: str, unit: str, dtype: Any, buffer_size: int):
-    return sc.DataArray(
-        sc.zeros(dims=[name], shape=(buffer_size,), unit=unit, dtype=dtype),
-        coords={
-            "time": sc.zeros(
-                dims=[name],
-                shape=(buffer_size,),
-                unit=sc.Unit("nanoseconds"),
-                dtype=np.dtype('datetime64[ns]'),
-            )
-        },
+
+def _emitted_itemsizes(compact_events: bool = False) -> List[int]:
+    """
+    Bytes per event of each array in a chunk of emitted events
+    """
+    events = _events_data_array(
+        tof=np.empty(0, dtype=np.int32),
+        detector_id=np.empty(0, dtype=np.int32),
+        pulse_time=np.empty(0, dtype=np.int64),
+        compact_events=compact_events,
     )
+    itemsizes = []
+    for column in (events.data, *events.coords.values()):
+        arrays = 1 if column.variances is None else 2
+        itemsizes += [column.values.itemsize] * arrays
+    return itemsizes
+
+
+def event_buffer_nbytes(event_buffer_size: int, compact_events: bool = False) -> int:
+    """
+    Number of bytes needed to transport the content of a full event buffer
+    in a SharedMemoryRing slot
+    """
+    # Each array in a slot may be padded by up to 8 bytes for alignment
+    return sum(
+        event_buffer_size * itemsize + 8
+        for itemsize in _emitted_itemsizes(compact_events)
+    )
+
+
+def event_buffer_memory(event_buffer_size: int, event_buffer_count: int = 2) -> int:
+    """
+    Number of bytes used by event_buffer_count event buffers
+    of event_buffer_size events
+    """
+    return event_buffer_count * event_buffer_size * _EVENT_NBYTES
+
+
+def _create_metadata_store(stream_info: StreamInfo, buffer_size: int) -> LogStore:
+    return LogStore(
+        stream_info.source_name,
+        unit=stream_info.unit,
+        dtype=stream_info.dtype,
+        capacity=buffer_size,
+    )
+
+
+def _take_metadata_array(
+    store: LogStore, mutex: threading.Lock
+) -> Tuple[bool, sc.Variable]:
+    with mutex:
+        new_data_exists = len(store) != 0
+        return_array = store.to_data_array()
+        store.clear()
+    return new_data_exists, sc.scalar(return_array)
 
 
 class _SlowMetadataBuffer:
@@ -68,34 +120,21 @@ class _SlowMetadataBuffer:
         self._buffer_mutex = threading.Lock()
         self._buffer_size = buffer_size
         self._name = stream_info.source_name
-        self._buffer_filled_size = 0
-        self._data_array = _create_metadata_buffer_array(
-            self._name, stream_info.unit, stream_info.dtype, buffer_size
-        )
+        self._store = _create_metadata_store(stream_info, buffer_size)
 
     def append_data(self, log_event: LogDataInfo, emit_data: Callable):
-        if self._buffer_filled_size == self._buffer_size:
+        if len(self._store) == self._buffer_size:
             emit_data()
 
         # Each LogDataInfo contains a single value-timestamp pair
         with self._buffer_mutex:
-            self._data_array[self._name, self._buffer_filled_size] = log_event.value
-            self._data_array.coords["time"][
-                self._name, self._buffer_filled_size
-            ].value = np.datetime64(log_event.timestamp_unix_ns, 'ns')
-            self._buffer_filled_size += 1
+            self._store.append(log_event.timestamp_unix_ns, log_event.value)
 
     def get_metadata_array(self) -> Tuple[bool, sc.Variable]:
         """
         Copy collected data from the buffer
         """
-        with self._buffer_mutex:
-            return_array = self._data_array[
-                self._name, : self._buffer_filled_size
-            ].copy()
-            new_data_exists = self._buffer_filled_size != 0
-            self._buffer_filled_size = 0
-        return new_data_exists, sc.scalar(return_array)
+        return _take_metadata_array(self._store, self._buffer_mutex)
 
 
 class _FastMetadataBuffer:
@@ -112,10 +151,7 @@ class _FastMetadataBuffer:
         self._buffer_size = buffer_size
         self._name = stream_info.source_name
         self._data_queue = data_queue
-        self._buffer_filled_size = 0
-        self._data_array = _create_metadata_buffer_array(
-            self._name, stream_info.unit, stream_info.dtype, buffer_size
-        )
+        self._store = _create_metadata_store(stream_info, buffer_size)
 
     def append_data(self, log_events: FastSampleEnvData, emit_data: Callable):
         # Each FastSampleEnvData contains an array of values and either:
@@ -134,17 +170,13 @@ class _FastMetadataBuffer:
             )
             return
 
-        if self._buffer_filled_size + message_size > self._buffer_size:
+        if len(self._store) + message_size > self._buffer_size:
             emit_data()
 
         def _datetime_to_epoch_ns(input_timestamp: datetime) -> int:
             return int(input_timestamp.timestamp() * 1_000_000_000)
 
         with self._buffer_mutex:
-            self._data_array[
-                self._name,
-                self._buffer_filled_size : self._buffer_filled_size + message_size,
-            ].values = log_events.values
             if log_events.value_ts is not None:
                 timestamps = log_events.value_ts
             else:
@@ -176,23 +208,13 @@ class _FastMetadataBuffer:
                         "environment data message (flatbuffer id: "
                         f"'{FAST_FB_ID}')"
                     )
-            self._data_array[
-                self._name,
-                self._buffer_filled_size : self._buffer_filled_size + message_size,
-            ].coords["time"].values = timestamps
-            self._buffer_filled_size += message_size
+            self._store.extend(timestamps, log_events.values)
 
     def get_metadata_array(self) -> Tuple[bool, sc.Variable]:
         """
         Copy collected data from the buffer
         """
-        with self._buffer_mutex:
-            return_array = self._data_array[
-                self._name, : self._buffer_filled_size
-            ].copy()
-            new_data_exists = self._buffer_filled_size != 0
-            self._buffer_filled_size = 0
-        return new_data_exists, sc.scalar(return_array)
+        return _take_metadata_array(self._store, self._buffer_mutex)
 
 
 class _ChopperMetadataBuffer:
@@ -258,6 +280,232 @@ _MetadataBuffer = Union[
 ]
 
 
+# Initial number of messages the pulse time table of an event buffer can hold,
+# it grows if more messages are written to the buffer
+_INITIAL_PULSE_CAPACITY = 1024
+
+
+def _events_data_array(
+    tof: np.ndarray,
+    detector_id: Optional[np.ndarray],
+    pulse_time: np.ndarray,
+    compact_events: bool = False,
+) -> sc.DataArray:
+    # Weights are always 1 for data from the streaming system,
+    # so they are not stored in the buffer
+    coords = {
+        'tof': sc.array(dims=['event'], values=tof, unit=sc.units.ns),
+        'pulse_time': sc.array(dims=['event'], values=pulse_time, unit=sc.units.ns),
+    }
+    if detector_id is not None:
+        coords['detector_id'] = sc.array(
+            dims=['event'], values=detector_id, unit=sc.units.one
+        )
+    if compact_events:
+        # Implicit unit weights, see scippneutron.compact_events
+        weights = sc.ones(dims=['event'], shape=[len(tof)], dtype='float32')
+    else:
+        weights = sc.ones(dims=['event'], shape=[len(tof)], with_variances=True)
+    return sc.DataArray(weights, coords=coords)
+
+
+class _DetectorGrouping:
+    """
+    Groups events by detector id when an event buffer is emitted,
+    and optionally histograms them into fixed tof bins.
+
+    Consumers look up the index of the pixel of each event when they write
+    messages to the event buffer, so that grouping only needs to count the
+    events of each pixel and reorder them. Events with a detector id which
+    is not in detector_ids are dropped.
+    """
+
+    def __init__(
+        self,
+        detector_ids: np.ndarray,
+        tof_bin_edges: Optional[np.ndarray] = None,
+        compact_events: bool = False,
+    ):
+        self._compact_events = compact_events
+        self._detector_ids = np.asarray(detector_ids, dtype=np.int64)
+        if self._detector_ids.ndim != 1 or self._detector_ids.size == 0:
+            raise ValueError("detector_ids must be a non-empty 1D array")
+        if np.unique(self._detector_ids).size != self._detector_ids.size:
+            raise ValueError("detector_ids must not contain duplicates")
+        self._tof_bin_edges = tof_bin_edges
+        if tof_bin_edges is not None and (
+            tof_bin_edges.ndim != 1
+            or tof_bin_edges.size < 2
+            or np.any(np.diff(tof_bin_edges) <= 0)
+        ):
+            raise ValueError("tof_bin_edges must be 1D and strictly increasing")
+        self._id_offset = int(self._detector_ids.min())
+        self._pixel_lookup = np.full(
+            int(self._detector_ids.max()) - self._id_offset + 1, -1, dtype=np.int32
+        )
+        self._pixel_lookup[self._detector_ids - self._id_offset] = np.arange(
+            self._detector_ids.size, dtype=np.int32
+        )
+
+    @property
+    def n_pixels(self) -> int:
+        return self._detector_ids.size
+
+    def pixel_index(self, detector_id: np.ndarray) -> np.ndarray:
+        """
+        Index of the pixel of each event, -1 for unknown detector ids
+        """
+        shifted = detector_id.astype(np.int64) - self._id_offset
+        known = (shifted >= 0) & (shifted < self._pixel_lookup.size)
+        pixel = np.full(detector_id.size, -1, dtype=np.int32)
+        pixel[known] = self._pixel_lookup[shifted[known]]
+        return pixel
+
+    def _detector_id_coord(self) -> sc.Variable:
+        return sc.array(dims=['detector_id'], values=self._detector_ids, unit=None)
+
+    def _histogram(self, tof: np.ndarray, pixel: np.ndarray) -> sc.DataArray:
+        n_tof = self._tof_bin_edges.size - 1
+        tof_bin = np.searchsorted(self._tof_bin_edges, tof, side='right') - 1
+        keep = (pixel >= 0) & (tof_bin >= 0) & (tof_bin < n_tof)
+        counts = np.bincount(
+            pixel[keep].astype(np.int64) * n_tof + tof_bin[keep],
+            minlength=self.n_pixels * n_tof,
+        ).reshape(self.n_pixels, n_tof)
+        # Every event has weight 1, so the variances equal the counts
+        counts = counts.astype(np.float64)
+        return sc.DataArray(
+            sc.array(
+                dims=['detector_id', 'tof'],
+                values=counts,
+                variances=counts,
+                unit=sc.units.one,
+            ),
+            coords={
+                'detector_id': self._detector_id_coord(),
+                'tof': sc.array(
+                    dims=['tof'], values=self._tof_bin_edges, unit=sc.units.ns
+                ),
+            },
+        )
+
+    def group(
+        self, tof: np.ndarray, pixel: np.ndarray, pulse_time: np.ndarray
+    ) -> sc.DataArray:
+        """
+        Group events by pixel, or histogram them if tof bin edges were given.
+
+        :param tof: Time-of-flight of each event
+        :param pixel: Index of the pixel of each event, see pixel_index
+        :param pulse_time: Pulse time of each event
+        """
+        if self._tof_bin_edges is not None:
+            return self._histogram(tof, pixel)
+        keep = pixel >= 0
+        if not np.all(keep):
+            tof, pixel, pulse_time = tof[keep], pixel[keep], pulse_time[keep]
+        # O(n) in the number of events, unlike a comparison sort
+        order, counts = counting_sort(pixel, self.n_pixels)
+        events = _events_data_array(
+            tof[order], None, pulse_time[order], self._compact_events
+        )
+        begin = sc.array(
+            dims=['detector_id'], values=np.cumsum(counts) - counts, unit=None
+        )
+        return sc.DataArray(
+            sc.bins(begin=begin, dim='event', data=events),
+            coords={'detector_id': self._detector_id_coord()},
+        )
+
+    def empty(self) -> sc.DataArray:
+        return self.group(
+            tof=np.empty(0, dtype=np.int32),
+            pixel=np.empty(0, dtype=np.int32),
+            pulse_time=np.empty(0, dtype=np.int64),
+        )
+
+
+class _EventBuffer:
+    """
+    One of the buffers in the event buffer ring of StreamedDataBuffer.
+
+    Consumer threads reserve a range of the buffer to write messages to,
+    so that they can write concurrently, and the buffer is only drained once
+    all writers which reserved a range of it have finished.
+
+    Event columns are stored in raw NumPy arrays. All events in an ev42
+    message share the pulse time, so rather than storing it per event it is
+    stored for each message in a run-length encoded table: events from
+    pulse_begin[i] up to pulse_begin[i + 1] have pulse time pulse_time[i].
+    If events are grouped by detector, the detector_id column holds the
+    index of the pixel of each event instead, see _DetectorGrouping.
+    """
+
+    def __init__(self, size: int):
+        self.filled = 0  # number of events in reserved ranges
+        self.writers = 0  # number of writers with a reserved range
+        self.resize(size)
+        self.n_pulses = 0
+        self.pulse_begin = np.zeros(_INITIAL_PULSE_CAPACITY, dtype=np.int64)
+        self.pulse_time = np.zeros(_INITIAL_PULSE_CAPACITY, dtype=np.int64)
+
+    @property
+    def nbytes(self) -> int:
+        return self.size * _EVENT_NBYTES
+
+    def resize(self, size: int):
+        """
+        Reallocate the event columns, the buffer must be empty
+        """
+        self.size = size
+        self.tof = np.zeros(size, dtype=np.int32)
+        self.detector_id = np.zeros(size, dtype=np.int32)
+
+    def add_pulses(self, pulse_begin: np.ndarray, pulse_time: np.ndarray):
+        """
+        Append to the pulse time table, this is done when reserving space
+        so that the table can be grown safely.
+        """
+        end = self.n_pulses + len(pulse_begin)
+        if end > len(self.pulse_begin):
+            capacity = max(end, 2 * len(self.pulse_begin))
+            self.pulse_begin = np.resize(self.pulse_begin, capacity)
+            self.pulse_time = np.resize(self.pulse_time, capacity)
+        self.pulse_begin[self.n_pulses : end] = pulse_begin
+        self.pulse_time[self.n_pulses : end] = pulse_time
+        self.n_pulses = end
+
+    def to_data_array(
+        self, grouping: Optional[_DetectorGrouping], compact_events: bool = False
+    ) -> sc.DataArray:
+        """
+        Copy the events in the buffer to a DataArray,
+        expanding the pulse time table to a pulse time per event
+        """
+        n_events = self.filled
+        pulse_begin = self.pulse_begin[: self.n_pulses]
+        pulse_time = per_event(
+            self.pulse_time[: self.n_pulses],
+            pulse_begin,
+            np.append(pulse_begin[1:], n_events),
+            n_events,
+        )
+        if grouping is not None:
+            return grouping.group(
+                self.tof[:n_events], self.detector_id[:n_events], pulse_time
+            )
+        return _events_data_array(
+            self.tof[:n_events],
+            self.detector_id[:n_events],
+            pulse_time,
+            compact_events,
+        )
+
+    def reset(self):
+        self.filled = 0
+        self.n_pulses = 0
+
+
 class StreamedDataBuffer:
     """
     This owns the buffers for data consumed from Kafka.
@@ -265,6 +513,28 @@ class StreamedDataBuffer:
     and resets the buffer. If a buffer fills up within the emit time
     interval then data are emitted early.
 
+    Events are accumulated in a pool of buffers, initially event_buffer_count
+    buffers of event_buffer_size events. Consumers append to the active
+    buffer, when it is full or when it is time to emit it is swapped for a
+    free buffer, and the full buffer is drained by the emit thread while
+    consumers continue appending to the new active buffer. Only reserving
+    space in the active buffer and the swap itself are done while holding
+    a lock.
+
+    If event_buffer_memory_limit allows, the pool grows rather than emitting
+    early: more buffers are allocated when all of them are full, an empty
+    buffer is enlarged to hold a message which does not fit, and buffers
+    are enlarged for the events observed per emit interval so that
+    data are emitted once per interval. Once the limit is reached
+    consumers wait for the emit thread to free a buffer, which pauses
+    consuming from Kafka rather than dropping data.
+
+    If detector_ids are given, events are emitted grouped by detector id
+    rather than as a flat list of events, or histogrammed if tof_bin_edges
+    are given as well. With compact_events, emitted events have implicit unit
+    weights, float32 ones without variances, instead of float64 weights with
+    variances.
+
     TODO: This also owns the metadata buffers. Maybe this should be moved to a
     separate place in the future?
     """
@@ -278,49 +548,79 @@ class StreamedDataBuffer:
         chopper_buffer_size: int,
         interval_s: float,
         run_id: str,
+        shared_memory: Optional[SharedMemoryRing] = None,
+        event_buffer_count: int = 2,
+        detector_ids: Optional[np.ndarray] = None,
+        tof_bin_edges: Optional[np.ndarray] = None,
+        event_buffer_memory_limit: Optional[int] = None,
+        metrics: Optional[StreamingMetrics] = None,
+        compact_events: bool = False,
     ):
-        self._buffer_mutex = threading.Lock()
+        if event_buffer_count < 2:
+            raise ValueError("event_buffer_count must be at least 2")
+        if event_buffer_memory_limit is None:
+            # Fixed size buffers
+            event_buffer_memory_limit = event_buffer_memory(
+                event_buffer_size, event_buffer_count
+            )
+        elif event_buffer_memory_limit < event_buffer_memory(
+            event_buffer_size, event_buffer_count
+        ):
+            raise ValueError(
+                "event_buffer_memory_limit is too small for event_buffer_count "
+                "buffers of event_buffer_size events"
+            )
+        if tof_bin_edges is not None and detector_ids is None:
+            raise ValueError("tof_bin_edges can only be used with detector_ids")
+        self._grouping = (
+            None
+            if detector_ids is None
+            else _DetectorGrouping(detector_ids, tof_bin_edges, compact_events)
+        )
+        self._compact_events = compact_events
+        # Guards the event buffer ring and the unrecognised message count
+        self._swap_condition = threading.Condition()
+        # Serialises emitting, so that emitted chunks stay in order
+        self._emit_mutex = threading.Lock()
         self._interval_s = interval_s
+        # Size of newly allocated event buffers, this grows to fit the
+        # observed number of events per emit interval
         self._event_buffer_size = event_buffer_size
+        self._event_buffer_memory_limit = event_buffer_memory_limit
+        # Leave room for double buffering with buffers of the largest size
+        self._max_event_buffer_size = event_buffer_memory_limit // (
+            2 * _EVENT_NBYTES
+        )
+        self._auto_event_buffer_size = self._max_event_buffer_size
+        if shared_memory is not None:
+            # Do not outgrow the shared memory slots when auto-sizing
+            self._auto_event_buffer_size = min(
+                self._auto_event_buffer_size,
+                max(
+                    event_buffer_size,
+                    shared_memory.slot_nbytes
+                    // sum(_emitted_itemsizes(compact_events)),
+                ),
+            )
+        # Number of consumer threads waiting for space in the event buffers
+        self._event_space_waiters = 0
         self._slow_metadata_buffer_size = slow_metadata_buffer_size
         self._fast_metadata_buffer_size = fast_metadata_buffer_size
         self._chopper_buffer_size = chopper_buffer_size
         self._current_run_id = run_id
-        tof_buffer = sc.zeros(
-            dims=['event'],
-            shape=[event_buffer_size],
-            unit=sc.units.ns,
-            dtype=sc.DType.int32,
-        )
-        id_buffer = sc.zeros(
-            dims=['event'],
-            shape=[event_buffer_size],
-            unit=sc.units.one,
-            dtype=sc.DType.int32,
-        )
-        pulse_times = sc.zeros(
-            dims=['event'],
-            shape=[event_buffer_size],
-            unit=sc.units.ns,
-            dtype=sc.DType.int64,
-        )
-        weights = sc.ones(
-            dims=['event'], shape=[event_buffer_size], with_variances=True
-        )
-        self._events_buffer = sc.DataArray(
-            weights,
-            coords={
-                'tof': tof_buffer,
-                'detector_id': id_buffer,
-                'pulse_time': pulse_times,
-            },
-        )
-        self._current_event = 0
+        self._event_buffers = [
+            _EventBuffer(event_buffer_size) for _ in range(event_buffer_count)
+        ]
+        self._active_event_buffer = self._event_buffers[0]
+        self._free_event_buffers = deque(self._event_buffers[1:])
+        self._full_event_buffers: Deque[_EventBuffer] = deque()
         self._cancelled = False
-        self._notify_cancelled = threading.Condition()
+        self._notify_emit_loop = threading.Condition()
         self._unrecognised_fb_id_count = 0
         self._periodic_emit: Optional[threading.Thread] = None
         self._emit_queue = queue
+        self._shared_memory = shared_memory
+        self.metrics = StreamingMetrics() if metrics is None else metrics
         # Access metadata buffer by
         # self._metadata_buffers[flatbuffer_id][source_name]
         self._metadata_buffers: Dict[str, Dict[str, _MetadataBuffer]] = {
@@ -371,74 +671,300 @@ class StreamedDataBuffer:
 
     def stop(self):
         self._cancelled = True
-        with self._notify_cancelled:
-            self._notify_cancelled.notifyAll()
+        with self._notify_emit_loop:
+            self._notify_emit_loop.notify_all()
         if self._periodic_emit is not None and self._periodic_emit.is_alive():
             self._periodic_emit.join(5.0)
         self._emit_data()  # flush the buffer
 
+    def _event_buffers_nbytes(self) -> int:
+        return sum(buffer.nbytes for buffer in self._event_buffers)
+
+    def _reserve_memory(self, nbytes: int) -> bool:
+        """
+        Check whether nbytes more can be allocated for event buffers,
+        releasing free buffers from the pool to make room if needed.
+        Must be called while holding self._swap_condition.
+        """
+        limit = self._event_buffer_memory_limit
+        while self._event_buffers_nbytes() + nbytes > limit and (
+            self._free_event_buffers
+        ):
+            self._event_buffers.remove(self._free_event_buffers.pop())
+        return self._event_buffers_nbytes() + nbytes <= limit
+
+    def _take_free_event_buffer(self) -> Optional[_EventBuffer]:
+        """
+        Get a free event buffer, allocating a new one if all buffers are
+        in use and the memory limit allows it.
+        Must be called while holding self._swap_condition.
+        """
+        target_nbytes = self._event_buffer_size * _EVENT_NBYTES
+        if self._free_event_buffers:
+            buffer = self._free_event_buffers.popleft()
+            if buffer.size < self._event_buffer_size and self._reserve_memory(
+                target_nbytes - buffer.nbytes
+            ):
+                buffer.resize(self._event_buffer_size)
+            return buffer
+        if self._reserve_memory(target_nbytes):
+            buffer = _EventBuffer(self._event_buffer_size)
+            self._event_buffers.append(buffer)
+            return buffer
+        return None
+
+    def _grow_empty_event_buffer(self, buffer: _EventBuffer, n_events: int) -> bool:
+        """
+        Enlarge the empty active buffer so that it can hold n_events.
+        Must be called while holding self._swap_condition.
+        """
+        size = max(n_events, min(2 * buffer.size, self._max_event_buffer_size))
+        if not self._reserve_memory((size - buffer.size) * _EVENT_NBYTES):
+            return False
+        buffer.resize(size)
+        return True
+
+    def _retire_active_event_buffer(self) -> bool:
+        """
+        Queue the active event buffer to be drained and swap in a free one.
+        Must be called while holding self._swap_condition.
+        """
+        if not self._active_event_buffer.filled:
+            return False
+        buffer = self._take_free_event_buffer()
+        if buffer is None:
+            return False
+        self._full_event_buffers.append(self._active_event_buffer)
+        self._active_event_buffer = buffer
+        return True
+
+    def _drain_event_buffer(self, buffer: _EventBuffer) -> sc.DataArray:
+        with self._swap_condition:
+            self._swap_condition.wait_for(lambda: buffer.writers == 0)
+        # No writer can reserve space in a full buffer, so it is safe
+        # to copy it without holding the lock
+        new_data = buffer.to_data_array(self._grouping, self._compact_events)
+        with self._swap_condition:
+            buffer.reset()
+            self._free_event_buffers.append(buffer)
+            self._swap_condition.notify_all()
+        return new_data
+
+    def _add_metadata(self, new_data: sc.DataArray) -> bool:
+        new_metadata_exists = False
+        for _, buffers in self._metadata_buffers.items():
+            for name, buffer in buffers.items():
+                (new_buffer_data_exists, metadata_array) = buffer.get_metadata_array()
+                new_data.attrs[name] = metadata_array
+                if new_buffer_data_exists:
+                    new_metadata_exists = True
+        return new_metadata_exists
+
     def _emit_data(self):
-        with self._buffer_mutex:
-            if self._unrecognised_fb_id_count:
+        with self._emit_mutex:
+            with self._swap_condition:
+                unrecognised_fb_id_count = self._unrecognised_fb_id_count
+                self._unrecognised_fb_id_count = 0
+            if unrecognised_fb_id_count:
                 self._emit_queue.put(
                     UnknownFlatbufferIdWarning(
-                        f"Received {self._unrecognised_fb_id_count}"
+                        f"Received {unrecognised_fb_id_count}"
                         " messages with unrecognised FlatBuffer ids"
                     )
                 )
-                self._unrecognised_fb_id_count = 0
-            new_data = self._events_buffer['event', : self._current_event].copy()
-            new_data_exists = self._current_event != 0
-            for _, buffers in self._metadata_buffers.items():
-                for name, buffer in buffers.items():
-                    (new_metadata_exists, metadata_array) = buffer.get_metadata_array()
-                    new_data.attrs[name] = metadata_array
-                    if new_metadata_exists:
-                        new_data_exists = True
-            self._current_event = 0
-        if new_data_exists:
-            self._emit_queue.put(convert_to_pickleable_dict(new_data))
+
+            # Emit each full buffer as a separate chunk, followed by the
+            # active buffer. The active buffer is only retired once so that
+            # this terminates even when consumers keep appending.
+            emitted = False
+            retired_active = False
+            n_emitted_buffers = 0
+            n_emitted_events = 0
+            while True:
+                with self._swap_condition:
+                    if not self._full_event_buffers and not retired_active:
+                        self._retire_active_event_buffer()
+                        retired_active = True
+                    if not self._full_event_buffers:
+                        break
+                    buffer = self._full_event_buffers.popleft()
+                n_emitted_buffers += 1
+                n_emitted_events += buffer.filled
+                self.metrics.add_emit(buffer.filled)
+                new_data = self._drain_event_buffer(buffer)
+                self._add_metadata(new_data)
+                self._emit_queue.put(
+                    serialise_data_chunk(new_data, self._shared_memory)
+                )
+                emitted = True
+
+            if n_emitted_buffers > 1:
+                # Buffers filled up within the interval, size new buffers for
+                # the observed number of events per interval
+                with self._swap_condition:
+                    self._event_buffer_size = max(
+                        self._event_buffer_size,
+                        min(n_emitted_events, self._auto_event_buffer_size),
+                    )
+
+            if not emitted:
+                # There are no new events but there may be new metadata
+                if self._grouping is not None:
+                    new_data = self._grouping.empty()
+                else:
+                    new_data = _events_data_array(
+                        tof=np.empty(0, dtype=np.int32),
+                        detector_id=np.empty(0, dtype=np.int32),
+                        pulse_time=np.empty(0, dtype=np.int64),
+                        compact_events=self._compact_events,
+                    )
+                if self._add_metadata(new_data):
+                    self.metrics.add_emit(0)
+                    self._emit_queue.put(
+                        serialise_data_chunk(new_data, self._shared_memory)
+                    )
 
     def _emit_loop(self):
         while not self._cancelled:
-            with self._notify_cancelled:
-                self._notify_cancelled.wait(timeout=self._interval_s)
+            with self._notify_emit_loop:
+                # Wake up early if a consumer is waiting for an event buffer
+                # to be freed, otherwise full buffers are emitted on time
+                woken_early = self._notify_emit_loop.wait_for(
+                    lambda: self._cancelled or self._event_space_waiters > 0,
+                    timeout=self._interval_s,
+                )
+            if woken_early and not self._cancelled:
+                self.metrics.add_early_emit()
             self._emit_data()
 
-    def _handled_event_data(self, new_data: bytes) -> bool:
+    def _emit_data_early(self):
+        """
+        Emit because a metadata buffer is full
+        """
+        self.metrics.add_early_emit()
+        self._emit_data()
+
+    def _reserve_events(
+        self, message_ends: np.ndarray, pulse_times: np.ndarray
+    ) -> Tuple[_EventBuffer, int, int]:
+        """
+        Reserve space in the active event buffer for as many of the messages
+        as fit, but at least one.
+
+        :param message_ends: Cumulative sum of the number of events in each
+          message, relative to the first message to reserve space for.
+        :param pulse_times: Pulse time of each message.
+        :return: The buffer, the index of the first reserved event and the number
+          of messages reserved. release_events must be called after writing the
+          events to the buffer.
+        """
+        lock_wait_s = 0.0
+        backpressure_wait_s = 0.0
         try:
-            deserialised_data = deserialise_ev42(new_data)
-            message_size = deserialised_data.detector_id.size
-            if message_size > self._event_buffer_size:
+            while True:
+                requested = time.perf_counter()
+                with self._swap_condition:
+                    lock_wait_s += time.perf_counter() - requested
+                    reserved = self._try_reserve_events(message_ends, pulse_times)
+                    if reserved is not None:
+                        return reserved
+                    # The memory limit is reached, wait for the emit thread to
+                    # free a buffer. This pauses consuming, applying
+                    # back-pressure.
+                    self._event_space_waiters += 1
+                    with self._notify_emit_loop:
+                        self._notify_emit_loop.notify_all()
+                    wait_start = time.perf_counter()
+                    self._swap_condition.wait(timeout=self._interval_s)
+                    backpressure_wait_s += time.perf_counter() - wait_start
+                    self._event_space_waiters -= 1
+        finally:
+            self.metrics.add_lock_wait(lock_wait_s)
+            if backpressure_wait_s:
+                self.metrics.add_backpressure_wait(backpressure_wait_s)
+
+    def _try_reserve_events(
+        self, message_ends: np.ndarray, pulse_times: np.ndarray
+    ) -> Optional[Tuple[_EventBuffer, int, int]]:
+        """
+        See _reserve_events, returns None if the event buffers have reached
+        the memory limit. Must be called while holding self._swap_condition.
+        """
+        while True:
+            buffer = self._active_event_buffer
+            n_messages = int(
+                np.searchsorted(message_ends, buffer.size - buffer.filled, side='right')
+            )
+            if n_messages > 0:
+                begin = buffer.filled
+                message_begins = np.concatenate(([0], message_ends[: n_messages - 1]))
+                buffer.add_pulses(begin + message_begins, pulse_times[:n_messages])
+                buffer.filled += int(message_ends[n_messages - 1])
+                buffer.writers += 1
+                return buffer, begin, n_messages
+            if buffer.filled == 0:
+                # The first message does not fit in the empty buffer
+                if self._grow_empty_event_buffer(buffer, int(message_ends[0])):
+                    continue
+            elif self._retire_active_event_buffer():
+                # New data would overfill the buffer, so a free buffer was
+                # swapped in and the full one is drained on the next emit
+                continue
+            return None
+
+    def _release_events(self, buffer: _EventBuffer):
+        with self._swap_condition:
+            buffer.writers -= 1
+            if buffer.writers == 0:
+                self._swap_condition.notify_all()
+
+    def _write_event_messages(self, messages: List[EventData]):
+        messages_to_write = []
+        for message in messages:
+            message_size = message.detector_id.size
+            if message_size > self._max_event_buffer_size:
                 self._emit_queue.put(
                     BufferSizeWarning(
                         "Single message would overflow the event data buffer, "
-                        "please restart with a larger buffer size:\n"
-                        f"message_size: {message_size}, event_buffer_size:"
-                        f" {self._event_buffer_size}. These data have been "
-                        f"skipped!"
+                        "please restart with a larger event buffer memory limit:\n"
+                        f"message_size: {message_size}, event_buffer_memory_limit:"
+                        f" {self._event_buffer_memory_limit}. These data have "
+                        f"been skipped!"
                     )
                 )
-                return True
-            # If new data would overfill buffer then emit data
-            # currently in buffer first
-            if self._current_event + message_size > self._event_buffer_size:
-                self._emit_data()
-            with self._buffer_mutex:
-                frame = self._events_buffer[
-                    'event', self._current_event : self._current_event + message_size
-                ]
-                frame.coords['detector_id'].values = deserialised_data.detector_id
-                frame.coords['tof'].values = deserialised_data.time_of_flight
-                frame.coords[
-                    'pulse_time'
-                ].values = deserialised_data.pulse_time * np.ones_like(
-                    deserialised_data.time_of_flight
-                )
-                self._current_event += message_size
-        except WrongSchemaException:
-            return False
-        return True
+                self.metrics.add_dropped(1, message_size)
+            elif message_size > 0:
+                messages_to_write.append(message)
+
+        sizes = np.array([m.detector_id.size for m in messages_to_write], dtype=int)
+        pulse_times = np.array([m.pulse_time for m in messages_to_write], dtype=int)
+        n_unknown_detector_events = 0
+        first = 0
+        while first < len(messages_to_write):
+            buffer, begin, n_messages = self._reserve_events(
+                np.cumsum(sizes[first:]), pulse_times[first:]
+            )
+            try:
+                end = begin
+                for message in messages_to_write[first : first + n_messages]:
+                    message_size = message.detector_id.size
+                    if self._grouping is not None:
+                        pixel = self._grouping.pixel_index(message.detector_id)
+                        n_unknown_detector_events += np.count_nonzero(pixel < 0)
+                        buffer.detector_id[end : end + message_size] = pixel
+                    else:
+                        buffer.detector_id[
+                            end : end + message_size
+                        ] = message.detector_id
+                    buffer.tof[end : end + message_size] = message.time_of_flight
+                    end += message_size
+            finally:
+                self._release_events(buffer)
+            first += n_messages
+        self.metrics.add_buffered_events(int(sizes.sum()))
+        if n_unknown_detector_events:
+            # Events of unknown detectors are dropped when grouping
+            self.metrics.add_dropped(0, n_unknown_detector_events)
 
     def _handled_metadata(
         self, new_data: bytes, source_field_name: str, deserialise: Callable, fb_id: str
@@ -448,7 +974,7 @@ class StreamedDataBuffer:
             try:
                 self._metadata_buffers[fb_id][
                     getattr(deserialised_data, source_field_name)
-                ].append_data(deserialised_data, self._emit_data)
+                ].append_data(deserialised_data, self._emit_data_early)
                 return True
             except KeyError:
                 # Ignore data from unknown source name
@@ -461,26 +987,66 @@ class StreamedDataBuffer:
         try:
             stop_run_data = deserialise_6s4t(new_data)
             if stop_run_data.job_id == self._current_run_id:
+                # Data which precede the run stop are emitted before it
+                self._emit_data()
                 self._emit_queue.put(StopTimeUpdate(stop_run_data.stop_time))
             return True
         except WrongSchemaException:
             return False
 
-    def new_data(self, new_data: bytes):
-        """
-        This is the callback which is given to the consumers.
-        """
-        if self._handled_event_data(new_data):
-            return
-        if self._handled_metadata(
-            new_data, "source_name", deserialise_f142, SLOW_FB_ID
-        ):
-            return
-        if self._handled_metadata(new_data, "name", deserialise_senv, FAST_FB_ID):
-            return
-        if self._handled_metadata(new_data, "name", deserialise_tdct, CHOPPER_FB_ID):
-            return
+    def _handled_any_metadata(self, new_data: bytes) -> bool:
+        return (
+            self._handled_metadata(
+                new_data, "source_name", deserialise_f142, SLOW_FB_ID
+            )
+            or self._handled_metadata(new_data, "name", deserialise_senv, FAST_FB_ID)
+            or self._handled_metadata(
+                new_data, "name", deserialise_tdct, CHOPPER_FB_ID
+            )
+        )
+
+    def _handle_other_data(self, new_data: bytes):
         if self._handled_stop_run(new_data):
             return
         # new data were not handled
-        self._unrecognised_fb_id_count += 1
+        with self._swap_condition:
+            self._unrecognised_fb_id_count += 1
+
+    def new_data_batch(self, new_data: List[bytes]):
+        """
+        This is the callback which is given to the consumers.
+        Consecutive event data messages in the batch are written to the
+        event buffer together. Metadata are time-stamped and buffered as they
+        come, while other messages, e.g., run stop, are handled after the
+        events which precede them have been written.
+        """
+        event_messages = []
+        deserialise_s = {}
+        for payload in new_data:
+            start = time.perf_counter()
+            handled = True
+            try:
+                event_messages.append(deserialise_ev42(payload))
+                fb_id = EVENT_FB_ID
+            except WrongSchemaException:
+                handled = self._handled_any_metadata(payload)
+                # Bytes 4 to 8 of a flatbuffer are its file identifier
+                fb_id = payload[4:8].decode(errors='replace')
+            elapsed_s = time.perf_counter() - start
+            if not handled:
+                if event_messages:
+                    self._write_event_messages(event_messages)
+                    event_messages = []
+                start = time.perf_counter()
+                self._handle_other_data(payload)
+                elapsed_s += time.perf_counter() - start
+            deserialise_s[fb_id] = deserialise_s.get(fb_id, 0.0) + elapsed_s
+        self.metrics.add_deserialise_time(deserialise_s)
+        if event_messages:
+            self._write_event_messages(event_messages)
+
+    def new_data(self, new_data: bytes):
+        """
+        Handle a single message payload.
+        """
+        self.new_data_batch([new_data])
@@ -1,11 +1,17 @@
 # SPDX-License-Identifier: BSD-3-Clause
 # Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
 import multiprocessing as mp
+import time
 from dataclasses import dataclass
 from enum import Enum
 from queue import Empty as QueueEmpty
-from typing import List, Optional
+from queue import Full as QueueFull
+from typing import Dict, List, Optional
 
+import numpy as np
+import scipp as sc
+
+from .._utils import get_attrs
 from ..io.nexus.load_nexus import StreamInfo
 from ._consumer import (
     all_consumers_stopped,
@@ -15,6 +21,13 @@ from ._consumer import (
 )
 from ._consumer_type import ConsumerType
 from ._data_buffer import StreamedDataBuffer
+from ._metrics import StreamingMetrics, StreamingStats
+from ._shared_memory import (
+    SharedMemoryRing,
+    deserialise_data_chunk,
+    serialise_data_chunk,
+)
+from ._stop_time import StopTimeUpdate
 
 
 class InstructionType(Enum):
@@ -28,6 +41,16 @@ class ManagerInstruction:
     stop_time_ms: Optional[int] = None  # milliseconds from unix epoch
 
 
+@dataclass(frozen=True)
+class ShardStopped:
+    """
+    Put on the data queue by a consumption manager which consumes a shard
+    of the partitions, when it has stopped
+    """
+
+    shard_index: int
+
+
 def data_consumption_manager(
     start_time_ms: int,
     stop_time_ms: Optional[int],
@@ -44,6 +67,13 @@ def data_consumption_manager(
     worker_instruction_queue: mp.Queue,
     data_queue: mp.Queue,
     test_message_queue: Optional[mp.Queue],
+    shared_memory: Optional[SharedMemoryRing] = None,
+    detector_ids: Optional[np.ndarray] = None,
+    tof_bin_edges: Optional[np.ndarray] = None,
+    event_buffer_memory_limit: Optional[int] = None,
+    shard_index: int = 0,
+    n_shards: int = 1,
+    compact_events: bool = False,
 ):
     """
     Starts and stops buffers and data consumers which collect data and
@@ -51,7 +81,13 @@ def data_consumption_manager(
 
     All input args must be mp.Queue or pickleable as this function is launched
     as a multiprocessing.Process.
+
+    If n_shards > 1 this only consumes the partitions of shard shard_index,
+    and data are sent to shard_merger rather than to the main process.
+
+    StreamingStats are put on the data queue once per emit interval.
     """
+    metrics = StreamingMetrics()
     buffer = StreamedDataBuffer(
         data_queue,
         event_buffer_size,
@@ -60,6 +96,12 @@ def data_consumption_manager(
         chopper_buffer_size,
         interval_s,
         run_id,
+        shared_memory,
+        detector_ids=detector_ids,
+        tof_bin_edges=tof_bin_edges,
+        event_buffer_memory_limit=event_buffer_memory_limit,
+        metrics=metrics,
+        compact_events=compact_events,
     )
 
     if stream_info is not None:
@@ -71,14 +113,21 @@ def data_consumption_manager(
         set(topics),
         kafka_broker,
         consumer_type,
-        buffer.new_data,
+        buffer.new_data_batch,
         test_message_queue,
+        shard_index,
+        n_shards,
+        metrics,
     )
 
     start_consumers(consumers)
     buffer.start()
 
+    next_stats_s = time.monotonic() + interval_s
     while not all_consumers_stopped(consumers):
+        if time.monotonic() >= next_stats_s:
+            _put_stats(data_queue, metrics, shard_index)
+            next_stats_s = time.monotonic() + interval_s
         try:
             instruction = worker_instruction_queue.get(timeout=0.5)
             if instruction.type == InstructionType.STOP_NOW:
@@ -93,3 +142,122 @@ def data_consumption_manager(
             stop_consumers(consumers)
 
     buffer.stop()
+    if shared_memory is not None:
+        shared_memory.close()
+    if n_shards > 1:
+        data_queue.put(ShardStopped(shard_index))
+
+
+def _queue_depth(queue: mp.Queue) -> Optional[int]:
+    try:
+        return queue.qsize()
+    except NotImplementedError:
+        # Not available on macOS
+        return None
+
+
+def _put_stats(data_queue: mp.Queue, metrics: StreamingMetrics, shard_index: int):
+    stats = metrics.snapshot(_queue_depth(data_queue), shard_index)
+    try:
+        # Stats must not block consumption if the data queue is full
+        data_queue.put_nowait(stats)
+    except QueueFull:
+        pass
+
+
+def _merge_metadata(chunks: List[sc.DataArray]) -> Dict[str, sc.Variable]:
+    merged = {}
+    for chunk in chunks:
+        for name, metadata in get_attrs(chunk).items():
+            merged.setdefault(name, []).append(metadata.value)
+    return {
+        name: sc.scalar(sc.concat(values, dim=name)) for name, values in merged.items()
+    }
+
+
+def merge_chunks(chunks: List[sc.DataArray]) -> sc.DataArray:
+    """
+    Combine chunks of data from the consumption managers of all shards.
+    Events are concatenated, or bin-wise concatenated if they are grouped by
+    detector id, histograms are summed and metadata are concatenated.
+    """
+    without_attrs = [
+        sc.DataArray(chunk.data, coords=dict(chunk.coords)) for chunk in chunks
+    ]
+    if chunks[0].dims == ('event',):
+        merged = sc.concat(without_attrs, 'event')
+    elif chunks[0].bins is not None:
+        merged = sc.concat(without_attrs, 'shard').bins.concat('shard')
+    else:
+        merged = sc.concat(without_attrs, 'shard').sum('shard')
+    merged_attrs = get_attrs(merged)
+    for name, metadata in _merge_metadata(chunks).items():
+        merged_attrs[name] = metadata
+    return merged
+
+
+def _forward_instructions(
+    worker_instruction_queue: mp.Queue, shard_instruction_queues: List[mp.Queue]
+):
+    while True:
+        try:
+            instruction = worker_instruction_queue.get_nowait()
+        except QueueEmpty:
+            return
+        except (ValueError, OSError):
+            # Queue has been closed, stop the shards
+            instruction = ManagerInstruction(InstructionType.STOP_NOW)
+        for queue in shard_instruction_queues:
+            queue.put(instruction)
+        if instruction.type == InstructionType.STOP_NOW:
+            return
+
+
+def shard_merger(
+    interval_s: float,
+    worker_instruction_queue: mp.Queue,
+    shard_instruction_queues: List[mp.Queue],
+    shard_data_queue: mp.Queue,
+    data_queue: mp.Queue,
+    shared_memory: Optional[SharedMemoryRing] = None,
+):
+    """
+    Merges the data from consumption managers which each consume a shard of
+    the partitions, so that the main process receives one chunk per emit
+    interval, and forwards instructions from the main process to them.
+
+    All input args must be mp.Queue or pickleable as this function is launched
+    as a multiprocessing.Process.
+    """
+    n_running_shards = len(shard_instruction_queues)
+    pending_chunks = []
+    next_emit_s = time.monotonic() + interval_s
+
+    def emit():
+        if pending_chunks:
+            data_queue.put(
+                serialise_data_chunk(merge_chunks(pending_chunks), shared_memory)
+            )
+            pending_chunks.clear()
+
+    while n_running_shards > 0:
+        _forward_instructions(worker_instruction_queue, shard_instruction_queues)
+        try:
+            new_data = shard_data_queue.get(
+                timeout=max(0.0, min(0.1, next_emit_s - time.monotonic()))
+            )
+            if isinstance(new_data, ShardStopped):
+                n_running_shards -= 1
+            elif isinstance(new_data, (Warning, StopTimeUpdate, StreamingStats)):
+                data_queue.put(new_data)
+            else:
+                pending_chunks.append(deserialise_data_chunk(new_data))
+        except QueueEmpty:
+            pass
+        if time.monotonic() >= next_emit_s:
+            emit()
+            next_emit_s = time.monotonic() + interval_s
+
+    emit()  # flush data from the stopped shards
+    if shared_memory is not None:
+        shared_memory.close()
@@ -1,7 +1,9 @@
 # SPDX-License-Identifier: BSD-3-Clause
 # Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
 from datetime import datetime
-from typing import Optional
+from typing import Dict, Optional
+
+from ._metrics import StreamingStats, combine_stats
 
 
 def _unix_ms_to_datetime(unix_ms: int) -> datetime:
@@ -24,6 +26,9 @@ class DataStreamWidget:
         self._start_time = widgets.Label("-")
         self._stop_time = widgets.Label("-")
         self._time_format = "%m/%d/%Y %H:%M:%S"
+        self._stats = widgets.Label("-")
+        # Latest stats from each consumer process
+        self._shard_stats: Dict[int, StreamingStats] = {}
 
         if run_title is not None:
             self.set_title(run_title)
@@ -35,12 +40,21 @@ class DataStreamWidget:
             self.set_stop_time(stop_time_ms)
 
         display(
-            widgets.HBox(
+            widgets.VBox(
                 [
-                    self._stop_button,
-                    widgets.HBox([widgets.Label('Run title:'), self._title]),
-                    widgets.HBox([widgets.Label('Start time:'), self._start_time]),
-                    widgets.HBox([widgets.Label('Stop time:'), self._stop_time]),
+                    widgets.HBox(
+                        [
+                            self._stop_button,
+                            widgets.HBox([widgets.Label('Run title:'), self._title]),
+                            widgets.HBox(
+                                [widgets.Label('Start time:'), self._start_time]
+                            ),
+                            widgets.HBox(
+                                [widgets.Label('Stop time:'), self._stop_time]
+                            ),
+                        ]
+                    ),
+                    widgets.HBox([widgets.Label('Stats:'), self._stats]),
                 ]
             )
         )
@@ -60,6 +74,25 @@ class DataStreamWidget:
             self._time_format
         )
 
+    def set_stats(self, stats: StreamingStats):
+        self._shard_stats[stats.shard_index] = stats
+        total = combine_stats(list(self._shard_stats.values()))
+        deserialise = ", ".join(
+            f"{fb_id} {seconds / total.period_s:.0%}"
+            for fb_id, seconds in sorted(total.deserialise_s.items())
+        )
+        queue_depth = "-" if total.queue_depth is None else total.queue_depth
+        self._stats.value = (
+            f"{total.messages_per_s:.0f} msg/s, {total.events_per_s:.3g} events/s, "
+            f"deserialising: {deserialise or '-'}, "
+            f"lock wait: {total.lock_wait_s * 1000:.1f} ms, "
+            f"back-pressure: {total.backpressure_wait_s:.2f} s, "
+            f"mean emit: {total.mean_emit_size:.0f} events, "
+            f"early emits: {total.early_emits}, "
+            f"dropped: {total.dropped_messages} msg / {total.dropped_events} events, "
+            f"queue depth: {queue_depth}"
+        )
+
     def set_title(self, new_run_title: str):
         self._title.value = new_run_title
 
@@ -0,0 +1,160 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
+"""
+Lightweight counters for the hot paths of data streaming.
+
+Consumers and the StreamedDataBuffer record into a StreamingMetrics,
+and data_consumption_manager periodically puts a StreamingStats snapshot
+of it on the data queue, to be shown in the DataStreamWidget.
+"""
+
+import threading
+import time
+from dataclasses import dataclass, field
+from typing import Dict, List, Optional
+
+
+@dataclass(frozen=True)
+class StreamingStats:
+    """
+    Metrics of a data consumption process over the period since
+    the previous StreamingStats
+    """
+
+    period_s: float
+    messages_per_s: float
+    events_per_s: float
+    # Time spent deserialising messages, by flatbuffer id, in seconds.
+    # For metadata this includes adding them to their buffer.
+    deserialise_s: Dict[str, float] = field(default_factory=dict)
+    # Time consumers waited to acquire the event buffer lock
+    lock_wait_s: float = 0.0
+    # Time consumers waited for the emit thread to free an event buffer
+    backpressure_wait_s: float = 0.0
+    emitted_chunks: int = 0
+    emitted_events: int = 0
+    # Emits before the end of the emit interval, because a buffer filled up
+    early_emits: int = 0
+    dropped_messages: int = 0
+    dropped_events: int = 0
+    # Number of items in the data queue, None if the platform cannot tell
+    queue_depth: Optional[int] = None
+    shard_index: int = 0
+
+    @property
+    def mean_emit_size(self) -> float:
+        if self.emitted_chunks == 0:
+            return 0.0
+        return self.emitted_events / self.emitted_chunks
+
+
+def combine_stats(stats: List[StreamingStats]) -> StreamingStats:
+    """
+    Total of the latest stats of each shard of the consumed partitions
+    """
+    deserialise_s = {}
+    for shard_stats in stats:
+        for fb_id, seconds in shard_stats.deserialise_s.items():
+            deserialise_s[fb_id] = deserialise_s.get(fb_id, 0.0) + seconds
+    queue_depths = [s.queue_depth for s in stats if s.queue_depth is not None]
+    return StreamingStats(
+        period_s=max(s.period_s for s in stats),
+        messages_per_s=sum(s.messages_per_s for s in stats),
+        events_per_s=sum(s.events_per_s for s in stats),
+        deserialise_s=deserialise_s,
+        lock_wait_s=sum(s.lock_wait_s for s in stats),
+        backpressure_wait_s=sum(s.backpressure_wait_s for s in stats),
+        emitted_chunks=sum(s.emitted_chunks for s in stats),
+        emitted_events=sum(s.emitted_events for s in stats),
+        early_emits=sum(s.early_emits for s in stats),
+        dropped_messages=sum(s.dropped_messages for s in stats),
+        dropped_events=sum(s.dropped_events for s in stats),
+        queue_depth=max(queue_depths) if queue_depths else None,
+    )
+
+
+class StreamingMetrics:
+    """
+    Thread-safe counters, which are reset whenever a snapshot is taken.
+    Callers record once per batch of messages or per emit rather than per
+    message, to keep the cost of holding the lock negligible.
+    """
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self._period_start = time.monotonic()
+        self._reset()
+
+    def _reset(self):
+        self._messages = 0
+        self._events = 0
+        self._deserialise_s: Dict[str, float] = {}
+        self._lock_wait_s = 0.0
+        self._backpressure_wait_s = 0.0
+        self._emitted_chunks = 0
+        self._emitted_events = 0
+        self._early_emits = 0
+        self._dropped_messages = 0
+        self._dropped_events = 0
+
+    def add_consumed(self, n_messages: int):
+        with self._lock:
+            self._messages += n_messages
+
+    def add_buffered_events(self, n_events: int):
+        with self._lock:
+            self._events += n_events
+
+    def add_deserialise_time(self, deserialise_s: Dict[str, float]):
+        with self._lock:
+            for fb_id, seconds in deserialise_s.items():
+                self._deserialise_s[fb_id] = (
+                    self._deserialise_s.get(fb_id, 0.0) + seconds
+                )
+
+    def add_lock_wait(self, seconds: float):
+        with self._lock:
+            self._lock_wait_s += seconds
+
+    def add_backpressure_wait(self, seconds: float):
+        with self._lock:
+            self._backpressure_wait_s += seconds
+
+    def add_emit(self, n_events: int):
+        with self._lock:
+            self._emitted_chunks += 1
+            self._emitted_events += n_events
+
+    def add_early_emit(self):
+        with self._lock:
+            self._early_emits += 1
+
+    def add_dropped(self, n_messages: int, n_events: int):
+        with self._lock:
+            self._dropped_messages += n_messages
+            self._dropped_events += n_events
+
+    def snapshot(
+        self, queue_depth: Optional[int] = None, shard_index: int = 0
+    ) -> StreamingStats:
+        with self._lock:
+            now = time.monotonic()
+            period_s = max(now - self._period_start, 1e-9)
+            stats = StreamingStats(
+                period_s=period_s,
+                messages_per_s=self._messages / period_s,
+                events_per_s=self._events / period_s,
+                deserialise_s=dict(self._deserialise_s),
+                lock_wait_s=self._lock_wait_s,
+                backpressure_wait_s=self._backpressure_wait_s,
+                emitted_chunks=self._emitted_chunks,
+                emitted_events=self._emitted_events,
+                early_emits=self._early_emits,
+                dropped_messages=self._dropped_messages,
+                dropped_events=self._dropped_events,
+                queue_depth=queue_depth,
+                shard_index=shard_index,
+            )
+            self._period_start = now
+            self._reset()
+        return stats
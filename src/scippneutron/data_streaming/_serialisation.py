@@ -5,11 +5,14 @@ Convert a Scipp DataArray to a picklable dictionary and back.
 Can be used to move DataArrays between multiprocessing.Process.
 """
 
-from typing import Any, Dict
+from dataclasses import dataclass
+from typing import Any, Callable, Dict
 
 import numpy as np
 import scipp as sc
 
+from .._utils import get_attrs
+
 _scipp_containers = ("DataArray", "DataSet", "Variable")
 
 
@@ -78,3 +81,53 @@ def convert_from_pickleable_dict(data_dict: Dict) -> sc.DataArray:
     return sc.DataArray(
         data=data_dict["data"], coords=data_dict["coords"], attrs=data_dict["attrs"]
     )
+
+
+@dataclass(frozen=True)
+class BinnedDataChunk:
+    """
+    Event data grouped by detector id, in a form which can be moved
+    between multiprocessing.Process.
+
+    The content of the bins is serialised as a flat list of events sorted
+    by detector id, together with the attrs of the binned data,
+    so it can be transported like ungrouped event data.
+    """
+
+    events: Any  # serialised 1D events
+    begin: np.ndarray  # index of the first event of each detector
+    end: np.ndarray  # index after the last event of each detector
+    detector_id: np.ndarray
+
+    @classmethod
+    def from_data_array(
+        cls, data: sc.DataArray, serialise_events: Callable
+    ) -> "BinnedDataChunk":
+        constituents = data.bins.constituents
+        events = constituents['data']
+        events_attrs = get_attrs(events)
+        for name, attr in get_attrs(data).items():
+            events_attrs[name] = attr
+        return cls(
+            events=serialise_events(events),
+            begin=constituents['begin'].values,
+            end=constituents['end'].values,
+            detector_id=data.coords['detector_id'].values,
+        )
+
+    def to_data_array(self, events: sc.DataArray) -> sc.DataArray:
+        """
+        :param events: The deserialised events of this chunk
+        """
+        content = sc.DataArray(events.data, coords=dict(events.coords))
+        begin = sc.array(dims=['detector_id'], values=self.begin, unit=None)
+        end = sc.array(dims=['detector_id'], values=self.end, unit=None)
+        return sc.DataArray(
+            sc.bins(begin=begin, end=end, dim='event', data=content),
+            coords={
+                'detector_id': sc.array(
+                    dims=['detector_id'], values=self.detector_id, unit=None
+                )
+            },
+            attrs=dict(get_attrs(events).items()),
+        )
@@ -0,0 +1,264 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
+"""
+Move event data between multiprocessing.Process via a ring of
+shared memory segments ("slots").
+
+The producer copies the event columns of a DataArray into a free slot
+and puts only a small, pickleable SharedMemoryChunk descriptor on the
+data queue. The consumer copies the columns of the slot into new
+scipp Variables and hands the slot back to the producer.
+This is not zero-copy, the event data are still copied once on
+serialise and once on deserialise, but it avoids converting them to
+nested dicts and pickling them through the queue's pipe,
+see _serialisation.py for the general purpose fallback.
+"""
+
+import multiprocessing as mp
+from dataclasses import dataclass
+from multiprocessing.shared_memory import SharedMemory
+from queue import Empty as QueueEmpty
+from typing import Any, Dict, Iterator, List, Optional, Tuple
+
+import numpy as np
+import scipp as sc
+
+from .._utils import get_attrs
+from ._serialisation import (
+    BinnedDataChunk,
+    convert_from_pickleable_dict,
+    convert_to_pickleable_dict,
+)
+
+# Every array in a slot starts at a multiple of this many bytes
+_ALIGNMENT = 8
+
+
+def _aligned(n_bytes: int) -> int:
+    return -(-n_bytes // _ALIGNMENT) * _ALIGNMENT
+
+
+@dataclass(frozen=True)
+class ColumnDescriptor:
+    name: str
+    dtype: str
+    unit: Optional[str]
+    offset: int  # in bytes from the start of the slot
+    variances_offset: Optional[int] = None
+
+
+@dataclass(frozen=True)
+class SharedMemoryChunk:
+    """
+    Describes a chunk of event data which has been written to a slot of
+    a SharedMemoryRing. This is what is put on the data queue.
+    """
+
+    slot: int
+    size: int  # number of events
+    data: ColumnDescriptor
+    coords: Tuple[ColumnDescriptor, ...]
+    # Pickleable dict of a DataArray with no events but with all the attrs
+    metadata: Dict
+
+
+def _unit_to_str(unit: Optional[sc.Unit]) -> Optional[str]:
+    return None if unit is None else str(unit)
+
+
+def _columns(data: sc.DataArray) -> Iterator[Tuple[str, sc.Variable]]:
+    yield 'data', data.data
+    yield from data.coords.items()
+
+
+def chunk_nbytes(data: sc.DataArray) -> int:
+    """
+    Number of bytes required to hold the event columns of data in a slot
+    """
+    n_bytes = 0
+    for _, column in _columns(data):
+        n_bytes += _aligned(column.values.nbytes)
+        if column.variances is not None:
+            n_bytes += _aligned(column.variances.nbytes)
+    return n_bytes
+
+
+class SharedMemoryRing:
+    """
+    A fixed number of equally sized shared memory slots.
+
+    The ring is created in the process which reads the data, and passed
+    as an argument to the process which writes the data.
+    The indices of slots which are free to be written to are kept in an
+    mp.Queue, the reader puts a slot back on it once it has read the data.
+    """
+
+    def __init__(self, slot_names: List[str], slot_nbytes: int, free_slots: mp.Queue):
+        self._slot_names = slot_names
+        self._slot_nbytes = slot_nbytes
+        self._free_slots = free_slots
+        self._segments: Dict[int, SharedMemory] = {}
+        self._owner = False
+
+    @classmethod
+    def create(cls, n_slots: int, slot_nbytes: int, ctx) -> "SharedMemoryRing":
+        """
+        Allocate the shared memory for a new ring. Only the creator of the
+        ring unlinks the shared memory on close().
+
+        :param n_slots: Number of slots in the ring
+        :param slot_nbytes: Size of each slot in bytes
+        :param ctx: multiprocessing context to create the free slot queue with
+        """
+        segments = [
+            SharedMemory(create=True, size=slot_nbytes) for _ in range(n_slots)
+        ]
+        free_slots = ctx.Queue()
+        for slot in range(n_slots):
+            free_slots.put(slot)
+        ring = cls([segment.name for segment in segments], slot_nbytes, free_slots)
+        ring._segments = dict(enumerate(segments))
+        ring._owner = True
+        return ring
+
+    def __getstate__(self):
+        # Shared memory is attached by name in the receiving process
+        state = self.__dict__.copy()
+        state['_segments'] = {}
+        state['_owner'] = False
+        return state
+
+    @property
+    def slot_nbytes(self) -> int:
+        return self._slot_nbytes
+
+    @property
+    def free_slots(self) -> mp.Queue:
+        return self._free_slots
+
+    def _segment(self, slot: int) -> SharedMemory:
+        if slot not in self._segments:
+            self._segments[slot] = SharedMemory(name=self._slot_names[slot])
+        return self._segments[slot]
+
+    def _view(self, slot: int, dtype: str, size: int, offset: int) -> np.ndarray:
+        return np.ndarray(
+            shape=(size,), dtype=dtype, buffer=self._segment(slot).buf, offset=offset
+        )
+
+    def write(self, data: sc.DataArray) -> Optional[SharedMemoryChunk]:
+        """
+        Copy the 1D event data into a free slot.
+
+        Returns None if the data are not 1D events, if they do not fit
+        in a slot or if no slot is free,
+        in which case the caller should fall back to pickling the data.
+        """
+        if data.dims != ('event',) or chunk_nbytes(data) > self._slot_nbytes:
+            return None
+        try:
+            slot = self._free_slots.get_nowait()
+        except QueueEmpty:
+            return None
+
+        size = data.sizes['event']
+        offset = 0
+        columns = []
+        for name, column in _columns(data):
+            values = column.values
+            self._view(slot, values.dtype.str, size, offset)[...] = values
+            values_offset = offset
+            offset += _aligned(values.nbytes)
+            variances_offset = None
+            if column.variances is not None:
+                self._view(slot, values.dtype.str, size, offset)[
+                    ...
+                ] = column.variances
+                variances_offset = offset
+                offset += _aligned(values.nbytes)
+            columns.append(
+                ColumnDescriptor(
+                    name=name,
+                    dtype=values.dtype.str,
+                    unit=_unit_to_str(column.unit),
+                    offset=values_offset,
+                    variances_offset=variances_offset,
+                )
+            )
+
+        return SharedMemoryChunk(
+            slot=slot,
+            size=size,
+            data=columns[0],
+            coords=tuple(columns[1:]),
+            metadata=convert_to_pickleable_dict(data['event', 0:0].copy()),
+        )
+
+    def _read_column(self, chunk: SharedMemoryChunk, column: ColumnDescriptor):
+        values = self._view(chunk.slot, column.dtype, chunk.size, column.offset)
+        variances = None
+        if column.variances_offset is not None:
+            variances = self._view(
+                chunk.slot, column.dtype, chunk.size, column.variances_offset
+            )
+        # sc.array copies out of the slot, so it is safe to release it afterwards
+        return sc.array(
+            dims=['event'], values=values, variances=variances, unit=column.unit
+        )
+
+    def read(self, chunk: SharedMemoryChunk) -> sc.DataArray:
+        """
+        Copy the event data described by chunk out of its slot and release
+        the slot to be written to again.
+        """
+        try:
+            data = convert_from_pickleable_dict(chunk.metadata)
+            return sc.DataArray(
+                self._read_column(chunk, chunk.data),
+                coords={
+                    column.name: self._read_column(chunk, column)
+                    for column in chunk.coords
+                },
+                attrs=dict(get_attrs(data).items()),
+            )
+        finally:
+            self._free_slots.put(chunk.slot)
+
+    def close(self):
+        for segment in self._segments.values():
+            segment.close()
+            if self._owner:
+                segment.unlink()
+        self._segments = {}
+
+
+def serialise_data_chunk(
+    data: sc.DataArray, shared_memory: Optional[SharedMemoryRing] = None
+) -> Any:
+    """
+    Convert a chunk of data to the form which is put on the data queue,
+    copying event data into shared_memory if it is given and has a free slot
+    """
+    if data.bins is not None:
+        return BinnedDataChunk.from_data_array(
+            data, lambda events: serialise_data_chunk(events, shared_memory)
+        )
+    if shared_memory is not None:
+        chunk = shared_memory.write(data)
+        if chunk is not None:
+            return chunk
+    # Shared memory is not used or is full, fall back to pickling
+    return convert_to_pickleable_dict(data)
+
+
+def deserialise_data_chunk(
+    chunk: Any, shared_memory: Optional[SharedMemoryRing] = None
+) -> sc.DataArray:
+    """
+    Inverse of serialise_data_chunk
+    """
+    if isinstance(chunk, BinnedDataChunk):
+        return chunk.to_data_array(deserialise_data_chunk(chunk.events, shared_memory))
+    if isinstance(chunk, SharedMemoryChunk):
+        return shared_memory.read(chunk)
+    return convert_from_pickleable_dict(chunk)
@@ -0,0 +1,176 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
+"""
+Incremental reduction of the chunks yielded by data_stream.
+"""
+
+import collections
+from typing import (
+    AsyncIterable,
+    AsyncIterator,
+    Callable,
+    Deque,
+    Dict,
+    Iterable,
+    Iterator,
+    Mapping,
+    Optional,
+    Tuple,
+    Union,
+)
+
+import numpy as np
+import scipp as sc
+
+from ..tof import unwrap
+from ..tof.unwrap_plan import UnwrapPlan
+
+Graph = Dict[Union[str, Tuple[str, ...]], Callable]
+
+
+def _events(chunk: sc.DataArray) -> sc.DataArray:
+    return chunk if chunk.bins is None else chunk.bins.constituents['data']
+
+
+def _latest_pulse_time(chunk: sc.DataArray) -> Optional[int]:
+    """Latest pulse time of the events of a chunk in ns, None if there are none"""
+    events = _events(chunk)
+    for name in ('pulse_time', 'event_time_zero'):
+        if name in events.coords and events.coords[name].size > 0:
+            latest = events.coords[name].max().to(unit='ns', copy=False).value
+            return int(np.asarray(latest).astype(np.int64))
+    return None
+
+
+class StreamAccumulator:
+    """
+    Accumulate histograms of the events of a data stream, chunk by chunk.
+
+    Each chunk is reduced on its own and its histogram is added to the running total,
+    so the cost of an update depends on the size of the chunk, not on the length of
+    the run so far. Chunks are event tables or events binned by detector id,
+    as yielded by :py:func:`scippneutron.data_stream` without ``tof_bins``.
+
+    The reduction of a chunk consists of
+
+    1. applying an unwrap plan to compute time-of-flight from the streamed
+       time offsets and pulse times, if given,
+    2. adding the given coords, e.g., the positions of the detector pixels,
+    3. computing the coords to histogram in with a conversion graph,
+       e.g., from :py:func:`scippneutron.conversion_graph`, and
+    4. histogramming the events.
+
+    With a window, the histogram of each chunk is kept until all its pulses are
+    older than the window before the latest pulse, and is then subtracted from the
+    total. The window thus has the granularity of the chunks.
+
+    :param bins: Bin edges to histogram the events in, by coord name.
+    :param graph: Conversion graph for computing the coords of the bins.
+      Use a graph with a :py:class:`scippneutron.GeometryCache` to avoid
+      recomputing beamline quantities for every chunk.
+    :param coords: Coords to add to each chunk before the conversion.
+    :param unwrap_plan: Applied to each chunk before the conversion,
+      its 'tof' output can be used as the input of the graph.
+    :param window: Length of the sliding window in pulse time,
+      None to accumulate the whole run.
+    """
+
+    def __init__(
+        self,
+        bins: Mapping[str, sc.Variable],
+        *,
+        graph: Optional[Graph] = None,
+        coords: Optional[Mapping[str, sc.Variable]] = None,
+        unwrap_plan: Optional[UnwrapPlan] = None,
+        window: Optional[sc.Variable] = None,
+    ):
+        self._bins = dict(bins)
+        self._graph = graph
+        self._coords = dict(coords or {})
+        self._unwrap_plan = unwrap_plan
+        self._window_ns = (
+            None
+            if window is None
+            else int(window.to(unit='ns', dtype='int64', copy=False).value)
+        )
+        self._total: Optional[sc.DataArray] = None
+        # Histograms of the chunks with pulses in the window, by their latest pulse
+        self._in_window: Deque[Tuple[int, sc.DataArray]] = collections.deque()
+        self._latest_ns: Optional[int] = None
+
+    @property
+    def value(self) -> Optional[sc.DataArray]:
+        """The accumulated histogram, None if no events have been added."""
+        return None if self._total is None else self._total.copy()
+
+    def clear(self) -> None:
+        """Drop all accumulated events."""
+        self._total = None
+        self._in_window.clear()
+        self._latest_ns = None
+
+    def _reduce(self, chunk: sc.DataArray) -> sc.DataArray:
+        if self._unwrap_plan is not None:
+            chunk = unwrap.unwrap_stream_chunk(chunk, self._unwrap_plan.apply)
+        else:
+            chunk = chunk.copy(deep=False)
+        for name, coord in self._coords.items():
+            chunk.coords[name] = coord
+        targets = [name for name in self._bins if name not in _events(chunk).coords]
+        if targets:
+            chunk = chunk.transform_coords(
+                targets, graph=self._graph, keep_intermediate=False
+            )
+        return chunk.hist(self._bins)
+
+    def add(self, chunk: sc.DataArray) -> Optional[sc.DataArray]:
+        """
+        Add the events of a chunk and return the updated histogram.
+
+        :param chunk: Events as yielded by :py:func:`scippneutron.data_stream`.
+        :return: The accumulated histogram, see :py:attr:`value`.
+        """
+        if chunk.bins is None and 'event' not in chunk.dims:
+            raise ValueError(
+                "Histogrammed chunks cannot be accumulated, "
+                "stream events without tof_bins instead."
+            )
+        latest_ns = _latest_pulse_time(chunk)
+        if latest_ns is None:
+            return self.value
+        histogram = self._reduce(chunk)
+        if self._total is None:
+            self._total = histogram.copy()
+        else:
+            self._total.data += histogram.data
+        if self._window_ns is not None:
+            self._in_window.append((latest_ns, histogram))
+            if self._latest_ns is None or latest_ns > self._latest_ns:
+                self._latest_ns = latest_ns
+            self._expire()
+        return self.value
+
+    def _expire(self) -> None:
+        window_start = self._latest_ns - self._window_ns
+        while self._in_window and self._in_window[0][0] < window_start:
+            _, histogram = self._in_window.popleft()
+            self._total.data -= histogram.data
+
+    def accumulate(
+        self, chunks: Union[Iterable[sc.DataArray], AsyncIterable[sc.DataArray]]
+    ) -> Union[Iterator[sc.DataArray], AsyncIterator[sc.DataArray]]:
+        """
+        Add each chunk and yield the updated histogram.
+
+        Returns an asynchronous generator if chunks is asynchronous,
+        e.g., when iterating over :py:func:`scippneutron.data_stream` directly.
+        """
+        if hasattr(chunks, '__aiter__'):
+            return self._accumulate_async(chunks)
+        return (self.add(chunk) for chunk in chunks)
+
+    async def _accumulate_async(
+        self, chunks: AsyncIterable[sc.DataArray]
+    ) -> AsyncIterator[sc.DataArray]:
+        async for chunk in chunks:
+            yield self.add(chunk)
@@ -5,16 +5,18 @@ import multiprocessing as mp
 import time
 from enum import Enum
 from queue import Empty as QueueEmpty
-from typing import Generator, List, Optional
+from typing import Any, Generator, Iterator, List, Optional, Union
 from warnings import warn
 
 import numpy as np
 import scipp as sc
 
+from ..io.nexus._json_nexus import StreamInfo
 from ..io.nexus.load_nexus import load_nexus_json_str
 from ._consumer_type import ConsumerType
 from ._data_stream_widget import DataStreamWidget
-from ._serialisation import convert_from_pickleable_dict
+from ._metrics import StreamingStats
+from ._shared_memory import SharedMemoryRing, deserialise_data_chunk
 from ._stop_time import StopTimeUpdate
 
 
@@ -28,6 +30,10 @@ class StopTime(Enum):
     END_OF_RUN = "end_of_run"
 
 
+class DetectorIds(Enum):
+    FROM_RUN_START = "from_run_start"
+
+
 _missing_dependency_message = (
     "Confluent Kafka Python library and/or serialisation library"
     "not found, please install confluent-kafka and "
@@ -48,16 +54,25 @@ async def data_stream(
     run_info_topic: Optional[str] = None,
     start_time: StartTime = StartTime.NOW,
     stop_time: StopTime = StopTime.NEVER,
+    shared_memory_slots: int = 0,
+    detector_ids: Union[None, sc.Variable, DetectorIds] = None,
+    tof_bins: Optional[sc.Variable] = None,
+    event_buffer_memory_limit: int = 536_870_912,
+    max_queued_chunks: int = 16,
+    consumer_processes: int = 1,
+    compact_events: bool = False,
 ) -> Generator[sc.DataArray, None, None]:
     """
     Periodically yields accumulated data from stream.
     If the buffer fills up more frequently than the set interval
     then data is yielded more frequently.
-    1048576 event buffer is around 24 MB (with pulse_time, id, weights, etc)
+    1048576 event buffer is around 8 MB (tof and id, pulse times are
+    stored per message) and 32 MB once emitted with pulse_time and weights,
+    20 MB with compact_events
     :param kafka_broker: Address of the Kafka broker to stream data from
     :param topics: Kafka topics to consume data from (not required if
       run_info_topic is used)
-    :param event_buffer_size: Size of buffer to accumulate event data in
+    :param event_buffer_size: Initial size of buffers to accumulate event data in
     :param slow_metadata_buffer_size: Size of buffer to accumulate slow
       sample env metadata in
     :param fast_metadata_buffer_size: Size of buffer to accumulate fast
@@ -72,6 +87,28 @@ async def data_stream(
       in the run start message
     :param start_time: Get data from now or from start of the last run
     :param stop_time: Stop data_stream at end of run, or not
+    :param shared_memory_slots: Number of shared memory slots, each large
+      enough for a full event buffer, used to transport event data from the
+      data consumption process. If 0 (default) data are pickled instead.
+    :param detector_ids: If provided, events are yielded grouped by detector
+      id, with one bin for each of these ids, instead of as a flat list of
+      events. Use DetectorIds.FROM_RUN_START to take the detector ids of
+      the detectors in the run start message.
+    :param tof_bins: Bin edges in time-of-flight, if provided together with
+      detector_ids, events are histogrammed into these bins for each
+      detector instead of being yielded.
+    :param event_buffer_memory_limit: Maximum number of bytes the event
+      buffers may grow to, must allow for two buffers of `event_buffer_size`
+      events, that is 16 bytes per event
+    :param max_queued_chunks: Maximum number of chunks which are waiting
+      to be yielded, before consuming data is paused
+    :param consumer_processes: Number of processes to consume data in, the
+      topic partitions are shared out between them. Use more than 1 if a
+      single process cannot keep up with the data rate.
+    :param compact_events: If True, events are yielded with implicit unit
+      weights, float32 ones without variances, which need 4 rather than 16
+      bytes per event, see :py:func:`scippneutron.compact_events`.
+      Histograms of such events have no variances.
     """
     """
     Additional info:
@@ -79,9 +116,26 @@ async def data_stream(
     - Instead, prefer the use of `run_info_topic` where it is possible to go
       and find the last run_start message and use that to get info on what
       topics to listen to.
-    - Buffer sizes: it is currently not easy to resize scipp data structures,
-      so we choose sensible default buffer sizes. This may need to be tweaked
-      in the future.
+    - Buffer sizes: events are double-buffered so that consumers do not
+      wait for the buffer to be emitted, so initially twice
+      `event_buffer_size` events are allocated. Event buffers grow, up to
+      `event_buffer_memory_limit`, to fit large messages and the number of
+      events which arrive per `interval`. Metadata buffers have fixed sizes.
+    - Back-pressure: if the event buffers reach their memory limit, or
+      `max_queued_chunks` chunks have not been consumed from the generator
+      yet, consuming from Kafka is paused until there is space again.
+      Data are not dropped, unless a single message exceeds the limit.
+    - Consumer processes: with `consumer_processes > 1` each process has its
+      own buffers, of the sizes given above. Another process merges their
+      data into one chunk per `interval`, which adds up to one `interval`
+      of latency.
+    - Shared memory: with `shared_memory_slots > 0` only a small descriptor
+      of each chunk of events is sent via the queue. If all slots are still
+      in use, because chunks have not been consumed from the generator yet,
+      the chunk is pickled as usual.
+    - Detector ids: grouping by detector id is done in the data consumption
+      process. Events with a detector id which is not in `detector_ids` are
+      dropped.
     - `start_time`: it is possible to go back to the start of the run, even if
       `data_stream()` is started after or during the run. It simply finds the
       start time in the last run_start message. The data can persist on Kafka
@@ -94,9 +148,17 @@ async def data_stream(
         fast_metadata_buffer_size,
         slow_metadata_buffer_size,
     )
+    if shared_memory_slots < 0:
+        raise ValueError("shared_memory_slots must not be negative")
+    if tof_bins is not None and detector_ids is None:
+        raise ValueError("tof_bins can only be used together with detector_ids")
+    if max_queued_chunks < 1:
+        raise ValueError("max_queued_chunks must be at least 1")
+    if consumer_processes < 1:
+        raise ValueError("consumer_processes must be at least 1")
 
     ctx = mp.get_context("spawn")
-    data_queue = ctx.Queue()
+    data_queue = ctx.Queue(maxsize=max_queued_chunks)
     instruction_queue = ctx.Queue()
 
     # Use "async for" as "yield from" cannot be used in an async function, see
@@ -114,6 +176,12 @@ async def data_stream(
         run_info_topic,
         start_time,
         stop_time,
+        shared_memory_slots=shared_memory_slots,
+        detector_ids=detector_ids,
+        tof_bins=tof_bins,
+        event_buffer_memory_limit=event_buffer_memory_limit,
+        consumer_processes=consumer_processes,
+        compact_events=compact_events,
     ):  # noqa: E125
         yield data_chunk
 
@@ -141,6 +209,46 @@ def _cleanup_queue(queue: Optional[mp.Queue]):
         queue.join_thread()
 
 
+def _drain_queue(
+    queue: mp.Queue, processes: List[mp.Process], timeout_s: float
+) -> Iterator[Any]:
+    """
+    Get items from queue until all processes have exited and the queue is empty.
+
+    Processes which put items into a bounded queue block while it is full, so they
+    only exit while the queue is being drained. Gives up after timeout_s, not
+    counting the time the caller spends on the items.
+    """
+    deadline = time.monotonic() + timeout_s
+    while time.monotonic() < deadline:
+        try:
+            item = queue.get(timeout=0.1)
+        except QueueEmpty:
+            if not any(process.is_alive() for process in processes):
+                return
+            continue
+        yielded_at = time.monotonic()
+        yield item
+        deadline += time.monotonic() - yielded_at
+
+
+def _detector_id_values(
+    detector_ids: Union[None, sc.Variable, DetectorIds],
+    loaded_data: Optional[sc.DataArray],
+) -> Optional[np.ndarray]:
+    if detector_ids is None:
+        return None
+    if isinstance(detector_ids, DetectorIds):
+        if loaded_data is None or 'detector_id' not in loaded_data.coords:
+            raise ValueError(
+                "Detector ids can only be taken from the run start message if "
+                "run_info_topic is specified and the run start message "
+                "contains detectors"
+            )
+        detector_ids = loaded_data.coords['detector_id']
+    return detector_ids.values.astype(np.int64)
+
+
 async def _data_stream(
     data_queue: mp.Queue,
     worker_instruction_queue: mp.Queue,
@@ -160,6 +268,13 @@ async def _data_stream(
     halt_after_n_warnings: int = np.iinfo(np.int32).max,  # noqa: B008
     test_message_queue: Optional[mp.Queue] = None,  # for tests
     timeout: Optional[sc.Variable] = None,  # for tests
+    stream_info: Optional[List[StreamInfo]] = None,  # for tests
+    shared_memory_slots: int = 0,
+    detector_ids: Union[None, sc.Variable, DetectorIds] = None,
+    tof_bins: Optional[sc.Variable] = None,
+    event_buffer_memory_limit: Optional[int] = None,
+    consumer_processes: int = 1,
+    compact_events: bool = False,
 ) -> Generator[sc.DataArray, None, None]:
     """
     Main implementation of data stream is extracted to this function so that
@@ -169,10 +284,12 @@ async def _data_stream(
     # Search backwards to find the last run_start message
     try:
         from ._consumer import KafkaQueryConsumer, get_run_start_message
+        from ._data_buffer import event_buffer_memory, event_buffer_nbytes
         from ._data_consumption_manager import (
             InstructionType,
             ManagerInstruction,
             data_consumption_manager,
+            shard_merger,
         )
     except ImportError:
         raise ImportError(_missing_dependency_message)
@@ -181,6 +298,13 @@ async def _data_stream(
         raise ValueError(
             "At least one of 'topics' and 'run_info_topic'" " must be specified"
         )
+    if event_buffer_memory_limit is not None and event_buffer_memory_limit < (
+        event_buffer_memory(event_buffer_size)
+    ):
+        raise ValueError(
+            "event_buffer_memory_limit must allow for two buffers of "
+            "event_buffer_size events"
+        )
 
     # This is defaulted to None in the function signature
     # to avoid it having to be imported earlier
@@ -201,7 +325,8 @@ async def _data_stream(
     #   moved
     # - metadata (e.g. sample environment) might be empty, if values have not
     #   changed
-    stream_info = None
+    # Without a run start message, stream_info may be given directly.
+    loaded_data = None
     run_id = ""
     run_title = "-"  # for display in widget
     stop_time_ms = None
@@ -236,6 +361,20 @@ async def _data_stream(
     # (sc.Variable would have to be serialised/deserialised)
     start_time_ms = int(sc.to_unit(start_time, "milliseconds").value)
     interval_s = float(sc.to_unit(interval, 's').value)
+    detector_id_values = _detector_id_values(detector_ids, loaded_data)
+    tof_bin_edges_ns = (
+        None
+        if tof_bins is None
+        else sc.to_unit(tof_bins, 'ns').values.astype(np.float64)
+    )
+
+    shared_memory = None
+    if shared_memory_slots > 0:
+        shared_memory = SharedMemoryRing.create(
+            shared_memory_slots,
+            event_buffer_nbytes(event_buffer_size, compact_events),
+            mp.get_context("spawn"),
+        )
 
     # Specify to start the process using the "spawn" method, otherwise
     # on Linux the default is to fork the Python interpreter which
@@ -249,31 +388,86 @@ async def _data_stream(
     # Note also that daemonising this Process is important so that resources are
     # properly freed when restarting the notebook kernel (or shutting down the
     # notebook entirely).
-    data_collect_process = mp.get_context("spawn").Process(
-        target=data_consumption_manager,
-        args=(
-            start_time_ms,
-            stop_time_ms,
-            run_id,
-            topics,
-            kafka_broker,
-            consumer_type,
-            stream_info,
-            interval_s,
-            event_buffer_size,
-            slow_metadata_buffer_size,
-            fast_metadata_buffer_size,
-            chopper_buffer_size,
-            worker_instruction_queue,
-            data_queue,
-            test_message_queue,
-        ),
-        daemon=True,
-    )
+    spawn_ctx = mp.get_context("spawn")
+
+    def consumption_manager_process(
+        instruction_queue: mp.Queue,
+        output_queue: mp.Queue,
+        output_shared_memory: Optional[SharedMemoryRing],
+        shard_index: int = 0,
+        n_shards: int = 1,
+    ):
+        return spawn_ctx.Process(
+            target=data_consumption_manager,
+            args=(
+                start_time_ms,
+                stop_time_ms,
+                run_id,
+                topics,
+                kafka_broker,
+                consumer_type,
+                stream_info,
+                interval_s,
+                event_buffer_size,
+                slow_metadata_buffer_size,
+                fast_metadata_buffer_size,
+                chopper_buffer_size,
+                instruction_queue,
+                output_queue,
+                test_message_queue,
+                output_shared_memory,
+                detector_id_values,
+                tof_bin_edges_ns,
+                event_buffer_memory_limit,
+                shard_index,
+                n_shards,
+                compact_events,
+            ),
+            daemon=True,
+        )
+
+    shard_processes = []
+    shard_queues = []
+    if consumer_processes == 1:
+        data_collect_process = consumption_manager_process(
+            worker_instruction_queue, data_queue, shared_memory
+        )
+    else:
+        # Each shard process consumes a subset of the partitions into its own
+        # buffer, the merger process combines their data per emit interval.
+        # Daemonic processes cannot start processes, so all are started here.
+        shard_data_queue = spawn_ctx.Queue(maxsize=2 * consumer_processes)
+        shard_instruction_queues = [
+            spawn_ctx.Queue() for _ in range(consumer_processes)
+        ]
+        shard_processes = [
+            consumption_manager_process(
+                instruction_queue, shard_data_queue, None, shard, consumer_processes
+            )
+            for shard, instruction_queue in enumerate(shard_instruction_queues)
+        ]
+        data_collect_process = spawn_ctx.Process(
+            target=shard_merger,
+            args=(
+                interval_s,
+                worker_instruction_queue,
+                shard_instruction_queues,
+                shard_data_queue,
+                data_queue,
+                shared_memory,
+            ),
+            daemon=True,
+        )
+        shard_queues = [shard_data_queue, *shard_instruction_queues]
+    processes = [data_collect_process, *shard_processes]
+    process_halt_timeout_s = 4.0
+    stop_sent = False
     try:
         data_stream_widget = DataStreamWidget(
             start_time_ms=start_time_ms, stop_time_ms=stop_time_ms, run_title=run_title
         )
+        for shard_process in shard_processes:
+            shard_process.start()
         data_collect_process.start()
 
         # When testing, if something goes wrong, the while loop below can
@@ -299,6 +493,9 @@ async def _data_stream(
                     warn(new_data)
                     n_warnings += 1
                     continue
+                elif isinstance(new_data, StreamingStats):
+                    data_stream_widget.set_stats(new_data)
+                    continue
                 elif isinstance(new_data, StopTimeUpdate):
                     data_stream_widget.set_stop_time(new_data.stop_time_ms)
                     if end_at == StopTime.END_OF_RUN:
@@ -309,17 +506,45 @@ async def _data_stream(
                         )
                     continue
                 n_data_chunks += 1
-                yield convert_from_pickleable_dict(new_data)
+                yield deserialise_data_chunk(new_data, shared_memory)
             except QueueEmpty:
                 await asyncio.sleep(0.5 * interval_s)
+
+        if n_data_chunks < halt_after_n_data_chunks and (
+            n_warnings < halt_after_n_warnings
+        ):
+            # The stream was stopped or has ended, yield the data which were
+            # flushed from the buffers while the processes stop
+            worker_instruction_queue.put(ManagerInstruction(InstructionType.STOP_NOW))
+            stop_sent = True
+            for new_data in _drain_queue(
+                data_queue, processes, process_halt_timeout_s
+            ):
+                if isinstance(new_data, Warning):
+                    warn(new_data)
+                elif isinstance(new_data, StreamingStats):
+                    data_stream_widget.set_stats(new_data)
+                elif not isinstance(new_data, StopTimeUpdate):
+                    yield deserialise_data_chunk(new_data, shared_memory)
     finally:
         # Ensure cleanup happens however the loop exits
-        worker_instruction_queue.put(ManagerInstruction(InstructionType.STOP_NOW))
-        if data_collect_process.is_alive():
-            process_halt_timeout_s = 4.0
-            data_collect_process.join(process_halt_timeout_s)
-        if data_collect_process.is_alive():
-            data_collect_process.terminate()
-        for queue in (data_queue, worker_instruction_queue, test_message_queue):
+        if not stop_sent:
+            worker_instruction_queue.put(ManagerInstruction(InstructionType.STOP_NOW))
+        # Processes blocked in putting data into the full queue would not exit
+        # otherwise, the data are discarded as nothing consumes them anymore
+        for _ in _drain_queue(data_queue, processes, process_halt_timeout_s):
+            pass
+        for process in processes:
+            if process.is_alive():
+                process.terminate()
+        for queue in (
+            data_queue,
+            worker_instruction_queue,
+            test_message_queue,
+            *shard_queues,
+        ):
             _cleanup_queue(queue)
+        if shared_memory is not None:
+            _cleanup_queue(shared_memory.free_slots)
+            shared_memory.close()
         data_stream_widget.set_stopped()
@@ -2,17 +2,15 @@
 # Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
 # @author Neil Vaytet and Owen Arnold
 
+from functools import partial
+
 import numpy as np
 import scipp as sc
-from scipy.spatial.transform import Rotation as Rot
 
 from ._utils import get_meta
 
-try:
-    import pythreejs as p3
-except ImportError as ex:
-    p3 = None
-    _pythreejs_import_error = ex
+# pythreejs is imported by instrument_view, importing it takes long
+p3 = None
 
 
 def _create_text_sprite(position, bounding_box, display_text):
@@ -69,6 +67,8 @@ def _find_beam(det_com, pos):
 
 
 def _alignment_matrix(to_align, target):
+    from scipy.spatial.transform import Rotation as Rot
+
     rot_axis = np.cross(to_align, target)
     magnitude = np.linalg.norm(to_align) * np.linalg.norm(target)
     axis_angle = np.arcsin(rot_axis / magnitude)
@@ -200,6 +200,103 @@ def _plot_components(scipp_obj, components, positions_var, scene):
         camera.far = max(camera.far, furthest_distance * 5.0)
 
 
+class PixelAggregation:
+    """Aggregation of detector pixels into voxels of a regular grid.
+
+    The grid is refined like an octree, halving the voxel size until refining
+    once more would give more than ``max_points`` occupied voxels.
+    Pixels of a voxel are thus shown as a single point at their mean position,
+    which keeps 3D views of detectors with millions of pixels responsive.
+
+    The assignment of pixels to voxels is computed once, so that aggregating new
+    values, e.g., of each chunk of :func:`scippneutron.data_stream`, only
+    sums the values. :func:`scippneutron.instrument_view` does so when given
+    a :class:`plopp.Node`.
+
+    Parameters
+    ----------
+    positions:
+        Positions of the pixels.
+    max_points:
+        Maximum number of voxels, i.e., of points to show.
+
+    Attributes
+    ----------
+    positions:
+        Mean position of the pixels of each voxel.
+    voxel_size:
+        Edge length of the voxels in the unit of the positions.
+    """
+
+    def __init__(self, positions: sc.Variable, *, max_points: int):
+        if max_points < 1:
+            raise ValueError(f'max_points must be at least 1, got {max_points}')
+        self._sizes = positions.sizes
+        self._dim = positions.dim if positions.ndim == 1 else 'pixel'
+        pos = positions.values.reshape(-1, 3)
+        low = pos.min(axis=0)
+        # Voxels are cubes, the grid spans the bounding cube of the pixels
+        extent = float((pos.max(axis=0) - low).max()) or 1.0
+        n_per_axis = 1
+        voxel = np.zeros(len(pos), dtype=np.int64)
+        n_voxels = 1
+        while n_per_axis < 2**20 and n_voxels < len(pos):
+            finer, n_finer = _voxel_index(pos, low, extent, 2 * n_per_axis)
+            if n_finer > max_points:
+                break
+            n_per_axis, voxel, n_voxels = 2 * n_per_axis, finer, n_finer
+        counts = np.bincount(voxel, minlength=n_voxels)
+        center = np.stack(
+            [np.bincount(voxel, weights=pos[:, i]) / counts for i in range(3)],
+            axis=1,
+        )
+        self.positions = sc.vectors(dims=['voxel'], values=center, unit=positions.unit)
+        self.voxel_size = extent / n_per_axis
+        self._voxel = sc.array(dims=[self._dim], values=voxel, unit=None)
+
+    def __call__(self, da: sc.DataArray, *, name: str = 'position') -> sc.DataArray:
+        """Sum the values of the pixels of each voxel.
+
+        Parameters
+        ----------
+        da:
+            Data with the dims of the positions, and optionally others.
+        name:
+            Name of the coord of the voxel positions.
+
+        Returns
+        -------
+        :
+            Data with dim ``'voxel'`` in place of the dims of the positions.
+        """
+        dims = list(self._sizes)
+        if len(dims) > 1:
+            other = [dim for dim in da.dims if dim not in dims]
+            da = da.transpose(dims + other).copy().flatten(dims=dims, to=self._dim)
+        coords = {
+            key: coord
+            for key, coord in da.coords.items()
+            if self._dim not in coord.dims
+        }
+        coords['voxel'] = self._voxel
+        aggregated = (
+            sc.DataArray(da.data, coords=coords, masks=dict(da.masks))
+            .groupby('voxel')
+            .sum(self._dim)
+        )
+        aggregated.coords[name] = self.positions
+        return aggregated
+
+
+def _voxel_index(pos, low, extent, n_per_axis):
+    index = np.minimum(
+        ((pos - low) / extent * n_per_axis).astype(np.int64), n_per_axis - 1
+    )
+    flat = (index[:, 0] * n_per_axis + index[:, 1]) * n_per_axis + index[:, 2]
+    unique, voxel = np.unique(flat, return_inverse=True)
+    return voxel.reshape(-1), len(unique)
+
+
 def _get_camera(scene):
     for child in scene.children:
         if isinstance(child, p3.PerspectiveCamera):
@@ -208,7 +305,12 @@ def _get_camera(scene):
 
 
 def instrument_view(
-    scipp_obj, positions="position", pixel_size=None, components=None, **kwargs
+    scipp_obj,
+    positions="position",
+    pixel_size=None,
+    components=None,
+    max_points=None,
+    **kwargs,
 ):
     """Plot a 3D view of the instrument, using the `position` coordinate as the
     detector vector positions.
@@ -223,6 +325,12 @@ def instrument_view(
     The aspect ratio of the positions is preserved by default, but this can
     be changed to automatic scaling using `aspect="equal"`.
 
+    If `scipp_obj` is a :class:`plopp.Node`, the view follows its updates,
+    e.g., with new values of each chunk of a data stream.
+    Only the values of the points are updated, the scene, the components,
+    and the aggregation of pixels into voxels are kept.
+    The pixel positions must therefore stay the same.
+
     `components` dictionary uses the key as the name to display the component.
     This can be any desired name, it does not have to relate to the input
     `scipp_obj` naming.
@@ -246,7 +354,7 @@ def instrument_view(
     Parameters
     ----------
     scipp_obj:
-        Scipp object holding geometries.
+        Scipp object holding geometries, or a plopp node providing it.
     positions:
         Key for coord/attr holding positions to use for pixels.
     pixel_size:
@@ -254,6 +362,10 @@ def instrument_view(
     components:
         Dictionary containing display names and corresponding settings
         (also a Dictionary) for additional components to display.
+    max_points:
+        If given and there are more pixels, pixels are summed into at most this
+        many voxels, see :class:`scippneutron.PixelAggregation`.
+        The default pixel size is then the size of the voxels.
     kwargs:
         Additional keyword arguments to pass to :func:`plopp.scatter3d`.
 
@@ -262,22 +374,31 @@ def instrument_view(
     :
         The 3D plot object
     """
-    if not p3:
-        raise _pythreejs_import_error
-
+    global p3
+    if p3 is None:
+        import pythreejs as p3
     import plopp as pp
 
-    positions_var = get_meta(scipp_obj)[positions]
+    data_node = scipp_obj if isinstance(scipp_obj, pp.Node) else pp.Node(scipp_obj)
+    view_node = data_node
+    positions_var = get_meta(data_node())[positions]
+    if max_points is not None and positions_var.size > max_points:
+        aggregation = PixelAggregation(positions_var, max_points=max_points)
+        # Updates of data_node only sum the new values per voxel
+        view_node = pp.Node(partial(aggregation, name=positions), data_node)
+        positions_var = aggregation.positions
+        if pixel_size is None:
+            pixel_size = aggregation.voxel_size
     if pixel_size is None:
         pos_array = positions_var.values
         if len(pos_array) > 1:
             pixel_size = np.linalg.norm(pos_array[1] - pos_array[0])
 
-    fig = pp.scatter3d(scipp_obj, pos=positions, pixel_size=pixel_size, **kwargs)
+    fig = pp.scatter3d(view_node, pos=positions, pixel_size=pixel_size, **kwargs)
     scene = fig.children[0].canvas.scene
 
     # Add additional components from the beamline
     if components:
-        _plot_components(scipp_obj, components, positions_var, scene)
+        _plot_components(view_node(), components, positions_var, scene)
 
     return fig
@@ -0,0 +1,57 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
+"""Writer for columns of text files."""
+
+import io
+from typing import Sequence, Union
+
+import numpy as np
+
+# Number of rows formatted at once, bounds the memory of the formatted text
+CHUNK_SIZE = 65536
+
+
+def write_columns(
+    f: io.TextIOBase,
+    columns: Sequence[Union[np.ndarray, Sequence]],
+    *,
+    fmt: Sequence[str],
+    sep: str = ' ',
+    chunk_size: int = CHUNK_SIZE,
+) -> None:
+    """Write equally long columns as rows of a text table.
+
+    Rows are formatted in chunks with a single %-format of a precomputed
+    template per chunk, so that the cost per value is that of the formatting
+    in C, rather than of handling Python objects per row.
+
+    Parameters
+    ----------
+    f:
+        File handle.
+    columns:
+        Numpy arrays or sequences of preformatted strings.
+    fmt:
+        %-format of the values of each column, e.g., ``'%.18e'`` or ``'%s'``.
+    sep:
+        Separator of the values in a row.
+    chunk_size:
+        Number of rows to format at once.
+    """
+    if not columns:
+        return
+    n_rows = len(columns[0])
+    row = sep.join(fmt)
+    template = '\n'.join([row] * chunk_size) + '\n'
+    block = np.empty((chunk_size, len(columns)), dtype=object)
+    for start in range(0, n_rows, chunk_size):
+        stop = min(start + chunk_size, n_rows)
+        n = stop - start
+        if n < chunk_size:
+            template = '\n'.join([row] * n) + '\n'
+            block = block[:n]
+        for i, column in enumerate(columns):
+            # tolist gives Python scalars, which are formatted like str(float)
+            values = column[start:stop]
+            block[:, i] = values.tolist() if isinstance(values, np.ndarray) else values
+        f.write(template % tuple(block.ravel()))
@@ -0,0 +1,292 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
+"""On-disk cache of loaded runs."""
+
+import hashlib
+import json
+import os
+import shutil
+import uuid
+from pathlib import Path
+from typing import Any, Callable, Dict, Optional, Union
+
+import numpy as np
+import scipp as sc
+
+from .._utils import digest, fingerprint
+
+# Version of the layout of cache entries, entries of other versions are ignored
+_FORMAT = 1
+
+
+def _canonical(value: Any) -> Any:
+    """JSON compatible representation of a loader argument, identifying its content"""
+    if isinstance(value, np.ndarray):
+        return ['ndarray', str(value.dtype), value.shape, digest(value)]
+    if isinstance(value, sc.Variable):
+        key = fingerprint(value)
+        if key is not None:
+            return ['Variable', *key]
+    if isinstance(value, (list, tuple)):
+        return [_canonical(item) for item in value]
+    if isinstance(value, dict):
+        return {str(key): _canonical(item) for key, item in sorted(value.items())}
+    if value is None or isinstance(value, (bool, int, float, str)):
+        return value
+    return repr(value)
+
+
+def _plan_digest(plan: Any) -> str:
+    content = {
+        name: digest(np.asarray(value)) if np.ndim(value) else str(value)
+        for name, value in plan.to_dict().items()
+    }
+    return hashlib.sha256(json.dumps(content, sort_keys=True).encode()).hexdigest()
+
+
+def _is_columnar(events: sc.DataArray) -> bool:
+    """True if all event columns can be stored as plain numpy arrays"""
+    columns = [events.data, *events.coords.values(), *events.masks.values()]
+    return events.ndim == 1 and all(
+        column.dims == events.dims
+        and isinstance(column.values, np.ndarray)
+        and column.values.dtype.kind in 'biufmM'
+        for column in columns
+    )
+
+
+class RunCache:
+    """Opt-in cache of loaded event data in a directory.
+
+    Entries are keyed on the path, modification time, and size of the file,
+    the loader, and its arguments, so that modifying the file or loading it
+    differently gives a new entry.
+    Binned events are stored in a columnar layout of one ``.npy`` file per
+    event column plus the begin and end indices of the bins.
+    Loading an entry reads these files sequentially, without decoding and
+    sorting the events again like the loader does.
+    Coords of the bins, e.g., positions, are stored in an HDF5 file next to
+    the columns.
+
+    Results of applying an :class:`scippneutron.tof.UnwrapPlan` can be
+    cached too, keyed on the entry of the raw data and the content of the plan.
+
+    Entries are never removed automatically, delete the directory or call
+    :meth:`clear` to free the disk space.
+
+    Parameters
+    ----------
+    directory:
+        Directory to store the entries in, created if needed.
+
+    Examples
+    --------
+    Load a file, the second call reads the cache entry instead of the file::
+
+      cache = RunCache('~/.cache/scippneutron')
+      data = cache.load_nexus('PG3_4844_event.nxs')
+      data = cache.load_nexus('PG3_4844_event.nxs')
+
+    Also cache the result of unwrapping::
+
+      tof = cache.load_nexus('PG3_4844_event.nxs', unwrap_plan=plan)
+    """
+
+    def __init__(self, directory: Union[str, Path]):
+        self._directory = Path(directory).expanduser()
+        self._directory.mkdir(parents=True, exist_ok=True)
+
+    @property
+    def directory(self) -> Path:
+        return self._directory
+
+    def key(self, path: Union[str, Path], loader: str, **loader_args: Any) -> str:
+        """Key of the entry of a file loaded by ``loader`` with ``loader_args``."""
+        path = Path(path).expanduser().resolve()
+        stat = path.stat()
+        content = {
+            'path': str(path),
+            'mtime_ns': stat.st_mtime_ns,
+            'size': stat.st_size,
+            'loader': loader,
+            'args': _canonical(loader_args),
+        }
+        return hashlib.sha256(json.dumps(content, sort_keys=True).encode()).hexdigest()
+
+    def load(
+        self,
+        loader: Callable[..., sc.DataArray],
+        path: Union[str, Path],
+        *,
+        unwrap_plan: Optional[Any] = None,
+        **loader_args: Any,
+    ) -> sc.DataArray:
+        """Return ``loader(path, **loader_args)``, from the cache if possible.
+
+        Results which are not data arrays are returned without caching them.
+
+        Parameters
+        ----------
+        loader:
+            Function loading a data array from a file.
+        path:
+            Path of the file to load.
+        unwrap_plan:
+            If given, return the result of applying it to the loaded data,
+            which is cached as well.
+        loader_args:
+            Keyword arguments of ``loader``.
+        """
+        name = f'{loader.__module__}.{loader.__qualname__}'
+        key = self.key(path, name, **loader_args)
+        if unwrap_plan is not None:
+            tof_key = f'{key}-tof-{_plan_digest(unwrap_plan)}'
+            if (cached := self.get(tof_key)) is not None:
+                return cached
+        data = self.get(key)
+        if data is None:
+            data = loader(path, **loader_args)
+            if not isinstance(data, sc.DataArray):
+                return data
+            self.put(key, data)
+        if unwrap_plan is None:
+            return data
+        data = unwrap_plan.apply(data, in_place=True)
+        self.put(tof_key, data)
+        return data
+
+    def load_nexus(
+        self,
+        path: Union[str, Path],
+        *,
+        unwrap_plan: Optional[Any] = None,
+        **loader_args: Any,
+    ) -> sc.DataArray:
+        """Cached :func:`scippneutron.load_nexus`, see :meth:`load`.
+
+        Generators returned with ``chunk_pulses`` are not cached.
+        """
+        from .nexus.load_nexus import load_nexus
+
+        return self.load(load_nexus, path, unwrap_plan=unwrap_plan, **loader_args)
+
+    def _entry(self, key: str) -> Path:
+        return self._directory / key
+
+    def get(self, key: str) -> Optional[sc.DataArray]:
+        """The data array stored under key, None if there is none."""
+        entry = self._entry(key)
+        try:
+            with open(entry / 'manifest.json') as f:
+                manifest = json.load(f)
+        except FileNotFoundError:
+            return None
+        if manifest.get('format') != _FORMAT:
+            return None
+        outer = sc.io.load_hdf5(str(entry / 'outer.h5'))
+        if not manifest['binned']:
+            return outer
+        events = _read_columns(entry, manifest)
+        begin = np.load(entry / 'begin.npy', mmap_mode='r')
+        end = np.load(entry / 'end.npy', mmap_mode='r')
+        outer.data = sc.bins(
+            begin=sc.array(dims=outer.dims, values=begin, unit=None),
+            end=sc.array(dims=outer.dims, values=end, unit=None),
+            dim=manifest['event_dim'],
+            data=events,
+        )
+        return outer
+
+    def put(self, key: str, da: sc.DataArray) -> None:
+        """Store a data array under key, replacing an existing entry."""
+        entry = self._entry(key)
+        tmp = self._directory / f'.{key}.{uuid.uuid4().hex}'
+        tmp.mkdir()
+        try:
+            manifest = {'format': _FORMAT, 'binned': False}
+            outer = da
+            if da.bins is not None:
+                constituents = da.bins.constituents
+                if _is_columnar(constituents['data']):
+                    manifest.update(_write_columns(tmp, constituents['data']))
+                    manifest['binned'] = True
+                    begin = constituents['begin'].values
+                    np.save(tmp / 'begin.npy', begin)
+                    np.save(tmp / 'end.npy', begin + da.bins.size().values)
+                    outer = da.copy(deep=False)
+                    outer.data = sc.zeros(sizes=da.sizes, dtype='int32', unit=None)
+            outer.save_hdf5(str(tmp / 'outer.h5'))
+            # Written last, entries without a manifest are incomplete
+            with open(tmp / 'manifest.json', 'w') as f:
+                json.dump(manifest, f)
+            if entry.exists():
+                shutil.rmtree(entry)
+            try:
+                os.replace(tmp, entry)
+            except OSError:
+                # Another process has stored the same entry in the meantime
+                pass
+        finally:
+            if tmp.exists():
+                shutil.rmtree(tmp)
+
+    def clear(self) -> None:
+        """Remove all entries."""
+        for entry in self._directory.iterdir():
+            if entry.is_dir():
+                shutil.rmtree(entry)
+
+
+def _unit_str(unit: Optional[sc.Unit]) -> Optional[str]:
+    return None if unit is None else str(unit)
+
+
+def _write_columns(directory: Path, events: sc.DataArray) -> Dict[str, Any]:
+    columns = []
+
+    def write(kind: str, name: Optional[str], var: sc.Variable) -> None:
+        filename = f'column{len(columns)}.npy'
+        np.save(directory / filename, var.values)
+        if var.variances is not None:
+            np.save(directory / f'variances{len(columns)}.npy', var.variances)
+        columns.append(
+            {
+                'kind': kind,
+                'name': name,
+                'file': filename,
+                'unit': _unit_str(var.unit),
+                'variances': var.variances is not None,
+            }
+        )
+
+    write('data', None, events.data)
+    for name, coord in events.coords.items():
+        write('coord', name, coord)
+    for name, mask in events.masks.items():
+        write('mask', name, mask)
+    return {'event_dim': events.dim, 'columns': columns}
+
+
+def _read_columns(directory: Path, manifest: Dict[str, Any]) -> sc.DataArray:
+    dims = [manifest['event_dim']]
+    data = None
+    coords = {}
+    masks = {}
+    for i, column in enumerate(manifest['columns']):
+        # Memory mapped, scipp copies the values in a single sequential read
+        values = np.load(directory / column['file'], mmap_mode='r')
+        variances = (
+            np.load(directory / f'variances{i}.npy', mmap_mode='r')
+            if column['variances']
+            else None
+        )
+        var = sc.array(
+            dims=dims, values=values, variances=variances, unit=column['unit']
+        )
+        if column['kind'] == 'data':
+            data = var
+        elif column['kind'] == 'coord':
+            coords[column['name']] = var
+        else:
+            masks[column['name']] = var
+    return sc.DataArray(data, coords=coords, masks=masks)
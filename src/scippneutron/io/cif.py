@@ -69,8 +69,19 @@ from datetime import datetime
 from pathlib import Path
 from typing import Any, Iterable, Mapping, Optional, Union
 
+import numpy as np
 import scipp as sc
 
+from ._table import write_columns
+
+
+_PLAIN_NUMBER_DTYPES = (
+    sc.DType.float64,
+    sc.DType.float32,
+    sc.DType.int64,
+    sc.DType.int32,
+)
+
 
 @dataclass(frozen=True)
 class CIFSchema:
@@ -266,19 +277,22 @@ class Loop:
         f.write('loop_\n')
         for key in self._columns:
             f.write(f'_{key}\n')
-        formatted_values = [
-            tuple(map(_format_value, row)) for row in zip(*self._columns.values())
-        ]
+        # Plain numbers are formatted in chunks while writing, other values are
+        # formatted individually up front.
+        columns = [_format_column(column) for column in self._columns.values()]
         # If any value is a multi-line string, lay out elements as a flat vertical
         # list, otherwise use a 2d table.
         sep = (
             '\n'
-            if any(';' in item for row in formatted_values for item in row)
+            if any(
+                ';' in item
+                for column in columns
+                if isinstance(column, list)
+                for item in column
+            )
             else ' '
         )
-        for row in formatted_values:
-            f.write(sep.join(row))
-            f.write('\n')
+        write_columns(f, columns, fmt=['%s'] * len(columns), sep=sep)
 
 
 class Block:
@@ -545,6 +559,19 @@ def _encode_non_ascii(s: str) -> str:
     return s.encode('ascii', 'backslashreplace').decode('ascii')
 
 
+def _format_column(column: sc.Variable) -> Union[np.ndarray, list[str]]:
+    if column.variances is not None:
+        return [_format_value(value) for value in column]
+    if column.dtype in _PLAIN_NUMBER_DTYPES:
+        # str of these never needs quotes or escapes
+        return column.values
+    if column.dtype == sc.DType.string:
+        # Columns of strings, e.g., ids, tend to repeat a few distinct values
+        formatted = {value: _format_value(value) for value in set(column.values)}
+        return [formatted[value] for value in column.values]
+    return [_format_value(value) for value in column.values]
+
+
 def _format_value(value: Any) -> str:
     if isinstance(value, sc.Variable):
         if value.variance is not None:
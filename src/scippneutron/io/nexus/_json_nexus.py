@@ -119,9 +119,17 @@ def _get_attribute_value(
 
 
 def _visitnodes(root: Dict):
-    for child in root.get(_nexus_children, ()):
+    # Depth-first in pre-order without recursion, trees of large instruments
+    # are deep and wide
+    stack = [iter(root.get(_nexus_children, ()))]
+    while stack:
+        child = next(stack[-1], None)
+        if child is None:
+            stack.pop()
+            continue
         yield child
-        yield from _visitnodes(child)
+        if _nexus_children in child:
+            stack.append(iter(child[_nexus_children]))
 
 
 def _name(node: Dict):
@@ -157,6 +165,27 @@ def contains_stream(group: JSONGroup) -> bool:
     )
 
 
+class _GroupIndex:
+    """Lookup of the children of a group node by name.
+
+    Built once per node and rebuilt only if children are added.
+    """
+
+    def __init__(self, node: dict):
+        children = node[_nexus_children]
+        self.node = node
+        self.n_children = len(children)
+        # Groups with a stream are filled by the stream, their children are hidden
+        self.keys = [] if any(map(_is_stream, children)) else list(map(_name, children))
+        self.children = {}
+        for child in children:
+            if _is_link(child) or _is_group(child) or _is_dataset(child):
+                self.children.setdefault(_name(child), child)
+
+    def is_valid_for(self, node: dict) -> bool:
+        return self.node is node and self.n_children == len(node[_nexus_children])
+
+
 class JSONTypeStringID:
     def get_cset(self):
         import h5py
@@ -223,6 +252,10 @@ class JSONNode:
             self._name = f'/{name}'
         else:
             self._name = f'{parent.name}/{name}'
+        if parent is None:
+            # Shared by all nodes of the tree, by id of their JSON dicts
+            self._group_indices: Dict[int, _GroupIndex] = {}
+            self._arrays: Dict[int, Tuple[Any, np.ndarray]] = {}
 
     @property
     def attrs(self) -> JSONAttributeManager:
@@ -263,10 +296,22 @@ class JSONDataset(JSONNode):
 
     @property
     def shape(self):
-        return np.asarray(self._node[_nexus_config][_nexus_values]).shape
+        return self._values().shape
+
+    def _values(self) -> np.ndarray:
+        # Values are decoded from JSON lists only when first read, e.g., of
+        # detector_number of large detectors, and cached to not decode them again
+        config = self._node[_nexus_config]
+        arrays = self.file._arrays
+        key = id(config)
+        cached = arrays.get(key)
+        if cached is None or cached[0] is not config[_nexus_values]:
+            cached = (config[_nexus_values], np.asarray(config[_nexus_values]))
+            arrays[key] = cached
+        return cached[1]
 
     def __getitem__(self, index):
-        return np.asarray(self._node[_nexus_config][_nexus_values])[index]
+        return self._values()[index]
 
     def read_direct(self, buf, source_sel):
         buf[...] = self[source_sel]
@@ -283,11 +328,16 @@ class JSONGroup(JSONNode):
         except KeyError:
             return False
 
+    def _index(self) -> _GroupIndex:
+        indices = self.file._group_indices
+        index = indices.get(id(self._node))
+        if index is None or not index.is_valid_for(self._node):
+            index = _GroupIndex(self._node)
+            indices[id(self._node)] = index
+        return index
+
     def keys(self) -> List[str]:
-        if contains_stream(self):
-            return []
-        children = self._node[_nexus_children]
-        return [_name(child) for child in children if not contains_stream(child)]
+        return list(self._index().keys)
 
     def items(self) -> List[Tuple[str, JSONNode]]:
         return [(key, self[key]) for key in self.keys()]
@@ -305,13 +355,11 @@ class JSONGroup(JSONNode):
         else:
             parent = self
 
-        for child in parent._node[_nexus_children]:
-            if _name(child) != name.split('/')[-1]:
-                continue
+        child = parent._index().children.get(name.split('/')[-1])
+        if child is not None:
             if _is_link(child):
                 return self[child[_nexus_config]["target"]]
-            if _is_group(child) or _is_dataset(child):
-                return self._as_group_or_dataset(child, parent)
+            return self._as_group_or_dataset(child, parent)
 
         raise KeyError(f"Unable to open object (object '{name}' doesn't exist)")
 
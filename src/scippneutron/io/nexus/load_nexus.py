@@ -5,20 +5,31 @@ import json
 from contextlib import contextmanager
 from pathlib import Path
 from timeit import default_timer as timer
-from typing import Any, Dict, Optional, Set, Tuple, Union
+from typing import (
+    Any,
+    Dict,
+    Iterator,
+    List,
+    Optional,
+    Sequence,
+    Set,
+    Tuple,
+    Union,
+)
 from warnings import warn
 
 import h5py
 import numpy as np
 import scipp as sc
 import scippnexus as snx
-from scipp.binning import make_binned
 from scipp.core.util import VisibleDeprecationWarning
 from scippnexus.v1 import NXroot
 from scippnexus.v1.nxobject import NexusStructureError, NXobject
 from scippnexus.v1.nxtransformations import TransformationError
 
-from ..._utils import get_attrs
+from ..._utils import counting_sort, get_attrs
+from ...core.compact import compact_events as _compact
+from ...log_store import sort_by_time
 from ._json_nexus import JSONGroup, StreamInfo, contains_stream, get_streams_info
 from ._nexus import ScippData
 
@@ -41,6 +52,25 @@ class SkipSource(Exception):
     pass
 
 
+def _sort_transformations(transforms: sc.DataArray) -> sc.DataArray:
+    if transforms.ndim == 1 and 'time' in transforms.coords:
+        return sort_by_time(transforms)
+    return transforms
+
+
+def _time_dependent_transformations(obj) -> Optional[sc.DataArray]:
+    transform = obj.get('depends_on')
+    if isinstance(transform, sc.Variable) and transform.dtype == sc.DType.DataArray:
+        transform = transform.value
+    if (
+        isinstance(transform, sc.DataArray)
+        and transform.ndim == 1
+        and 'time' in transform.coords
+    ):
+        return sort_by_time(transform)
+    return None
+
+
 def add_position_and_transforms_to_data(
     data: Union[sc.DataArray, sc.Dataset],
     transform_name: str,
@@ -65,8 +95,10 @@ def add_position_and_transforms_to_data(
         attrs[base_position_name] = positions
         attrs[transform_name] = sc.scalar(value=transforms)
     else:
+        # Time-dependent, sorted for computing positions per pulse, see
+        # scippneutron.conversion.beamline.position_from_transformation_table
         coords[base_position_name] = positions
-        coords[transform_name] = sc.scalar(value=transforms)
+        coords[transform_name] = sc.scalar(value=_sort_transformations(transforms))
 
 
 @contextmanager
@@ -109,8 +141,15 @@ def _load_start_and_end_time(entry: NXobject) -> Dict:
 
 
 def load_nexus(
-    data_file: Union[str, Path, h5py.File], root: str = "/", quiet=True
-) -> Optional[ScippData]:
+    data_file: Union[str, Path, h5py.File],
+    root: str = "/",
+    quiet=True,
+    *,
+    pulse_range: Optional[Tuple[Optional[int], Optional[int]]] = None,
+    detector_ids: Optional[Union[Sequence[int], np.ndarray, sc.Variable]] = None,
+    chunk_pulses: Optional[int] = None,
+    compact_events: bool = False,
+) -> Union[Optional[ScippData], Iterator[sc.DataArray]]:
     """
     Load a NeXus file and return required information.
 
@@ -118,25 +157,116 @@ def load_nexus(
     :param root: path of group in file, only load data from the subtree of
       this group
     :param quiet: if False prints some details of what is being loaded
+    :param pulse_range: (start, stop) indices of the pulses to load events of,
+      only the corresponding slices of the event datasets are read from the file
+    :param detector_ids: only keep events of, and return bins for, these
+      detector ids
+    :param chunk_pulses: if given, return a generator which loads and yields
+      the events of this many pulses at a time instead of loading all of them.
+      Every chunk carries the same metadata, which is loaded only once.
+      data_file must stay open while the generator is in use.
+    :param compact_events: if True, store the loaded events in the compact
+      layout of :py:func:`scippneutron.compact_events`, with implicit unit
+      weights and float32 or int32 event coords
 
     Usage example:
       data = sc.neutron.load_nexus('PG3_4844_event.nxs')
+      for chunk in sc.neutron.load_nexus('PG3_4844_event.nxs', chunk_pulses=1000):
+          ...
     """
     warn(
         "`load_nexus` is deprecated and will be removed in version 24.03, "
         "please switch to using ScippNexus.",
         VisibleDeprecationWarning,
     )
+    pulse_slice = None if pulse_range is None else slice(*pulse_range)
+    detector_ids = _as_detector_ids(detector_ids)
+    if chunk_pulses is not None:
+        if chunk_pulses < 1:
+            raise ValueError("chunk_pulses must be at least 1")
+        return _load_pulse_chunks(
+            data_file, root, pulse_slice, detector_ids, chunk_pulses, compact_events
+        )
+
     start_time = timer()
 
     with _open_if_path(data_file) as nexus_file:
-        loaded_data = _load_data(nexus_file, root, quiet)
+        loaded_data = _load_data(
+            nexus_file,
+            root,
+            quiet,
+            pulse_range=pulse_slice,
+            detector_ids=detector_ids,
+        )
+    if compact_events:
+        loaded_data = _compact_events(loaded_data)
 
     if not quiet:
         print("Total time:", timer() - start_time)
     return loaded_data
 
 
+def _as_detector_ids(
+    detector_ids: Optional[Union[Sequence[int], np.ndarray, sc.Variable]]
+) -> Optional[np.ndarray]:
+    if detector_ids is None:
+        return None
+    if isinstance(detector_ids, sc.Variable):
+        detector_ids = detector_ids.values
+    return np.unique(np.asarray(detector_ids))
+
+
+def _load_pulse_chunks(
+    data_file: Union[str, Path, h5py.File],
+    root: str,
+    pulse_range: Optional[slice],
+    detector_ids: Optional[np.ndarray],
+    chunk_pulses: int,
+    compact_events: bool = False,
+) -> Iterator[sc.DataArray]:
+    with _open_if_path(data_file) as nexus_file:
+        classes = _nx_classes(nexus_file, root)
+        n_pulses = max(
+            (
+                group._group['event_index'].shape[0]
+                for group in classes.get('NXevent_data', {}).values()
+                if 'event_index' in group._group
+            ),
+            default=0,
+        )
+        if pulse_range is None:
+            pulse_range = slice(None)
+        start, stop, _ = pulse_range.indices(n_pulses)
+        # Metadata are loaded once into a placeholder and shared by all chunks
+        metadata = sc.DataArray(sc.scalar(0))
+        _add_metadata(metadata, classes)
+        chunk_ranges = [
+            slice(chunk_start, min(chunk_start + chunk_pulses, stop))
+            for chunk_start in range(start, stop, chunk_pulses)
+        ]
+        id_ranges = None
+        if detector_ids is None and not classes.get('NXdetector'):
+            # All chunks get the same detector ids
+            id_ranges = _bank_id_ranges(classes.get('NXevent_data', {}), chunk_ranges)
+        for chunk_range in chunk_ranges:
+            chunk = _load_events(classes, chunk_range, detector_ids, id_ranges)
+            if chunk is None:
+                return
+            if compact_events:
+                chunk = _compact_events(chunk)
+            for key, value in metadata.coords.items():
+                chunk.coords[key] = value
+            for key, value in get_attrs(metadata).items():
+                get_attrs(chunk)[key] = value
+            yield chunk
+
+
+def _compact_events(data: Optional[ScippData]) -> Optional[ScippData]:
+    if isinstance(data, sc.DataArray) and data.bins is not None:
+        return _compact(data)
+    return data
+
+
 def _origin(unit) -> sc.Variable:
     return sc.vector(value=[0, 0, 0], unit=unit)
 
@@ -155,6 +285,23 @@ def _depends_on_to_position(obj) -> Union[None, sc.Variable]:
                 return transform.to(unit='m') * _origin('m')
 
 
+def _log_to_canonical(log):
+    # Sorted by time so that values can be looked up by time, the invariant of
+    # LogStore, which LogStore.from_data_array builds a store from. Logs are
+    # not converted to a LogStore here: that would copy them, drop variances
+    # and other coords, and turn the time coord into datetimes in ns, while
+    # sort_by_time returns an already sorted log as is.
+    if (
+        isinstance(log, sc.DataArray)
+        and log.ndim == 1
+        and 'time' in log.coords
+        and log.coords['time'].dims == log.dims
+        and log.coords['time'].dtype == sc.DType.datetime64
+    ):
+        return sort_by_time(log)
+    return log
+
+
 def _monitor_to_canonical(monitor):
     if isinstance(monitor, sc.DataGroup):
         return monitor
@@ -216,13 +363,9 @@ def _by_nx_class(group) -> Dict[str, Dict[str, 'NXobject']]:
     return out
 
 
-def _load_data(
-    nexus_file: Union[h5py.File, Dict], root: Optional[str], quiet: bool
-) -> Optional[ScippData]:
-    """
-    Main implementation for loading data is extracted to this function so that
-    in-memory data can be used for unit tests.
-    """
+def _nx_classes(
+    nexus_file: Union[h5py.File, Dict], root: Optional[str]
+) -> Dict[str, Dict[str, NXobject]]:
     root = NXroot(nexus_file if root is None else nexus_file[root])
     classes = _by_nx_class(root)
 
@@ -235,7 +378,393 @@ def _load_data(
             "to specify which to load data from, for example"
             f"{__name__}('my_file.nxs', '/entry_2')"
         )
+    return classes
+
+
+def _load_data(
+    nexus_file: Union[h5py.File, Dict],
+    root: Optional[str],
+    quiet: bool,
+    pulse_range: Optional[slice] = None,
+    detector_ids: Optional[np.ndarray] = None,
+) -> Optional[ScippData]:
+    """
+    Main implementation for loading data is extracted to this function so that
+    in-memory data can be used for unit tests.
+    """
+    classes = _nx_classes(nexus_file, root)
+    loaded_data = _load_events(classes, pulse_range, detector_ids)
+    no_event_data = loaded_data is None
+    # If no event data are found, make a Dataset and add the metadata as
+    # Dataset entries. Otherwise, make a DataArray.
+    if no_event_data:
+        loaded_data = {}
+    _add_metadata(loaded_data, classes)
+
+    # Return None if we have an empty dataset at this point
+    if no_event_data and not loaded_data.keys():
+        return None
+    elif isinstance(loaded_data, sc.DataArray):
+        return loaded_data
+    return sc.Dataset(loaded_data)
+
+
+def _read_detector(group: NXobject, pulse_range: Optional[slice]):
+    if pulse_range is None:
+        return group[()]
+    # Reads only the slices of the event datasets of the selected pulses
+    return group.select_events['pulse', pulse_range][()]
+
 
+def _select_detector_ids(
+    det: sc.DataArray, detector_ids: Optional[np.ndarray]
+) -> sc.DataArray:
+    if detector_ids is None:
+        return det
+    selected = np.isin(det.coords['detector_id'].values, detector_ids)
+    return det[sc.array(dims=['detector_id'], values=selected)]
+
+
+def _bank_event_range(group: NXobject, pulse_range: Optional[slice]) -> slice:
+    """
+    Range of events of the pulses in pulse_range, as given by event_index
+    """
+    event_index = group._group['event_index']
+    n_pulses = event_index.shape[0]
+    if pulse_range is None:
+        pulse_range = slice(None)
+    start, stop, _ = pulse_range.indices(n_pulses)
+    if start >= stop:
+        return slice(0, 0)
+    end = group._group['event_id'].shape[0]
+    if stop != n_pulses:
+        end = int(event_index[stop])
+    return slice(int(event_index[start]), end)
+
+
+def _read_bank_event_ids(group: NXobject, event_range: slice) -> np.ndarray:
+    ids = np.asarray(group._group['event_id'][event_range])
+    if not np.issubdtype(ids.dtype, np.integer):
+        raise BadSource(f"event_id in {group.name} are not integers")
+    return ids
+
+
+def _read_bank_events(
+    group: NXobject, pulse_range: Optional[slice], event_range: slice
+) -> Tuple[sc.Variable, sc.Variable, np.ndarray]:
+    """
+    event_time_offset of the events in event_range, event_time_zero of the
+    pulses in pulse_range, and the index of the pulse of each event
+    """
+    n_pulses = group._group['event_index'].shape[0]
+    if pulse_range is None:
+        pulse_range = slice(None)
+    start, stop, _ = pulse_range.indices(n_pulses)
+    stop = max(start, stop)
+    n_events = event_range.stop - event_range.start
+    event_index = np.asarray(group._group['event_index'][start:stop]).astype(np.int64)
+    # Some files contain uint64 "max" indices, which turn negative as int64
+    event_index[event_index < 0] = event_range.stop
+    begin = event_index - event_range.start
+    end = np.append(begin[1:], n_events)
+    if np.any(end < begin) or np.any(end > n_events):
+        raise BadSource(f"Invalid index in NXevent_data at {group.name}/event_index")
+    pulse = np.repeat(np.arange(len(begin)), end - begin)
+    tof = group['event_time_offset']['event', event_range]
+    time_zero = group['event_time_zero']['pulse', start:stop]
+    return tof, time_zero, pulse
+
+
+def _bank_id_ranges(
+    groups: Dict[str, NXobject], pulse_ranges: List[slice]
+) -> Dict[str, Tuple[int, int]]:
+    """
+    Smallest and largest event_id of each NXevent_data group over all of
+    pulse_ranges, reading the ids of one range at a time
+    """
+    id_ranges = {}
+    for name, group in groups.items():
+        try:
+            for pulse_range in pulse_ranges:
+                ids = _read_bank_event_ids(group, _bank_event_range(group, pulse_range))
+                if len(ids) == 0:
+                    continue
+                id_min, id_max = int(ids.min()), int(ids.max())
+                if name in id_ranges:
+                    id_min = min(id_min, id_ranges[name][0])
+                    id_max = max(id_max, id_ranges[name][1])
+                id_ranges[name] = (id_min, id_max)
+        except (BadSource, KeyError, IndexError):
+            pass  # Warned about when loading the chunks
+    return id_ranges
+
+
+def _pixel_index(ids: np.ndarray, detector_ids: np.ndarray) -> np.ndarray:
+    """
+    Index of each id in the sorted detector_ids, -1 for ids not in detector_ids
+    """
+    if len(detector_ids) == 0:
+        return np.full(len(ids), -1, dtype=np.intp)
+    if detector_ids[-1] - detector_ids[0] + 1 == len(detector_ids):
+        # Contiguous ids, no need to search
+        index = ids.astype(np.intp) - detector_ids[0]
+        index[(index < 0) | (index >= len(detector_ids))] = -1
+        return index
+    index = np.searchsorted(detector_ids, ids)
+    np.minimum(index, len(detector_ids) - 1, out=index)
+    index[detector_ids[index] != ids] = -1
+    return index
+
+
+def _bank_event_counts(
+    ids: np.ndarray,
+    detector_ids: Optional[np.ndarray],
+    id_range: Optional[Tuple[int, int]] = None,
+) -> Tuple[int, np.ndarray]:
+    """
+    Number of events for each detector id from the returned offset onwards,
+    the offset is an index into detector_ids if those are given,
+    or else the smallest id, which is the start of id_range if given
+    """
+    if detector_ids is not None:
+        pixel = _pixel_index(ids, detector_ids)
+        return 0, np.bincount(pixel[pixel >= 0], minlength=len(detector_ids))
+    if id_range is not None:
+        id_min, id_max = id_range
+        return id_min, np.bincount(ids - id_min, minlength=id_max - id_min + 1)
+    if len(ids) == 0:
+        return 0, np.zeros(0, dtype=np.int64)
+    det_min = int(ids.min())
+    return det_min, np.bincount(ids - det_min)
+
+
+def _count_events_per_detector(
+    bank_counts: List[Tuple[int, np.ndarray]], detector_ids: Optional[np.ndarray]
+) -> Tuple[np.ndarray, np.ndarray, List[slice]]:
+    """
+    Detector ids, their number of events, and the range of the detectors
+    of each bank.
+
+    If detector_ids is None, each bank gets its own range of detector ids,
+    from the smallest to the largest one found in the bank, as if the banks
+    were binned separately and concatenated.
+    Otherwise all banks share the given detector ids.
+    """
+    if detector_ids is not None:
+        counts = np.zeros(len(detector_ids), dtype=np.int64)
+        for _, c in bank_counts:
+            counts += c
+        return detector_ids, counts, [slice(0, len(counts))] * len(bank_counts)
+    bounds = np.cumsum([0] + [len(c) for _, c in bank_counts])
+    detector_ids = np.concatenate(
+        [np.arange(len(c), dtype=np.int64) + offset for offset, c in bank_counts]
+        or [np.zeros(0, dtype=np.int64)]
+    )
+    counts = np.concatenate(
+        [c for _, c in bank_counts] or [np.zeros(0, dtype=np.int64)]
+    )
+    banks = [slice(int(start), int(stop)) for start, stop in zip(bounds, bounds[1:])]
+    return detector_ids, counts, banks
+
+
+class _GroupedEventBuffer:
+    """
+    Events of several NXevent_data groups, grouped by detector id.
+
+    The space for the events of each detector is reserved up front from the
+    counts of a first pass over event_id. The events of each group are then
+    ordered by detector with a counting sort and scattered from the arrays
+    read from the file straight to their place in the buffer.
+    """
+
+    def __init__(
+        self, detector_ids: np.ndarray, counts: np.ndarray, banks: List[slice]
+    ):
+        self._detector_ids = detector_ids
+        self._counts = counts
+        self._begin = np.cumsum(counts) - counts
+        self._filled = np.zeros_like(counts)
+        self._banks = banks
+        self._columns: Optional[Dict[str, sc.Variable]] = None
+        self._tof_min = None
+        self._tof_max = None
+
+    def _allocate(
+        self, event_id: np.ndarray, tof: sc.Variable, time_zero: sc.Variable
+    ):
+        sizes = {'event': int(self._counts.sum())}
+        self._columns = {
+            # Weights of NXevent_data, see scippnexus
+            'data': sc.ones(sizes=sizes, dtype='float32', unit='counts'),
+            'tof': sc.empty(sizes=sizes, dtype=tof.dtype, unit=tof.unit),
+            'detector_id': sc.array(
+                dims=['event'],
+                values=np.empty(sizes['event'], dtype=event_id.dtype),
+                unit=None,
+            ),
+            'pulse_time': sc.empty(
+                sizes=sizes, dtype=time_zero.dtype, unit=time_zero.unit
+            ),
+        }
+
+    def add(
+        self,
+        bank: int,
+        event_id: np.ndarray,
+        tof: sc.Variable,
+        time_zero: sc.Variable,
+        pulse: np.ndarray,
+    ):
+        """
+        Add the events of a bank.
+
+        :param bank: Index of the bank in the banks given on construction
+        :param event_id: Detector id of each event
+        :param tof: event_time_offset of each event
+        :param time_zero: Time of each pulse
+        :param pulse: Index of the pulse of each event
+        """
+        if self._columns is None:
+            self._allocate(event_id, tof, time_zero)
+        detectors = self._banks[bank]
+        n_detectors = detectors.stop - detectors.start
+        if len(event_id) == 0 or n_detectors == 0:
+            return
+        pixel = _pixel_index(event_id, self._detector_ids[detectors])
+        keep = pixel >= 0
+        if np.all(keep):
+            order, counts = counting_sort(pixel, n_detectors)
+        else:
+            keep = np.flatnonzero(keep)
+            order, counts = counting_sort(pixel[keep], n_detectors)
+            order = keep[order]
+        n_events = len(order)
+        if n_events == 0:
+            return
+        # Events of each detector are contiguous in the sorted events and in
+        # the buffer, so that the target of a sorted event is its index plus
+        # the shift of its detector
+        shift = self._begin[detectors] + self._filled[detectors]
+        shift -= np.cumsum(counts) - counts
+        shifts = np.unique(shift[counts != 0])
+        if len(shifts) == 1:
+            # A bank loaded at once fills its detectors in one block
+            target = slice(int(shifts[0]), int(shifts[0]) + n_events)
+        else:
+            target = np.repeat(shift, counts) + np.arange(n_events)
+
+        columns = self._columns
+        tof = tof.to(
+            unit=columns['tof'].unit, dtype=columns['tof'].dtype, copy=False
+        ).values[order]
+        columns['tof'].values[target] = tof
+        columns['detector_id'].values[target] = event_id[order]
+        time_zero = time_zero.to(unit=columns['pulse_time'].unit, copy=False)
+        columns['pulse_time'].values[target] = time_zero.values[pulse[order]]
+
+        tof_min, tof_max = tof.min(), tof.max()
+        if self._tof_min is not None:
+            tof_min = min(tof_min, self._tof_min)
+            tof_max = max(tof_max, self._tof_max)
+        self._tof_min, self._tof_max = tof_min, tof_max
+        self._filled[detectors] += counts
+
+    def to_data_array(
+        self,
+    ) -> Optional[Tuple[sc.DataArray, Optional[Tuple[sc.Variable, sc.Variable]]]]:
+        if self._columns is None:
+            return None
+        data = self._columns.pop('data')
+        coords = self._columns
+        begin = sc.array(dims=['detector_id'], values=self._begin, unit=None)
+        # Space reserved for groups which failed to load is left empty
+        end = begin + sc.array(dims=['detector_id'], values=self._filled, unit=None)
+        grouped = sc.DataArray(
+            sc.bins(
+                begin=begin,
+                end=end,
+                dim='event',
+                data=sc.DataArray(data, coords=coords),
+            ),
+            coords={
+                'detector_id': sc.array(
+                    dims=['detector_id'],
+                    values=self._detector_ids,
+                    unit=None,
+                    dtype=coords['detector_id'].dtype,
+                )
+            },
+        )
+        tof_range = None
+        if self._tof_min is not None:
+            tof_unit = coords['tof'].unit
+            tof_range = (
+                sc.scalar(self._tof_min, unit=tof_unit),
+                sc.scalar(self._tof_max, unit=tof_unit),
+            )
+        return grouped, tof_range
+
+
+def _load_grouped_event_data(
+    groups: Dict[str, NXobject],
+    pulse_range: Optional[slice],
+    detector_ids: Optional[np.ndarray],
+    id_ranges: Optional[Dict[str, Tuple[int, int]]] = None,
+) -> Optional[Tuple[sc.DataArray, Optional[Tuple[sc.Variable, sc.Variable]]]]:
+    """
+    Load the events of all NXevent_data groups grouped by detector id,
+    along with the range of their tof.
+
+    Without detector_ids, the detector ids of a group range from its smallest
+    to its largest event_id, or over its range in id_ranges if given.
+
+    event_id is read once, in a first pass which counts the events per
+    detector. The other event fields are then read one group at a time and
+    scattered into a buffer for the events of all groups, so peak memory is
+    that of the grouped events plus the event ids and temporaries of the
+    largest group.
+    """
+    banks = {}
+    for name, group in groups.items():
+        try:
+            event_range = _bank_event_range(group, pulse_range)
+            ids = _read_bank_event_ids(group, event_range)
+            id_range = None if id_ranges is None else id_ranges.get(name)
+            counts = _bank_event_counts(ids, detector_ids, id_range)
+            banks[name] = (event_range, ids, counts)
+        except (BadSource, KeyError, IndexError) as e:
+            if not contains_stream(group._group):
+                warn(f"Skipped loading {group.name} due to:\n{e}")
+    if not banks:
+        return None
+    buffer = _GroupedEventBuffer(
+        *_count_events_per_detector([c for _, _, c in banks.values()], detector_ids)
+    )
+
+    for bank, name in enumerate(list(banks)):
+        group = groups[name]
+        event_range, ids, _ = banks.pop(name)
+        try:
+            buffer.add(bank, ids, *_read_bank_events(group, pulse_range, event_range))
+        except (
+            BadSource,
+            SkipSource,
+            NexusStructureError,
+            KeyError,
+            IndexError,
+            sc.DTypeError,
+            sc.UnitError,
+        ) as e:
+            warn(f"Skipped loading {group.name} due to:\n{e}")
+    return buffer.to_data_array()
+
+
+def _load_events(
+    classes: Dict[str, Dict[str, NXobject]],
+    pulse_range: Optional[slice],
+    detector_ids: Optional[np.ndarray],
+    id_ranges: Optional[Dict[str, Tuple[int, int]]] = None,
+) -> Optional[sc.DataArray]:
     # In the following, we map the file structure onto a partially flattened in-memory
     # structure. This behavior is quite error prone and cumbersome and will probably
     # disappear in this form. We therefore keep this length code directly in this
@@ -244,7 +773,7 @@ def _load_data(
     loaded_detectors = []
     for group in detectors.values():
         try:
-            det = group[()]
+            det = _read_detector(group, pulse_range)
             if isinstance(det, sc.DataGroup):
                 raise NexusStructureError(f"Failed to load NXdetector {group.name}")
             det = _zip_pixel_offset(det)
@@ -261,6 +790,7 @@ def _load_data(
                 raise KeyError(
                     "Found neither of detector_number, pixel_id, or spectrum_index."
                 )
+            det = _select_detector_ids(det, detector_ids)
             if 'pixel_offset' in det.coords:
                 add_position_and_transforms_to_data(
                     data=det,
@@ -283,42 +813,19 @@ def _load_data(
             if not contains_stream(group._group):
                 warn(f"Skipped loading {group.name} due to:\n{e}")
 
-    no_event_data = True
-    loaded_data = {}
-
-    # If no event data are found, make a Dataset and add the metadata as
-    # Dataset entries. Otherwise, make a DataArray.
+    loaded_data = None
+    tof_range = None
     if len(loaded_detectors):
-        no_event_data = False
         loaded_data = sc.concat(loaded_detectors, 'detector_id')
     elif len(detectors) == 0:
         # If there are no NXdetector groups, load NXevent_data directly
-        loaded_events = []
-        for group in classes.get('NXevent_data', {}).values():
-            try:
-                events = group[()]
-                if isinstance(events, sc.DataGroup):
-                    raise NexusStructureError(f"Failed to load NXdetector {group.name}")
-                events.coords['pulse_time'] = events.coords.pop('event_time_zero')
-                events.bins.coords['tof'] = events.bins.coords.pop('event_time_offset')
-                events.bins.coords['detector_id'] = events.bins.coords.pop('event_id')
-                det_min = events.bins.coords['detector_id'].min().value
-                det_max = events.bins.coords['detector_id'].max().value
-                if len(events.bins.constituents['data']) != 0:
-                    # See scipp/scipp#2490
-                    det_id = sc.arange('detector_id', det_min, det_max + 1, unit=None)
-                    events = make_binned(
-                        events, groups=[det_id], erase=['pulse', 'bank']
-                    )
-                loaded_events.append(events)
-            except (BadSource, SkipSource, NexusStructureError, IndexError) as e:
-                if not contains_stream(group._group):
-                    warn(f"Skipped loading {group.name} due to:\n{e}")
-        if len(loaded_events):
-            no_event_data = False
-            loaded_data = sc.concat(loaded_events, 'detector_id')
+        grouped = _load_grouped_event_data(
+            classes.get('NXevent_data', {}), pulse_range, detector_ids, id_ranges
+        )
+        if grouped is not None:
+            loaded_data, tof_range = grouped
 
-    if not no_event_data:
+    if loaded_data is not None:
         # Add single tof bin
         loaded_data = sc.DataArray(
             loaded_data.data.fold(
@@ -327,11 +834,20 @@ def _load_data(
             coords=dict(loaded_data.coords.items()),
             attrs=dict(get_attrs(loaded_data).items()),
         )
-        tof_min = loaded_data.bins.coords['tof'].min().to(dtype='float64')
-        tof_max = loaded_data.bins.coords['tof'].max().to(dtype='float64')
+        if tof_range is None:
+            tof_range = (
+                loaded_data.bins.coords['tof'].min(),
+                loaded_data.bins.coords['tof'].max(),
+            )
+        tof_min, tof_max = (tof.to(dtype='float64') for tof in tof_range)
         tof_max.value = np.nextafter(tof_max.value, float("inf"))
         loaded_data.coords['tof'] = sc.concat([tof_min, tof_max], 'tof')
+    return loaded_data
 
+
+def _add_metadata(
+    loaded_data: Union[sc.DataArray, Dict], classes: Dict[str, Dict[str, NXobject]]
+):
     def add_metadata(metadata: Dict[str, sc.Variable]):
         for key, value in metadata.items():
             if isinstance(loaded_data, sc.DataArray):
@@ -369,7 +885,7 @@ def _load_data(
         return loaded_groups
 
     load_and_add_metadata(classes.get('NXdisk_chopper', {}))
-    load_and_add_metadata(classes.get('NXlog', {}))
+    load_and_add_metadata(classes.get('NXlog', {}), _log_to_canonical)
     load_and_add_metadata(classes.get('NXmonitor', {}), _monitor_to_canonical)
     for name, tag in {'sample': 'NXsample', 'source': 'NXsource'}.items():
         comps = classes.get(tag, {})
@@ -380,6 +896,8 @@ def _load_data(
             comp = attrs[comp_name].value
             if (position := _depends_on_to_position(comp)) is not None:
                 coords[f'{comp_name}_position'] = position
+            elif (transforms := _time_dependent_transformations(comp)) is not None:
+                coords[f'{comp_name}_position_transformations'] = sc.scalar(transforms)
             elif (distance := comp.get('distance')) is not None:
                 if not isinstance(distance, sc.Variable):
                     distance = sc.scalar(distance, unit=None)
@@ -389,13 +907,6 @@ def _load_data(
             elif name == 'sample':
                 coords[f'{comp_name}_position'] = _origin('m')
 
-    # Return None if we have an empty dataset at this point
-    if no_event_data and not loaded_data.keys():
-        return None
-    elif isinstance(loaded_data, sc.DataArray):
-        return loaded_data
-    return sc.Dataset(loaded_data)
-
 
 def load_nexus_json_str(
     json_template: str,
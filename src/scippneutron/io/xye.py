@@ -3,6 +3,8 @@
 """File writer and reader for XYE files."""
 
 import io
+import warnings
+from contextlib import contextmanager
 from pathlib import Path
 from typing import Optional, Union
 
@@ -10,6 +12,7 @@ import numpy as np
 import scipp as sc
 
 from ..logging import get_logger
+from ._table import write_columns
 
 
 class GenerateHeaderType:
@@ -38,6 +41,9 @@ def save_xye(
     - Y: data values of the data array,
     - E: standard deviations corresponding to Y.
 
+    Values are written with 18 significant digits, the rows are formatted
+    in chunks to bound the memory use for long arrays.
+
     This format is lossy, coordinates other than X, attributes,
     and masks are not written and the coordinate name, dimension name, and
     units of the input are lost.
@@ -89,7 +95,6 @@ def save_xye(
             'Compute bin-centers before calling save_xye. '
             'Use, e.g., scipp.midpoints for linearly spaced bins.'
         )
-    to_save = np.c_[da.coords[coord].values, da.values, np.sqrt(da.variances)]
     if header is GenerateHeader:
         header = _generate_xye_header(da, coord)
 
@@ -99,7 +104,14 @@ def save_xye(
         coord,
         fname,
     )
-    np.savetxt(fname, to_save, delimiter=' ', header=header)
+    with _open(fname, 'w') as f:
+        if header:
+            f.write('# ' + header.replace('\n', '\n# ') + '\n')
+        write_columns(
+            f,
+            [da.coords[coord].values, da.values, np.sqrt(da.variances)],
+            fmt=['%.18e'] * 3,
+        )
 
 
 def load_xye(
@@ -117,6 +129,12 @@ def load_xye(
     Since XYE files are lossy, some metadata must be provided manually when calling
     this function.
 
+    Files consisting of a header of comment lines followed by a table of numbers,
+    like the files written by :func:`scippneutron.io.xye.save_xye`,
+    are parsed in a single vectorised pass.
+    Other files, e.g., with comments after the table rows, are loaded with
+    :func:`numpy.loadtxt`.
+
     Parameters
     ----------
     fname:
@@ -142,15 +160,46 @@ def load_xye(
         Function to write XYE files.
     """
     coord = dim if coord is None else coord
-    loaded = np.loadtxt(fname, delimiter=' ', unpack=True)
-    if loaded.ndim == 1:
-        loaded = loaded[:, np.newaxis]
+    with _open(fname, 'r') as f:
+        loaded = _parse_table(f.read())
     return sc.DataArray(
         sc.array(dims=[dim], values=loaded[1], variances=loaded[2] ** 2, unit=unit),
         coords={coord: sc.array(dims=[dim], values=loaded[0], unit=coord_unit)},
     )
 
 
+@contextmanager
+def _open(fname: Union[str, Path, io.TextIOBase], mode: str):
+    if isinstance(fname, io.TextIOBase):
+        yield fname
+    else:
+        with open(fname, mode) as f:
+            yield f
+
+
+def _parse_table(text: str) -> np.ndarray:
+    """Parse the columns of a table with 3 columns and leading comment lines."""
+    start = 0
+    while text.startswith('#', start):
+        end = text.find('\n', start)
+        start = len(text) if end < 0 else end + 1
+    body = text[start:]
+    if '#' not in body:
+        with warnings.catch_warnings():
+            # Numpy warns if it cannot parse the string to its end
+            warnings.simplefilter('error', DeprecationWarning)
+            try:
+                values = np.fromstring(body, sep=' ')
+            except (DeprecationWarning, ValueError):
+                values = None
+        if values is not None and values.size % 3 == 0:
+            return values.reshape(-1, 3).T
+    loaded = np.loadtxt(io.StringIO(text), delimiter=' ', unpack=True)
+    if loaded.ndim == 1:
+        loaded = loaded[:, np.newaxis]
+    return loaded
+
+
 def _generate_xye_header(da: sc.DataArray, coord: str) -> str:
     def format_unit(unit):
         return f'[{unit}]' if unit is not None else ''
@@ -0,0 +1,253 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
+"""
+Time-indexed storage of logs, e.g., of sample-environment parameters.
+"""
+
+from typing import Any, Optional
+
+import numpy as np
+import scipp as sc
+
+from ._utils import as_ns
+
+
+def _numpy_dtype(dtype: Any) -> np.dtype:
+    dtype = np.dtype(str(dtype) if isinstance(dtype, sc.DType) else dtype)
+    # Fixed-width numpy strings would truncate longer values appended later
+    return np.dtype(object) if dtype.kind in 'OSU' else dtype
+
+
+def _is_sorted(times: np.ndarray) -> bool:
+    return bool(np.all(times[1:] >= times[:-1]))
+
+
+def sort_by_time(log: sc.DataArray) -> sc.DataArray:
+    """
+    Return a 1-D log sorted by its time coord, log itself if it is sorted already.
+    """
+    if _is_sorted(as_ns(log.coords['time'])):
+        return log
+    return sc.sort(log, 'time')
+
+
+class LogStore:
+    """
+    Values of a log sorted by time.
+
+    Values are appended in amortised constant time to growable columns.
+    Appending out of order is allowed, the columns are sorted again when they are
+    accessed next.
+    Looking up the value which is valid at a time, i.e., the latest value before it,
+    is a binary search per time, so that, e.g., events can be filtered by a log
+    value in a single vectorised pass, see :py:meth:`LogStore.mask_events`.
+
+    :param name: Name of the log, used as dim of :py:meth:`to_data_array`.
+    :param unit: Unit of the values.
+    :param dtype: Dtype of the values.
+    :param capacity: Number of values to allocate space for initially.
+    """
+
+    def __init__(
+        self,
+        name: str,
+        *,
+        unit: Optional[Any] = None,
+        dtype: Any = 'float64',
+        capacity: int = 1024,
+    ):
+        self.name = name
+        self.unit = unit
+        self._times = np.empty(capacity, dtype=np.int64)
+        self._values = np.empty(capacity, dtype=_numpy_dtype(dtype))
+        self._size = 0
+        self._sorted = True
+
+    @classmethod
+    def from_data_array(cls, log: sc.DataArray) -> 'LogStore':
+        """
+        Create a store from a 1-D log with a 'time' coord, e.g., a loaded NXlog
+        or a log of a chunk of :py:func:`scippneutron.data_stream`.
+        """
+        capacity = max(log.sizes[log.dim], 1)
+        store = cls(log.dim, unit=log.unit, dtype=log.dtype, capacity=capacity)
+        store.extend_data_array(log)
+        return store
+
+    def __len__(self) -> int:
+        return self._size
+
+    def _reserve(self, n: int) -> None:
+        required = self._size + n
+        if required <= len(self._times):
+            return
+        capacity = max(required, 2 * len(self._times))
+        for name in ('_times', '_values'):
+            old = getattr(self, name)
+            new = np.empty(capacity, dtype=old.dtype)
+            new[: self._size] = old[: self._size]
+            setattr(self, name, new)
+
+    def append(self, time_ns: int, value: Any) -> None:
+        """Append a value with its time stamp in nanoseconds since the epoch."""
+        self._reserve(1)
+        if self._size > 0 and time_ns < self._times[self._size - 1]:
+            self._sorted = False
+        self._times[self._size] = time_ns
+        self._values[self._size] = value
+        self._size += 1
+
+    def extend(self, times_ns: np.ndarray, values: np.ndarray) -> None:
+        """Append values with their time stamps in nanoseconds since the epoch."""
+        times_ns = np.asarray(times_ns, dtype=np.int64)
+        n = len(times_ns)
+        if n == 0:
+            return
+        self._reserve(n)
+        if not _is_sorted(times_ns) or (
+            self._size > 0 and times_ns[0] < self._times[self._size - 1]
+        ):
+            self._sorted = False
+        self._times[self._size : self._size + n] = times_ns
+        self._values[self._size : self._size + n] = values
+        self._size += n
+
+    def extend_data_array(self, log: sc.DataArray) -> None:
+        """Append the values of a 1-D log with a 'time' coord."""
+        self.extend(as_ns(log.coords['time']), self._to_unit(log.data).values)
+
+    def _to_unit(self, var: sc.Variable) -> sc.Variable:
+        return var if self.unit is None else var.to(unit=self.unit, copy=False)
+
+    def clear(self) -> None:
+        """Remove all values, keeping the allocated memory."""
+        self._size = 0
+        self._sorted = True
+
+    def _sort(self) -> None:
+        if self._sorted:
+            return
+        order = np.argsort(self._times[: self._size], kind='stable')
+        self._times[: self._size] = self._times[: self._size][order]
+        self._values[: self._size] = self._values[: self._size][order]
+        self._sorted = True
+
+    @property
+    def times(self) -> np.ndarray:
+        """Sorted time stamps in nanoseconds since the epoch, a view of the store."""
+        self._sort()
+        return self._times[: self._size]
+
+    @property
+    def values(self) -> np.ndarray:
+        """Values in the order of :py:attr:`times`, a view of the store."""
+        self._sort()
+        return self._values[: self._size]
+
+    def to_data_array(self) -> sc.DataArray:
+        """Copy of the log with dim :py:attr:`name` and a datetime 'time' coord."""
+        dims = [self.name]
+        values = self.values
+        # Object columns hold strings, which scipp stores as its own string dtype
+        values = values.tolist() if values.dtype.kind == 'O' else values.copy()
+        return sc.DataArray(
+            sc.array(dims=dims, values=values, unit=self.unit),
+            coords={
+                'time': sc.array(
+                    dims=dims,
+                    values=self.times.astype('datetime64[ns]'),
+                    unit='ns',
+                )
+            },
+        )
+
+    def index(self, time: sc.Variable) -> np.ndarray:
+        """
+        Index of the value valid at each time in :py:attr:`values`,
+        -1 for times before the first value.
+
+        :param time: Datetimes, or integers with a time unit since the epoch,
+          such as the pulse times of streamed events.
+        """
+        return np.searchsorted(self.times, as_ns(time), side='right') - 1
+
+    def value_at(self, time: sc.Variable, *, fill: Any = None) -> sc.Variable:
+        """
+        The value valid at each time, i.e., the latest value at or before it.
+
+        :param time: See :py:meth:`index`.
+        :param fill: Value for times before the first value. Defaults to NaN,
+          which requires floating-point values.
+        """
+        index = self.index(time)
+        values = self.values[np.maximum(index, 0)] if len(self) else None
+        before = index < 0
+        if fill is None and np.any(before):
+            if self._values.dtype.kind != 'f':
+                raise ValueError(
+                    f'Log {self.name} has no value before some of the times, '
+                    'pass a fill value.'
+                )
+            fill = np.nan
+        if values is None:
+            values = np.full(index.shape, fill, dtype=self._values.dtype)
+        elif np.any(before):
+            values = np.where(before, fill, values)
+        return sc.array(dims=time.dims, values=values, unit=self.unit)
+
+    def in_range(
+        self,
+        time: sc.Variable,
+        low: Optional[sc.Variable] = None,
+        high: Optional[sc.Variable] = None,
+    ) -> sc.Variable:
+        """
+        True where the value valid at a time is in ``[low, high)``.
+
+        Times before the first value are never in range.
+        The range is evaluated once per value of the log, not per time.
+
+        :param time: See :py:meth:`index`.
+        :param low: Lower bound, unbounded if None.
+        :param high: Upper bound, unbounded if None.
+        """
+        accepted = np.ones(len(self) + 1, dtype=bool)
+        accepted[0] = False
+        if low is not None:
+            accepted[1:] &= self.values >= self._to_unit(low).value
+        if high is not None:
+            accepted[1:] &= self.values < self._to_unit(high).value
+        return sc.array(dims=time.dims, values=accepted[self.index(time) + 1])
+
+    def mask_events(
+        self,
+        da: sc.DataArray,
+        low: Optional[sc.Variable] = None,
+        high: Optional[sc.Variable] = None,
+        *,
+        time: str = 'pulse_time',
+        name: Optional[str] = None,
+    ) -> sc.DataArray:
+        """
+        Mask events for which the log value is outside ``[low, high)``.
+
+        :param da: Table of events with dim 'event', or binned events.
+        :param low: Lower bound, unbounded if None.
+        :param high: Upper bound, unbounded if None.
+        :param time: Name of the coord holding the time of each event, e.g.,
+          'pulse_time' for streamed events. For binned data where this is a coord
+          of the bins rather than of the events, e.g., 'event_time_zero' of
+          NXevent_data, whole bins are masked.
+        :param name: Name of the mask, defaults to the name of the log.
+        :return: Shallow copy of da with the mask.
+        """
+        name = self.name if name is None else name
+        da = da.copy(deep=False)
+        if da.bins is None or time in da.coords:
+            da.masks[name] = ~self.in_range(da.coords[time], low, high)
+            return da
+        constituents = da.bins.constituents
+        events = constituents['data'].copy(deep=False)
+        events.masks[name] = ~self.in_range(events.coords[time], low, high)
+        da.data = sc.bins(**{**constituents, 'data': events})
+        return da
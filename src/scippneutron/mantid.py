@@ -6,6 +6,7 @@ import os
 import re
 import uuid
 import warnings
+from collections import deque
 from contextlib import contextmanager
 from copy import deepcopy
 from pathlib import Path
@@ -15,7 +16,7 @@ import numpy as np
 import scipp as sc
 from scipp.core.util import VisibleDeprecationWarning
 
-from ._utils import get_attrs
+from ._utils import as_ns, get_attrs, is_unit_weights
 
 
 @contextmanager
@@ -279,17 +280,17 @@ def _rot_from_vectors(vec1, vec2):
 
 def get_detector_pos(ws, spectrum_dim):
     nHist = ws.getNumberHistograms()
-    pos = np.zeros([nHist, 3])
 
-    spec_info = ws.spectrumInfo()
-    for i in range(nHist):
-        if spec_info.hasDetectors(i):
-            p = spec_info.position(i)
-            pos[i, 0] = p.X()
-            pos[i, 1] = p.Y()
-            pos[i, 2] = p.Z()
-        else:
-            pos[i, :] = [np.nan, np.nan, np.nan]
+    def position(spec):
+        if not spec.hasDetectors:
+            return np.nan, np.nan, np.nan
+        p = spec.position
+        return p.X(), p.Y(), p.Z()
+
+    # SpectrumInfo has no bulk accessors in Mantid's Python API,
+    # so positions are gathered in a single pass over its items
+    pos = np.array([position(spec) for spec in ws.spectrumInfo()], dtype=np.float64)
+    pos = pos.reshape(nHist, 3)
     return sc.vectors(dims=[spectrum_dim], values=pos, unit=sc.units.m)
 
 
@@ -729,27 +730,19 @@ def convert_Workspace2D_to_data_group(
     return res
 
 
-def _contains_weighted_events(spectrum) -> bool:
-    from mantid.api import EventType
-
-    return spectrum.getEventType() in (EventType.WEIGHTED, EventType.WEIGHTED_NOTIME)
-
-
-def convert_EventWorkspace_to_data_array(
-    ws, load_pulse_times=True, advanced_geometry=False, load_run_logs=True, **ignored
-):
-    warnings.warn(
-        'convert_EventWorkspace_to_data_array is deprecated in favor of '
-        'convert_EventWorkspace_to_data_group.',
-        VisibleDeprecationWarning,
-        stacklevel=4,
-    )
+def _extract_events(ws, spec_dim, dim, unit, data_unit, load_pulse_times):
+    """
+    Copy the events of all spectra into preallocated event columns.
 
-    dim, unit = validate_and_get_unit(ws.getAxis(0).getUnit())
-    spec_dim, spec_coord = init_spec_axis(ws)
-    nHist = ws.getNumberHistograms()
-    _, data_unit = validate_and_get_unit(ws.YUnit(), allow_empty=True)
+    Bin begins and ends are computed from a cumulative sum of the number of
+    events per spectrum, the events of each spectrum are then written to their
+    range of numpy views of the columns, skipping spectra without events.
+    Mantid's Python API only exposes the events of one EventList at a time,
+    so a loop over spectra remains, but no loop over events.
+    """
+    from mantid.api import EventType
 
+    n_hist = ws.getNumberHistograms()
     n_event = ws.getNumberEvents()
     coord = sc.empty(dims=['event'], shape=[n_event], unit=unit, dtype=sc.DType.float64)
     weights = sc.ones(
@@ -767,35 +760,60 @@ def convert_EventWorkspace_to_data_array(
         else None
     )
 
-    begins = sc.zeros(
-        dims=[spec_dim, dim], shape=[nHist, 1], dtype=sc.DType.int64, unit=None
+    sizes = np.fromiter(
+        (ws.getSpectrum(i).getNumberEvents() for i in range(n_hist)),
+        dtype=np.int64,
+        count=n_hist,
     )
-    ends = begins.copy()
+    ends_values = np.cumsum(sizes)
+    begins_values = ends_values - sizes
+    begins = sc.array(
+        dims=[spec_dim, dim], values=begins_values.reshape(n_hist, 1), unit=None
+    )
+    ends = sc.array(
+        dims=[spec_dim, dim], values=ends_values.reshape(n_hist, 1), unit=None
+    )
+
     if n_event > 0:  # Skip expensive loop if there are no events
-        current = 0
-        for i in range(nHist):
-            sp = ws.getSpectrum(i)
-            size = sp.getNumberEvents()
-            begins.values[i] = current
-            ends.values[i] = current + size
-            if size == 0:  # Skip expensive getters
-                continue
-            coord['event', current : current + size].values = sp.getTofs()
+        # Writing through numpy views avoids creating a scipp slice per spectrum
+        tof_values = coord.values
+        weight_values = weights.values
+        weight_variances = weights.variances
+        pulse_time_values = pulse_times.values if load_pulse_times else None
+        weighted = (EventType.WEIGHTED, EventType.WEIGHTED_NOTIME)
+        for i in np.flatnonzero(sizes):
+            sp = ws.getSpectrum(int(i))
+            event_range = slice(begins_values[i], ends_values[i])
+            tof_values[event_range] = sp.getTofs()
             if load_pulse_times:
-                pulse_times[
-                    'event', current : current + size
-                ].values = sp.getPulseTimesAsNumpy()
-            if _contains_weighted_events(sp):
-                weights['event', current : current + size].values = sp.getWeights()
-                weights[
-                    'event', current : current + size
-                ].variances = sp.getWeightErrors()
-            current += size
+                pulse_time_values[event_range] = sp.getPulseTimesAsNumpy()
+            if sp.getEventType() in weighted:
+                weight_values[event_range] = sp.getWeights()
+                weight_variances[event_range] = sp.getWeightErrors()
 
     proto_events = {'data': weights, 'coords': {dim: coord}}
     if load_pulse_times:
         proto_events["coords"]["pulse_time"] = pulse_times
-    events = sc.DataArray(**proto_events)
+    return begins, ends, sc.DataArray(**proto_events)
+
+
+def convert_EventWorkspace_to_data_array(
+    ws, load_pulse_times=True, advanced_geometry=False, load_run_logs=True, **ignored
+):
+    warnings.warn(
+        'convert_EventWorkspace_to_data_array is deprecated in favor of '
+        'convert_EventWorkspace_to_data_group.',
+        VisibleDeprecationWarning,
+        stacklevel=4,
+    )
+
+    dim, unit = validate_and_get_unit(ws.getAxis(0).getUnit())
+    spec_dim, spec_coord = init_spec_axis(ws)
+    _, data_unit = validate_and_get_unit(ws.YUnit(), allow_empty=True)
+
+    begins, ends, events = _extract_events(
+        ws, spec_dim, dim, unit, data_unit, load_pulse_times
+    )
 
     coords_labs_data = _convert_MatrixWorkspace_info(
         ws, advanced_geometry=advanced_geometry, load_run_logs=load_run_logs
@@ -820,55 +838,11 @@ def convert_EventWorkspace_to_data_group(
 ):
     dim, unit = validate_and_get_unit(ws.getAxis(0).getUnit())
     spec_dim, spec_coord = init_spec_axis(ws)
-    nHist = ws.getNumberHistograms()
     _, data_unit = validate_and_get_unit(ws.YUnit(), allow_empty=True)
 
-    n_event = ws.getNumberEvents()
-    coord = sc.empty(dims=['event'], shape=[n_event], unit=unit, dtype=sc.DType.float64)
-    weights = sc.ones(
-        dims=['event'],
-        shape=[n_event],
-        unit=data_unit,
-        dtype=sc.DType.float32,
-        with_variances=True,
+    begins, ends, events = _extract_events(
+        ws, spec_dim, dim, unit, data_unit, load_pulse_times
     )
-    pulse_times = (
-        sc.empty(
-            dims=['event'], shape=[n_event], dtype=sc.DType.datetime64, unit=sc.units.ns
-        )
-        if load_pulse_times
-        else None
-    )
-
-    begins = sc.zeros(
-        dims=[spec_dim, dim], shape=[nHist, 1], dtype=sc.DType.int64, unit=None
-    )
-    ends = begins.copy()
-    if n_event > 0:  # Skip expensive loop if there are no events
-        current = 0
-        for i in range(nHist):
-            sp = ws.getSpectrum(i)
-            size = sp.getNumberEvents()
-            begins.values[i] = current
-            ends.values[i] = current + size
-            if size == 0:  # Skip expensive getters
-                continue
-            coord['event', current : current + size].values = sp.getTofs()
-            if load_pulse_times:
-                pulse_times[
-                    'event', current : current + size
-                ].values = sp.getPulseTimesAsNumpy()
-            if _contains_weighted_events(sp):
-                weights['event', current : current + size].values = sp.getWeights()
-                weights[
-                    'event', current : current + size
-                ].variances = sp.getWeightErrors()
-            current += size
-
-    proto_events = {'data': weights, 'coords': {dim: coord}}
-    if load_pulse_times:
-        proto_events["coords"]["pulse_time"] = pulse_times
-    events = sc.DataArray(**proto_events)
 
     coords_labs_data = _convert_MatrixWorkspace_info(
         ws, advanced_geometry=advanced_geometry, load_run_logs=load_run_logs
@@ -1449,6 +1423,14 @@ def to_mantid(data, dim, instrument_file=None):
     your data to fit that, otherwise it will not be aligned correctly in the
     Mantid workspace.
 
+    Histograms are converted to a ``Workspace2D``, which is filled from the
+    X, Y, and E buffers of all spectra at once.
+    Binned data with one bin per spectrum, or bins along ``dim`` which are
+    merged, are converted to an ``EventWorkspace``.
+    The events need to have unit weights.
+    Mantid's Python API adds events one at a time, so this is much slower than
+    converting histograms.
+
     :param data: Data to be converted.
     :param dim: Coord to use for Mantid's first axis (X).
     :param instrument_file: Instrument file that will be
@@ -1468,6 +1450,22 @@ def to_mantid(data, dim, instrument_file=None):
             "as detailed in the installation instructions (https://scipp."
             "github.io/getting-started/installation.html)"
         )
+    unitX = validate_dim_and_get_mantid_string(dim)
+    if data.bins is not None:
+        ws = _event_workspace(mantid, data, dim)
+    else:
+        ws = _workspace_2d(mantid, data, dim)
+
+    # Set X-Axis unit
+    ws.getAxis(0).setUnit(unitX)
+
+    if instrument_file is not None:
+        mantid.LoadInstrument(ws, FileName=instrument_file, RewriteSpectraMap=True)
+
+    return ws
+
+
+def _workspace_2d(mantid, data, dim):
     x = data.coords[dim].values
     y = data.values
     e = data.variances
@@ -1478,13 +1476,8 @@ def to_mantid(data, dim, instrument_file=None):
     e = np.sqrt(e) if e is not None else np.sqrt(y)
 
     # Convert a single array (e.g. single spectra) into 2d format
-    if len(y.shape) == 1:
-        y = np.array([y])
-
-    if len(e.shape) == 1:
-        e = np.array([e])
-
-    unitX = validate_dim_and_get_mantid_string(dim)
+    y = y.reshape(-1, y.shape[-1])
+    e = e.reshape(-1, e.shape[-1])
 
     nspec = y.shape[0]
     if len(x.shape) == 1:
@@ -1492,27 +1485,82 @@ def to_mantid(data, dim, instrument_file=None):
         # a 1:1 mapping so expand this out
         x = np.broadcast_to(x, shape=(nspec, len(x)))
 
-    nbins = x.shape[1]
-    nitems = y.shape[1]
-
-    ws = mantid.WorkspaceFactory.create(
-        "Workspace2D", NVectors=nspec, XLength=nbins, YLength=nitems
+    # CreateWorkspace copies the contiguous buffers of all spectra in one go,
+    # StoreInADS=False keeps it out of the AnalysisDataService
+    return mantid.CreateWorkspace(
+        DataX=np.ascontiguousarray(x, dtype=np.float64).ravel(),
+        DataY=np.ascontiguousarray(y, dtype=np.float64).ravel(),
+        DataE=np.ascontiguousarray(e, dtype=np.float64).ravel(),
+        NSpec=nspec,
+        Distribution=data.unit != sc.units.counts,
+        StoreInADS=False,
     )
-    if data.unit != sc.units.counts:
-        ws.setDistribution(True)
 
-    for i in range(nspec):
-        ws.setX(i, x[i])
-        ws.setY(i, y[i])
-        ws.setE(i, e[i])
 
-    # Set X-Axis unit
-    ws.getAxis(0).setUnit(unitX)
+# Origin of Mantid's DateAndTime in ns since the Unix epoch
+_MANTID_EPOCH_NS = int(np.datetime64('1990-01-01T00:00:00', 'ns').astype(np.int64))
 
-    if instrument_file is not None:
-        mantid.LoadInstrument(ws, FileName=instrument_file, RewriteSpectraMap=True)
 
-    return ws
+def _event_workspace(mantid, data, dim):
+    from mantid.kernel import DateAndTime
+
+    if dim in data.dims:
+        data = data.bins.concat(dim)
+    if data.ndim == 0:
+        data = sc.concat([data], 'spectrum')
+    if data.ndim != 1:
+        raise ValueError(
+            "Can only convert binned data with one dimension of spectra to an "
+            f"EventWorkspace, got dims {data.dims}."
+        )
+    constituents = data.bins.constituents
+    events = constituents['data']
+    if not is_unit_weights(events.data):
+        raise ValueError(
+            "Can only convert events with unit weights to an EventWorkspace, "
+            "histogram the data instead."
+        )
+    begin = constituents['begin'].values
+    end = begin + data.bins.size().values
+    tof = events.coords[dim].to(dtype='float64', copy=False).values
+    if 'pulse_time' in events.coords:
+        pulse_time = as_ns(events.coords['pulse_time']) - _MANTID_EPOCH_NS
+    else:
+        pulse_time = np.zeros(len(tof), dtype=np.int64)
+
+    nspec = data.shape[0]
+    ws = mantid.WorkspaceFactory.create(
+        "EventWorkspace", NVectors=nspec, XLength=2, YLength=1
+    )
+    # Mantid's Python API only adds single events, so the calls are driven by
+    # map, in C, rather than by a Python loop over the events.
+    tof = tof.tolist()
+    pulse_time = list(map(DateAndTime, pulse_time.tolist()))
+    for i in np.flatnonzero(end > begin).tolist():
+        event_range = slice(begin[i], end[i])
+        deque(
+            map(
+                ws.getSpectrum(i).addEventQuickly,
+                tof[event_range],
+                pulse_time[event_range],
+            ),
+            maxlen=0,
+        )
+    if dim in data.coords:
+        edges = data.coords[dim]
+        x_min, x_max = float(edges.min().value), float(edges.max().value)
+    elif tof:
+        x_min, x_max = min(tof), max(tof)
+    else:
+        x_min, x_max = 0.0, 1.0
+    # A single bin for all spectra, set in one call rather than per spectrum
+    width = x_max - x_min if x_max > x_min else 1.0
+    return mantid.Rebin(
+        InputWorkspace=ws,
+        Params=[x_min, width, x_min + width],
+        PreserveEvents=True,
+        StoreInADS=False,
+    )
 
 
 def _table_to_data_array(table, key, value, stddev):
@@ -9,9 +9,11 @@ Specifics for time-of-flight neutron-scattering data reduction, including coordi
 
 from . import chopper_cascade, unwrap
 from .diagram import TimeDistanceDiagram
+from .unwrap_plan import UnwrapPlan
 
 __all__ = [
     'chopper_cascade',
     'unwrap',
     'TimeDistanceDiagram',
+    'UnwrapPlan',
 ]
@@ -9,8 +9,9 @@ See :py:class:`FrameSequence` for the main entry point.
 """
 from __future__ import annotations
 
+import warnings
 from dataclasses import dataclass
-from typing import Any, List, Optional, Union
+from typing import Any, Callable, List, Mapping, Optional, Tuple, Union
 
 import numpy as np
 import scipp as sc
@@ -179,16 +180,9 @@ class Frame:
                 f'{self.distance}'
             )
         frame = self.propagate_to(chopper.distance)
-
-        # A chopper can have multiple openings, call _chop for each of them. The result
-        # is the union of the resulting subframes.
-        chopped = Frame(distance=frame.distance, subframes=[])
-        for subframe in frame.subframes:
-            for open, close in zip(chopper.time_open, chopper.time_close):
-                if (tmp := _chop(subframe, open, close_to_open=True)) is not None:
-                    if (tmp := _chop(tmp, close, close_to_open=False)) is not None:
-                        chopped.subframes.append(tmp)
-        return chopped
+        if not frame.subframes:
+            return frame
+        return FrameBatch.from_frame(frame).chop(chopper)[0]
 
     def bounds(self) -> sc.DataGroup:
         """The bounds of the frame, i.e., the global min and max time and wavelength."""
@@ -327,6 +321,80 @@ class FrameSequence:
 
         return frame_before_detector.propagate_to(distance)
 
+    def at(self, distances: sc.Variable) -> sc.DataGroup:
+        """
+        Evaluate the frame sequence at many distances at once.
+
+        This is equivalent to getting the frame at each of the distances, see
+        :py:meth:`__getitem__`, and computing its bounds and subbounds, but the
+        subframes of each frame of the sequence are propagated to all distances in
+        one go.
+
+        Parameters
+        ----------
+        distances:
+            Distances to evaluate the frames at, of any shape.
+
+        Returns
+        -------
+        :
+            Data group with the vertices of the subframes, 'time' and 'wavelength'
+            with dims ``[*distances.dims, 'subframe', 'vertex']``, as well as
+            'bounds' and 'subbounds', see :py:meth:`Frame.bounds` and
+            :py:meth:`Frame.subbounds`, with the dims of distances prepended.
+            Frames differ in their number of subframes and vertices, missing
+            values are NaN.
+        """
+        distance = np.asarray(distances.to(unit='m', dtype='float64').values).ravel()
+        frame_distance = np.array(
+            [frame.distance.to(unit='m', dtype='float64').value for frame in self]
+        )
+        # As in __getitem__, use the last frame before the first frame that is
+        # further away than the distance
+        further = frame_distance[np.newaxis, :] > distance[:, np.newaxis]
+        before = np.where(further.any(axis=1), further.argmax(axis=1), len(self)) - 1
+        if np.any(before < 0):
+            raise ValueError(
+                f'Distances {distances} must not be smaller than the distance of '
+                'the first frame.'
+            )
+
+        propagated = []
+        for index in np.unique(before):
+            batch = FrameBatch.from_frame(self.frames[index])
+            dims = ['subframe', batch.dim]
+            inverse_velocity = wavelength_to_inverse_velocity(
+                sc.array(dims=dims, values=batch.wavelength, unit='angstrom')
+            ).values
+            rows = np.flatnonzero(before == index)
+            delta = distance[rows] - frame_distance[index]
+            time = batch.time + delta[:, np.newaxis, np.newaxis] * inverse_velocity
+            propagated.append((rows, time, batch.wavelength))
+        n_subframes = max((time.shape[1] for _, time, _ in propagated), default=0)
+        n_vertices = max((time.shape[2] for _, time, _ in propagated), default=0)
+        time = np.full((len(distance), n_subframes, n_vertices), np.nan)
+        wavelength = np.full_like(time, np.nan)
+        for rows, frame_time, frame_wavelength in propagated:
+            _, n_sub, n_vert = frame_time.shape
+            time[rows, :n_sub, :n_vert] = frame_time
+            wavelength[rows, :n_sub, :n_vert] = frame_wavelength
+
+        shape = distances.shape
+        dims = [*distances.dims, 'subframe', 'vertex']
+        return sc.DataGroup(
+            distance=distances,
+            time=sc.array(
+                dims=dims, values=time.reshape(shape + time.shape[1:]), unit='s'
+            ),
+            wavelength=sc.array(
+                dims=dims,
+                values=wavelength.reshape(shape + time.shape[1:]),
+                unit='angstrom',
+            ),
+            bounds=_stacked_bounds(time, wavelength, distances),
+            subbounds=_stacked_subbounds(time, wavelength, distances),
+        )
+
     def propagate_to(self, distance: sc.Variable) -> FrameSequence:
         """
         Propagate the frame sequence to a distance, adding a new frame.
@@ -505,25 +573,349 @@ class Chopper:
         )
 
 
-def _chop(
-    frame: Subframe, time: sc.Variable, close_to_open: bool
-) -> Optional[Subframe]:
-    inside = frame.time >= time if close_to_open else frame.time <= time
-    output = []
-    for i in range(len(frame.time)):
-        # Note how j wraps around to 0
-        j = (i + 1) % len(frame.time)
-        inside_i = inside[i]
-        inside_j = inside[j]
-        if inside_i:
-            output.append((frame.time[i], frame.wavelength[i]))
-        if inside_i != inside_j:
-            # Intersection
-            t = (time - frame.time[i]) / (frame.time[j] - frame.time[i])
-            v = (1 - t) * frame.wavelength[i] + t * frame.wavelength[j]
-            output.append((time, v))
-    if not output:
-        return None
-    time = sc.concat([t for t, _ in output], dim=frame.time.dim)
-    wavelength = sc.concat([v for _, v in output], dim=frame.wavelength.dim)
-    return Subframe(time=time, wavelength=wavelength)
+@dataclass
+class FrameBatch:
+    """
+    Frames for many chopper settings, e.g., a scan of chopper phases, with all
+    subframes stored in padded NumPy arrays so that they are chopped and propagated
+    together.
+
+    Use :py:func:`chop_scan` to create a batch by applying a chopper cascade for many
+    settings at once.
+    """
+
+    distance: sc.Variable
+    """Distance of all frames."""
+    config: np.ndarray
+    """Index of the frame, i.e., the chopper setting, of each subframe."""
+    time: np.ndarray
+    """Time of the vertices of each subframe in s, padded with NaN."""
+    wavelength: np.ndarray
+    """Wavelength of the vertices of each subframe in angstrom, padded with NaN."""
+    n_vertices: np.ndarray
+    """Number of vertices of each subframe."""
+    n_configs: int
+    """Number of frames."""
+    dim: str = 'vertex'
+    """Dim of the vertices of subframes."""
+
+    @staticmethod
+    def from_frame(frame: Frame, n_configs: int = 1) -> FrameBatch:
+        """Return a batch with n_configs copies of frame."""
+        n_vertices = np.array([len(sub.time) for sub in frame.subframes], dtype=int)
+        width = n_vertices.max(initial=1)
+        time = np.full((len(n_vertices), width), np.nan)
+        wavelength = np.full((len(n_vertices), width), np.nan)
+        for i, subframe in enumerate(frame.subframes):
+            time[i, : n_vertices[i]] = subframe.time.values
+            wavelength[i, : n_vertices[i]] = subframe.wavelength.values
+        dim = frame.subframes[0].time.dim if frame.subframes else 'vertex'
+        return FrameBatch(
+            distance=frame.distance,
+            config=np.repeat(np.arange(n_configs), len(n_vertices)),
+            time=np.tile(time, (n_configs, 1)),
+            wavelength=np.tile(wavelength, (n_configs, 1)),
+            n_vertices=np.tile(n_vertices, n_configs),
+            n_configs=n_configs,
+            dim=dim,
+        )
+
+    def __len__(self) -> int:
+        """Number of frames."""
+        return self.n_configs
+
+    def __getitem__(self, index: int) -> Frame:
+        """Get the frame of a chopper setting."""
+        rows = np.flatnonzero(self.config == index)
+        subframes = [
+            Subframe(
+                time=sc.array(dims=[self.dim], values=self.time[i, :n], unit='s'),
+                wavelength=sc.array(
+                    dims=[self.dim], values=self.wavelength[i, :n], unit='angstrom'
+                ),
+            )
+            for i, n in zip(rows, self.n_vertices[rows])
+        ]
+        return Frame(distance=self.distance, subframes=subframes)
+
+    def propagate_to(self, distance: sc.Variable) -> FrameBatch:
+        """
+        Compute new frames by propagating to a distance, see
+        :py:meth:`Frame.propagate_to`.
+        """
+        dims = ['subframe', self.dim]
+        time = propagate_times(
+            sc.array(dims=dims, values=self.time, unit='s'),
+            sc.array(dims=dims, values=self.wavelength, unit='angstrom'),
+            distance - self.distance,
+        )
+        return FrameBatch(
+            distance=distance,
+            config=self.config,
+            time=time.to(unit='s').values,
+            wavelength=self.wavelength,
+            n_vertices=self.n_vertices,
+            n_configs=self.n_configs,
+            dim=self.dim,
+        )
+
+    def chop(self, chopper: Chopper, delay: Optional[sc.Variable] = None) -> FrameBatch:
+        """
+        Compute new frames by applying a chopper, see :py:meth:`Frame.chop`.
+
+        Parameters
+        ----------
+        chopper:
+            Chopper to apply.
+        delay:
+            Time added to the opening and closing times of the chopper, with one
+            value for each frame. If None, the chopper is the same for all frames.
+        """
+        if chopper.distance < self.distance:
+            raise ValueError(
+                f'Chopper distance {chopper.distance} is smaller than frame distance '
+                f'{self.distance}'
+            )
+        batch = (
+            self
+            if sc.identical(chopper.distance, self.distance)
+            else self.propagate_to(chopper.distance)
+        )
+        time_open = chopper.time_open.to(unit='s', dtype='float64').values
+        time_close = chopper.time_close.to(unit='s', dtype='float64').values
+        time_open = np.broadcast_to(time_open, (self.n_configs, len(time_open)))
+        time_close = np.broadcast_to(time_close, (self.n_configs, len(time_close)))
+        if delay is not None:
+            shift = delay.to(unit='s', dtype='float64').values[:, np.newaxis]
+            time_open = time_open + shift
+            time_close = time_close + shift
+
+        # A chopper can have multiple openings, each subframe is clipped by each of
+        # them. The result is the union of the resulting subframes.
+        n_openings = time_open.shape[1]
+        time, wavelength, n_vertices = _clip(
+            np.repeat(batch.time, n_openings, axis=0),
+            np.repeat(batch.wavelength, n_openings, axis=0),
+            np.repeat(batch.n_vertices, n_openings),
+            time_open[batch.config].ravel(),
+            close_to_open=True,
+        )
+        time, wavelength, n_vertices = _clip(
+            time,
+            wavelength,
+            n_vertices,
+            time_close[batch.config].ravel(),
+            close_to_open=False,
+        )
+        keep = n_vertices > 0
+        return FrameBatch(
+            distance=batch.distance,
+            config=np.repeat(batch.config, n_openings)[keep],
+            time=time[keep],
+            wavelength=wavelength[keep],
+            n_vertices=n_vertices[keep],
+            n_configs=self.n_configs,
+            dim=self.dim,
+        )
+
+    def bounds(self, dim: str = 'config') -> sc.DataGroup:
+        """
+        The bounds of each frame, see :py:meth:`Frame.bounds`.
+
+        Frames without subframes have NaN bounds.
+        """
+
+        def reduce(values: np.ndarray, ufunc: np.ufunc, initial: float) -> np.ndarray:
+            out = np.full(self.n_configs, initial)
+            ufunc.at(out, self.config, values)
+            has_subframes = np.isin(np.arange(self.n_configs), self.config)
+            return np.where(has_subframes, out, np.nan)
+
+        start = reduce(np.nanmin(self.time, axis=1), np.minimum, np.inf)
+        end = reduce(np.nanmax(self.time, axis=1), np.maximum, -np.inf)
+        wav_start = reduce(np.nanmin(self.wavelength, axis=1), np.minimum, np.inf)
+        wav_end = reduce(np.nanmax(self.wavelength, axis=1), np.maximum, -np.inf)
+        return sc.DataGroup(
+            time=sc.array(
+                dims=[dim, 'bound'], values=np.stack([start, end], axis=1), unit='s'
+            ),
+            wavelength=sc.array(
+                dims=[dim, 'bound'],
+                values=np.stack([wav_start, wav_end], axis=1),
+                unit='angstrom',
+            ),
+        )
+
+
+def chop_scan(
+    frame: Frame, choppers: Mapping[str, Chopper], delays: Mapping[str, sc.Variable]
+) -> FrameBatch:
+    """
+    Apply a chopper cascade for many chopper settings at once.
+
+    Parameters
+    ----------
+    frame:
+        Frame to chop, e.g., the first frame of
+        :py:meth:`FrameSequence.from_source_pulse`.
+    choppers:
+        Choppers to apply. They are sorted by their distance and applied in order.
+    delays:
+        Time added to the opening and closing times of some of the choppers, e.g.,
+        ``phase / (2 * pi * frequency)`` for a scan of chopper phases. All must be
+        1-D with the same dim and length, the number of chopper settings.
+
+    Returns
+    -------
+    :
+        The frames after the last chopper, one for each chopper setting.
+    """
+    if not delays:
+        raise ValueError('At least one chopper delay is required.')
+    sizes = {tuple(delay.sizes.items()) for delay in delays.values()}
+    if len(sizes) != 1 or any(delay.ndim != 1 for delay in delays.values()):
+        raise sc.DimensionError(
+            f'Delays must be 1-D with the same dim and length, got {sizes}'
+        )
+    n_configs = len(next(iter(delays.values())))
+    batch = FrameBatch.from_frame(frame, n_configs)
+    for name, chopper in sorted(choppers.items(), key=lambda x: x[1].distance):
+        batch = batch.chop(chopper, delays.get(name))
+    return batch
+
+
+def _nanreduce(func: Callable, values: np.ndarray, axis) -> np.ndarray:
+    with warnings.catch_warnings():
+        # Missing subframes and frames without subframes are all-NaN
+        warnings.simplefilter('ignore', category=RuntimeWarning)
+        return func(values, axis=axis)
+
+
+def _bounds_group(
+    time: Tuple[np.ndarray, np.ndarray],
+    wavelength: Tuple[np.ndarray, np.ndarray],
+    dims: List[str],
+    shape: Tuple[int, ...],
+) -> sc.DataGroup:
+    def stack(start: np.ndarray, end: np.ndarray) -> np.ndarray:
+        values = np.stack([start, end], axis=-1)
+        return values.reshape(shape + values.shape[1:])
+
+    return sc.DataGroup(
+        time=sc.array(dims=dims, values=stack(*time), unit='s'),
+        wavelength=sc.array(dims=dims, values=stack(*wavelength), unit='angstrom'),
+    )
+
+
+def _stacked_bounds(
+    time: np.ndarray, wavelength: np.ndarray, distances: sc.Variable
+) -> sc.DataGroup:
+    return _bounds_group(
+        (_nanreduce(np.nanmin, time, (1, 2)), _nanreduce(np.nanmax, time, (1, 2))),
+        (
+            _nanreduce(np.nanmin, wavelength, (1, 2)),
+            _nanreduce(np.nanmax, wavelength, (1, 2)),
+        ),
+        dims=[*distances.dims, 'bound'],
+        shape=distances.shape,
+    )
+
+
+def _stacked_subbounds(
+    time: np.ndarray, wavelength: np.ndarray, distances: sc.Variable
+) -> sc.DataGroup:
+    """Vectorised version of :py:meth:`Frame.subbounds` for each distance."""
+    start = _nanreduce(np.nanmin, time, 2)
+    end = _nanreduce(np.nanmax, time, 2)
+    wav_start = _nanreduce(np.nanmin, wavelength, 2)
+    wav_end = _nanreduce(np.nanmax, wavelength, 2)
+    valid = ~np.isnan(start)
+    regular = ((time == start[..., None]) & (wavelength == wav_start[..., None])).any(
+        axis=2
+    ) & ((time == end[..., None]) & (wavelength == wav_end[..., None])).any(axis=2)
+    if not np.all(regular[valid]):
+        raise NotImplementedError(
+            'Subframes must be regular, i.e., min/max time and wavelength must '
+            'coincide.'
+        )
+
+    # Merge subframes which overlap in time, in order of their start time
+    order = np.argsort(np.where(valid, start, np.inf), axis=1, kind='stable')
+    start, end, wav_start, wav_end, valid = (
+        np.take_along_axis(values, order, axis=1)
+        for values in (start, end, wav_start, wav_end, valid)
+    )
+    current_end = np.maximum.accumulate(np.where(valid, end, -np.inf), axis=1)
+    previous_end = np.concatenate(
+        [np.full((len(start), 1), -np.inf), current_end[:, :-1]], axis=1
+    )
+    new_group = valid & (start > previous_end)
+    group = np.cumsum(new_group, axis=1) - 1
+    n_groups = max(new_group.sum(axis=1).max(initial=0), 1)
+
+    rows = np.broadcast_to(np.arange(len(start))[:, np.newaxis], start.shape)
+    merged = np.full((4, len(start), n_groups), np.nan)
+    merged[0][rows[new_group], group[new_group]] = start[new_group]
+    merged[2][rows[new_group], group[new_group]] = wav_start[new_group]
+    for i, values in ((1, end), (3, wav_end)):
+        out = np.full((len(start), n_groups), -np.inf)
+        np.maximum.at(out, (rows[valid], group[valid]), values[valid])
+        merged[i] = np.where(np.isfinite(merged[0]), out, np.nan)
+    return _bounds_group(
+        (merged[0], merged[1]),
+        (merged[2], merged[3]),
+        dims=[*distances.dims, 'subframe', 'bound'],
+        shape=distances.shape,
+    )
+
+
+def present_subframes(subbounds: sc.DataGroup) -> sc.DataGroup:
+    """Drop the NaN padding of a single entry of the subbounds of FrameSequence.at."""
+    present = ~sc.isnan(subbounds['time']['bound', 0])
+    return subbounds['subframe', : int(present.sum().value)]
+
+
+def _clip(
+    time: np.ndarray,
+    wavelength: np.ndarray,
+    n_vertices: np.ndarray,
+    threshold: np.ndarray,
+    close_to_open: bool,
+) -> Tuple[np.ndarray, np.ndarray, np.ndarray]:
+    """
+    Clip many polygons in time and wavelength, one threshold time for each of them.
+
+    Each row of time and wavelength holds the vertices of a polygon, padded at the
+    end. The output of each input vertex is that vertex, if it is inside, followed by
+    the intersection with the edge to the next vertex, if the edge is crossing the
+    threshold. Empty slots are then removed.
+    """
+    n_rows, width = time.shape
+    index = np.arange(width)
+    valid = index < n_vertices[:, np.newaxis]
+    # Note how the next vertex wraps around to 0
+    next_index = np.where(index + 1 < n_vertices[:, np.newaxis], index + 1, 0)
+    next_time = np.take_along_axis(time, next_index, axis=1)
+    next_wavelength = np.take_along_axis(wavelength, next_index, axis=1)
+    threshold = threshold[:, np.newaxis]
+    inside = time >= threshold if close_to_open else time <= threshold
+    inside &= valid
+    crossing = valid & (inside != np.take_along_axis(inside, next_index, axis=1))
+    with np.errstate(divide='ignore', invalid='ignore'):
+        t = (threshold - time) / (next_time - time)
+        v = (1 - t) * wavelength + t * next_wavelength
+
+    shape = (n_rows, 2 * width)
+    keep = np.stack([inside, crossing], axis=2).reshape(shape)
+    out_time = np.stack([time, np.broadcast_to(threshold, time.shape)], axis=2)
+    out_time = out_time.reshape(shape)
+    out_wavelength = np.stack([wavelength, v], axis=2).reshape(shape)
+
+    n_out = keep.sum(axis=1)
+    rows = np.broadcast_to(np.arange(n_rows)[:, np.newaxis], shape)[keep]
+    position = (np.cumsum(keep, axis=1) - 1)[keep]
+    new_time = np.full((n_rows, n_out.max(initial=1)), np.nan)
+    new_wavelength = np.full((n_rows, n_out.max(initial=1)), np.nan)
+    new_time[rows, position] = out_time[keep]
+    new_wavelength[rows, position] = out_wavelength[keep]
+    return new_time, new_wavelength, n_out
@@ -12,8 +12,9 @@ This provides data in a structure as typically provided in a NeXus file, includi
 """
 from __future__ import annotations
 
-from typing import Optional
+from typing import Iterator, Optional
 
+import numpy as np
 import scipp as sc
 from numpy import random
 
@@ -96,6 +97,24 @@ class FakePulse:
         return self._frames.chop(choppers)
 
 
+def _frame_from_vertices(
+    distance: sc.Variable, time: sc.Variable, wavelength: sc.Variable
+) -> chopper_cascade.Frame:
+    """Frame from a single entry of the vertices of FrameSequence.at."""
+    subframes = []
+    for i in range(time.sizes['subframe']):
+        # Drop the NaN padding of the subframes and vertices
+        n_vertices = int((~sc.isnan(time['subframe', i])).sum().value)
+        if n_vertices:
+            subframes.append(
+                chopper_cascade.Subframe(
+                    time=time['subframe', i]['vertex', :n_vertices],
+                    wavelength=wavelength['subframe', i]['vertex', :n_vertices],
+                )
+            )
+    return chopper_cascade.Frame(distance=distance, subframes=subframes)
+
+
 class FakeBeamline:
     def __init__(
         self,
@@ -130,28 +149,64 @@ class FakeBeamline:
         self._pulse = pulse
         self._choppers = choppers
         self._source = source
-        self._monitors = {
-            key: self._frames[distance] for key, distance in monitors.items()
-        }
-        self.detectors = {
-            key: self._frames[distance] for key, distance in detectors.items()
-        }
+        frames = self._frames_at({**monitors, **detectors})
+        self._monitors = {key: frames[key] for key in monitors}
+        self._detectors = {key: frames[key] for key in detectors}
+        self.detectors = {key: frames[key]['frame'] for key in detectors}
         self._time_of_flight_origin = time_of_flight_origin
 
+    def _frames_at(self, distances: dict[str, sc.Variable]) -> dict[str, sc.DataGroup]:
+        """
+        Evaluate the chopper cascade at all monitors and detectors in one go.
+
+        Each entry holds the frame at the distance as well as its bounds and
+        subbounds.
+        """
+        if not distances:
+            return {}
+        stacked = self._frames.at(
+            sc.concat(
+                [d.to(unit='m', dtype='float64') for d in distances.values()],
+                'beamline_item',
+            )
+        )
+        return {
+            key: sc.DataGroup(
+                distance=distance.to(unit='m'),
+                frame=_frame_from_vertices(
+                    distance.to(unit='m'),
+                    stacked['time']['beamline_item', i],
+                    stacked['wavelength']['beamline_item', i],
+                ),
+                bounds=stacked['bounds']['beamline_item', i],
+                subbounds=chopper_cascade.present_subframes(
+                    stacked['subbounds']['beamline_item', i]
+                ),
+            )
+            for i, (key, distance) in enumerate(distances.items())
+        }
+
     def get_monitor(self, name: str) -> sc.DataGroup:
         frame = self._monitors[name]
         return self._fake_monitor(frame)
 
+    def bulk_events(self, name: str, **kwargs) -> BulkEventGenerator:
+        """
+        Return a generator of large numbers of events for a monitor or detector.
+
+        Keyword arguments are forwarded to :py:class:`BulkEventGenerator`.
+        """
+        frame = {**self._monitors, **self._detectors}[name]
+        return BulkEventGenerator(self._source, frame['subbounds']['time'], **kwargs)
+
     def _split_size(self, size, N):
         base, remainder = divmod(size, N)
         sizes = [base + 1 if i < remainder else base for i in range(N)]
         return sizes
 
-    def _fake_monitor(
-        self, frame: chopper_cascade.Frame
-    ) -> tuple[sc.DataArray, sc.DataArray]:
-        bounds = frame.bounds()['time']
-        subbounds = frame.subbounds()['time']
+    def _fake_monitor(self, frame: sc.DataGroup) -> tuple[sc.DataArray, sc.DataArray]:
+        bounds = frame['bounds']['time']
+        subbounds = frame['subbounds']['time']
         subframes = subbounds.sizes['subframe']
 
         sizes = sc.array(
@@ -223,12 +278,151 @@ class FakeBeamline:
             + offset_to_tof.to(dtype='int64', unit='ns'),
         )
         if self._time_of_flight_origin is None:
-            unwrapped.coords['Ltotal'] = frame.distance
+            unwrapped.coords['Ltotal'] = frame['distance']
         else:
-            unwrapped.coords['Ltotal'] = frame.distance - source_chopper.distance
+            unwrapped.coords['Ltotal'] = frame['distance'] - source_chopper.distance
         return wrapped, unwrapped
 
 
+class BulkEventGenerator:
+    """
+    Vectorised generator of fake events, for load testing.
+
+    Events are distributed over the subframes like in
+    :py:meth:`FakeBeamline.get_monitor`, but all events of a chunk of pulses are drawn
+    at once. Every chunk uses its own random stream, derived from the seed and the
+    index of the chunk. Chunks are thus reproducible and can be generated
+    independently of each other, e.g., by multiple processes each generating a range
+    of chunks.
+    """
+
+    def __init__(
+        self,
+        source: FakeSource,
+        subbounds: sc.Variable,
+        *,
+        pulses_per_chunk: int = 1000,
+        events_per_pulse: Optional[int] = None,
+        n_pixels: Optional[int] = None,
+        seed: int = 0,
+    ):
+        """
+        Return a bulk event generator.
+
+        Parameters
+        ----------
+        source:
+            Fake source, defining the pulse times.
+        subbounds:
+            Time bounds of the subframes, with dims 'subframe' and 'bound', see
+            :py:meth:`chopper_cascade.Frame.subbounds`.
+        pulses_per_chunk:
+            Number of pulses of each chunk.
+        events_per_pulse:
+            Maximum number of events per pulse. Defaults to that of the source.
+        n_pixels:
+            If given, events get a random 'event_id' in ``[0, n_pixels)``.
+        seed:
+            Seed of the random streams of all chunks.
+        """
+        subbounds = subbounds.to(unit='s', dtype='float64')
+        self._start = subbounds['bound', 0].values
+        self._width = (subbounds['bound', 1] - subbounds['bound', 0]).values
+        self._period = source.pulse_period.to(unit='s').value
+        self._t0 = source.t0
+        self._pulses_per_chunk = pulses_per_chunk
+        self._events_per_pulse = (
+            source.events_per_pulse if events_per_pulse is None else events_per_pulse
+        )
+        self._n_pixels = n_pixels
+        self._seed = seed
+
+    @property
+    def n_chunks(self) -> int:
+        return -(-len(self._t0) // self._pulses_per_chunk)
+
+    def _draw(
+        self, index: int
+    ) -> tuple[slice, np.ndarray, np.ndarray, Optional[np.ndarray]]:
+        if not 0 <= index < self.n_chunks:
+            raise IndexError(f'Chunk {index} out of range for {self.n_chunks} chunks.')
+        begin = index * self._pulses_per_chunk
+        pulses = slice(begin, min(begin + self._pulses_per_chunk, len(self._t0)))
+        rng = random.default_rng(random.SeedSequence(self._seed, spawn_key=(index,)))
+        sizes = rng.integers(0, self._events_per_pulse, size=pulses.stop - begin)
+        n_events = int(sizes.sum())
+        subframe = rng.integers(0, len(self._start), size=n_events)
+        time_offset = self._start[subframe]
+        time_offset += rng.random(n_events) * self._width[subframe]
+        event_id = (
+            None
+            if self._n_pixels is None
+            else rng.integers(0, self._n_pixels, size=n_events, dtype=np.int32)
+        )
+        return pulses, sizes, time_offset % self._period, event_id
+
+    def chunk(self, index: int) -> sc.DataArray:
+        """
+        Return the events of a chunk, binned by pulse, with event_time_offset and
+        event_time_zero as :py:meth:`FakeBeamline.get_monitor`.
+        """
+        pulses, sizes, event_time_offset, event_id = self._draw(index)
+        coords = {
+            'event_time_offset': sc.array(
+                dims=['event'], values=event_time_offset, unit='s'
+            )
+        }
+        if event_id is not None:
+            coords['event_id'] = sc.array(dims=['event'], values=event_id, unit=None)
+        events = sc.DataArray(
+            sc.ones(sizes={'event': len(event_time_offset)}, unit='counts'),
+            coords=coords,
+        )
+        begin = sc.array(dims=['pulse'], values=np.cumsum(sizes) - sizes, unit=None)
+        return sc.DataArray(
+            sc.bins(begin=begin, dim='event', data=events),
+            coords={'event_time_zero': self._t0['pulse', pulses]},
+        )
+
+    def chunks(
+        self, start: int = 0, stop: Optional[int] = None
+    ) -> Iterator[sc.DataArray]:
+        """Yield the chunks with indices in ``[start, stop)``."""
+        for index in range(*slice(start, stop).indices(self.n_chunks)):
+            yield self.chunk(index)
+
+    def ev42_payloads(
+        self,
+        start: int = 0,
+        stop: Optional[int] = None,
+        *,
+        source_name: str = 'fake_detector',
+    ) -> Iterator[bytes]:
+        """
+        Yield one serialised ev42 message per pulse of the chunks with indices in
+        ``[start, stop)``, e.g., to feed a FakeConsumer via FakeMessage.
+
+        This requires the streaming_data_types package.
+        """
+        from streaming_data_types.eventdata_ev42 import serialise_ev42
+
+        for index in range(*slice(start, stop).indices(self.n_chunks)):
+            pulses, sizes, event_time_offset, event_id = self._draw(index)
+            time_of_flight = np.round(event_time_offset * 1e9).astype(np.int32)
+            if event_id is None:
+                event_id = np.zeros(len(time_of_flight), dtype=np.int32)
+            pulse_time = self._t0['pulse', pulses].values.astype(np.int64)
+            end = np.cumsum(sizes)
+            for i, (begin, stop_event) in enumerate(zip(end - sizes, end)):
+                yield serialise_ev42(
+                    source_name,
+                    pulses.start + i,
+                    int(pulse_time[i]),
+                    time_of_flight[begin:stop_event],
+                    event_id[begin:stop_event],
+                )
+
+
 wfm1 = chopper_cascade.Chopper(
     distance=sc.scalar(6.6, unit='m'),
     time_open=sc.array(
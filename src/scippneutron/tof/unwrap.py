@@ -10,9 +10,21 @@ unwrapping for WFM instruments, as well as combinations of the latter two. The
 functions defined here are meant to be used as providers for a Sciline pipeline. See
 https://scipp.github.io/sciline/ on how to use Sciline.
 """
+import functools
 import math
 from dataclasses import dataclass
-from typing import Callable, Mapping, NewType, Optional, Tuple, Union
+from typing import (
+    AsyncIterable,
+    AsyncIterator,
+    Callable,
+    Iterable,
+    Iterator,
+    Mapping,
+    NewType,
+    Optional,
+    Tuple,
+    Union,
+)
 
 import scipp as sc
 
@@ -188,20 +200,46 @@ def frame_at_detector(
     setup correctly. This includes a correct definition of the offsets in
     pulse-skipping mode, i.e., the caller must know which pulses are in use.
     """
+    frames = _chopped_frames(source_wavelength_range, source_time_range, choppers)
+    return FrameAtDetector(frames[ltotal])
+
+
+def _chopped_frames(
+    source_wavelength_range: SourceWavelengthRange,
+    source_time_range: SourceTimeRange,
+    choppers: Choppers,
+) -> chopper_cascade.FrameSequence:
     frames = chopper_cascade.FrameSequence.from_source_pulse(
         time_min=source_time_range[0],
         time_max=source_time_range[-1],
         wavelength_min=source_wavelength_range[0],
         wavelength_max=source_wavelength_range[-1],
     )
-    frames = frames.chop(choppers.values())
-    return FrameAtDetector(frames[ltotal])
+    return frames.chop(choppers.values())
 
 
 def frame_bounds(frame: FrameAtDetector) -> FrameBounds:
     return FrameBounds(frame.bounds())
 
 
+def frame_bounds_at_detectors(
+    source_wavelength_range: SourceWavelengthRange,
+    source_time_range: SourceTimeRange,
+    choppers: Choppers,
+    ltotal: Ltotal,
+) -> FrameBounds:
+    """
+    Return the frame bounds at each of the given distances.
+
+    This replaces :py:func:`frame_at_detector` and :py:func:`frame_bounds` when Ltotal
+    is pixel-dependent. The chopper cascade is evaluated once for all distances, see
+    :py:meth:`chopper_cascade.FrameSequence.at`, and the bounds have the dims of
+    Ltotal in addition to 'bound'.
+    """
+    frames = _chopped_frames(source_wavelength_range, source_time_range, choppers)
+    return FrameBounds(frames.at(ltotal)['bounds'])
+
+
 def subframe_bounds(frame: FrameAtDetector) -> SubframeBounds:
     """Used for WFM."""
     return SubframeBounds(frame.subbounds())
@@ -306,9 +344,22 @@ def offset_from_wrapped(
         Time between the start of two consecutive frames, i.e., the period of the
         time-zero used by the data acquisition system.
     """
+    table = offset_from_wrapped_table(
+        frame_bounds, frame_period, unit=elem_unit(wrapped_time_offset)
+    )
+    return DeltaFromWrapped(sc.lookup(table, dim='section')[wrapped_time_offset])
+
+
+def offset_from_wrapped_table(
+    frame_bounds: FrameBounds, frame_period: FramePeriod, unit: sc.Unit
+) -> sc.DataArray:
+    """
+    Lookup table of the delta to add to wrapped time offsets given in unit,
+    piecewise constant in the wrapped time offset with dim 'section'.
+    """
     time_bounds = frame_bounds['time']
     frame_period = frame_period.to(unit=elem_unit(time_bounds))
-    if time_bounds['bound', -1] - time_bounds['bound', 0] > frame_period:
+    if (time_bounds['bound', -1] - time_bounds['bound', 0] > frame_period).any():
         raise ValueError(
             "Frames are overlapping: Computed frame bounds "
             f"{frame_bounds} are larger than frame period {frame_period}."
@@ -323,13 +374,12 @@ def offset_from_wrapped(
     end = sc.full_like(wrapped_time_min, value=math.inf)
     dim = 'section'
     time = sc.concat([begin, wrapped_time_min, end], dim).transpose().copy()
-    offset = sc.DataArray(
+    return sc.DataArray(
         time_offset_min
         - wrapped_time_min
         + sc.concat([frame_period, sc.zeros_like(frame_period)], dim),
-        coords={dim: time.to(unit=elem_unit(wrapped_time_offset))},
+        coords={dim: time.to(unit=unit)},
     )
-    return DeltaFromWrapped(sc.lookup(offset, dim=dim)[wrapped_time_offset])
 
 
 def source_chopper(
@@ -516,6 +566,13 @@ def to_time_of_flight(
         da = da.transform_coords(
             tof=lambda time_offset: time_offset - delta, keep_inputs=False
         )
+    return TofData(set_ltotal(da, ltotal=ltotal, source_distance=origin.distance))
+
+
+def set_ltotal(
+    da: sc.DataArray, ltotal: Ltotal, source_distance: sc.Variable
+) -> sc.DataArray:
+    """Set the Ltotal coord relative to the time-of-flight origin, in place."""
     if (existing := da.coords.get('Ltotal')) is not None:
         if not sc.identical(existing, ltotal):
             raise ValueError(
@@ -523,8 +580,293 @@ def to_time_of_flight(
                 "used for calculating time-of-flight."
             )
 
-    da.coords['Ltotal'] = ltotal - origin.distance
-    return TofData(da)
+    da.coords['Ltotal'] = ltotal - source_distance
+    return da
+
+
+def unwrap_to_time_of_flight(
+    da: RawData,
+    frame_bounds: FrameBounds,
+    frame_period: FramePeriod,
+    origin: TimeOfFlightOrigin,
+    ltotal: Ltotal,
+    *,
+    pulse_offset: Optional[PulseOffset] = None,
+    in_place: bool = False,
+    dtype: str = 'float64',
+) -> TofData:
+    """
+    Return the input data with 'tof', 'time_zero', and corrected 'Ltotal' coordinates.
+
+    This is equivalent to :py:func:`unwrap_data` followed by
+    :py:func:`to_time_of_flight`, but 'tof' and 'time_zero' are computed directly from
+    'event_time_offset' and 'event_time_zero' in a single pass over the events. The
+    intermediate 'time_offset' and 'pulse_time' coordinates are not added, and the
+    bins are not rebuilt. Unless a WFM origin is used, the offset which is added to
+    'tof' and subtracted from 'time_zero' is looked up once per event. With the
+    default dtype, the result is identical to that of the two steps.
+
+    Histogram-mode data is handled by :py:func:`unwrap_data` and
+    :py:func:`to_time_of_flight`.
+
+    Parameters
+    ----------
+    da :
+        The input data. Events are either binned or given as a 1-D table with an
+        'event' dim. 'event_time_zero' may be a coordinate of the events or of the
+        bins. In the latter case it is removed since bin edges become invalid.
+    frame_bounds :
+        The computed frame boundaries, used to unwrap the raw timestamps.
+    frame_period :
+        Time between the start of two consecutive frames.
+    origin :
+        The time-of-flight origin.
+    ltotal :
+        Total distance between the source and the detector(s).
+    pulse_offset :
+        Offsets of the pulses within a frame in pulse-skipping mode, see
+        :py:func:`pulse_offset`.
+    in_place :
+        If True, 'tof' and 'time_zero' overwrite the 'event_time_offset' and
+        'event_time_zero' event coordinates of the input, which is modified and
+        returned. Integer time offsets cannot hold the time-of-flight, they are
+        replaced by a new column instead. If False, the input coordinates are kept.
+    dtype :
+        Dtype of 'tof'. 'float32' halves the memory of the column, e.g., for
+        compact events, see :py:func:`scippneutron.compact_events`. The
+        offsets are then also applied in single precision, with a relative
+        error of about 6e-8.
+    """
+    if da.bins is None and 'event_time_offset' not in da.coords:
+        wrapped = pulse_wrapped_time_offset(da)
+        if pulse_offset is not None:
+            wrapped = frame_wrapped_time_offset_pulse_skipping(wrapped, pulse_offset)
+        delta = offset_from_wrapped(wrapped, frame_bounds, frame_period)
+        return to_time_of_flight(unwrap_data(da, delta), origin=origin, ltotal=ltotal)
+
+    if not in_place:
+        da = da.copy(deep=False)
+    if da.bins is None:
+        events = da
+        constituents = None
+    else:
+        constituents = da.bins.constituents
+        events = constituents['data']
+        if not in_place:
+            events = events.copy(deep=False)
+
+    def as_events(column: sc.Variable) -> sc.Variable:
+        if constituents is None:
+            return column
+        return sc.bins(
+            begin=constituents['begin'],
+            end=constituents['end'],
+            dim=constituents['dim'],
+            data=column,
+        )
+
+    offset = events.coords['event_time_offset']
+    unit = offset.unit
+    if in_place:
+        del events.coords['event_time_offset']
+    if in_place and offset.dtype == sc.DType(dtype):
+        tof = as_events(offset)
+    else:
+        tof = as_events(offset.to(dtype=dtype, copy=True))
+
+    events_have_time_zero = 'event_time_zero' in events.coords
+    if events_have_time_zero:
+        time_zero = events.coords['event_time_zero']
+        if in_place:
+            del events.coords['event_time_zero']
+        else:
+            time_zero = time_zero.copy()
+        time_zero = as_events(time_zero)
+    else:
+        # Bin edges are now invalid so we pop them
+        time_zero = da.coords.pop('event_time_zero')
+
+    table = offset_from_wrapped_table(frame_bounds, frame_period, unit=unit)
+    # Lookups need the same dtype for the keys and the coord
+    table.data = table.data.to(unit=unit, dtype=dtype)
+    table.coords['section'] = table.coords['section'].to(dtype=dtype)
+    wfm = isinstance(origin.time, sc.DataArray)
+    if pulse_offset is None:
+        delta = sc.lookup(table, dim='section')[tof]
+    else:
+        # As in unwrap_data, the pulse offset only selects the frame of the event
+        delta = sc.lookup(table, dim='section')[
+            tof + pulse_offset.to(unit=unit, dtype=dtype)
+        ]
+    tof += delta
+    time_zero_delta = delta.to(unit=elem_unit(time_zero), dtype='int64')
+    if time_zero.bins is None and constituents is not None:
+        time_zero = time_zero - time_zero_delta
+    else:
+        time_zero -= time_zero_delta
+    if not wfm:
+        # The origin is constant. It is applied separately from the unwrapping
+        # offset, so that both are rounded as in unwrap_data and to_time_of_flight.
+        tof -= origin.time.to(unit=unit, dtype=dtype)
+        time_zero += origin.time.to(unit=elem_unit(time_zero), dtype='int64')
+    if wfm:
+        subframes = sc.DataArray(
+            origin.time.data.to(unit=unit, dtype=dtype),
+            coords={
+                'subframe': origin.time.coords['subframe'].to(unit=unit, dtype=dtype)
+            },
+        )
+        # Will raise if subframes overlap, since coord for lookup table must be sorted
+        delta = sc.lookup(subframes, dim='subframe')[tof]
+        tof -= delta
+        time_zero += delta.to(unit=elem_unit(time_zero), dtype='int64')
+
+    if constituents is None:
+        da.coords['tof'] = tof
+        da.coords['time_zero'] = time_zero
+    else:
+        events.coords['tof'] = tof.bins.constituents['data']
+        if events_have_time_zero:
+            events.coords['time_zero'] = time_zero.bins.constituents['data']
+        da.data = as_events(events)
+        if not events_have_time_zero:
+            da.bins.coords['time_zero'] = time_zero
+    return TofData(set_ltotal(da, ltotal=ltotal, source_distance=origin.distance))
+
+
+def unwrap_stream_to_time_of_flight(
+    chunks: Union[Iterable[sc.DataArray], AsyncIterable[sc.DataArray]],
+    frame_bounds: FrameBounds,
+    frame_period: FramePeriod,
+    origin: TimeOfFlightOrigin,
+    ltotal: Ltotal,
+    *,
+    in_place: bool = True,
+    dtype: str = 'float64',
+) -> Union[Iterator[TofData], AsyncIterator[TofData]]:
+    """
+    Compute time-of-flight of each chunk of events, e.g., as yielded by
+    :py:func:`scippneutron.data_stream`, during acquisition.
+
+    The 'tof' and 'pulse_time' event coordinates of the chunks are the
+    event_time_offset and event_time_zero of the streamed events. They are renamed
+    accordingly and each chunk is passed to :py:func:`unwrap_to_time_of_flight`.
+    Chunks of events grouped by detector id are supported, histogrammed chunks are
+    not.
+
+    Pulse-skipping is not supported, since the offset of a pulse within the frame
+    cannot be determined from a single chunk.
+
+    Parameters
+    ----------
+    chunks :
+        Chunks of events. If this is an asynchronous iterable such as
+        :py:func:`scippneutron.data_stream`, an asynchronous generator is returned.
+    frame_bounds :
+        The computed frame boundaries, used to unwrap the raw timestamps.
+    frame_period :
+        Time between the start of two consecutive frames.
+    origin :
+        The time-of-flight origin.
+    ltotal :
+        Total distance between the source and the detector(s).
+    in_place :
+        If True (the default), the event columns of the chunks are overwritten,
+        see :py:func:`unwrap_to_time_of_flight`.
+    dtype :
+        Dtype of 'tof', see :py:func:`unwrap_to_time_of_flight`.
+    """
+    unwrap = functools.partial(
+        unwrap_to_time_of_flight,
+        frame_bounds=frame_bounds,
+        frame_period=frame_period,
+        origin=origin,
+        ltotal=ltotal,
+        in_place=in_place,
+        dtype=dtype,
+    )
+    return map_stream(chunks, unwrap)
+
+
+def map_stream(
+    chunks: Union[Iterable[sc.DataArray], AsyncIterable[sc.DataArray]],
+    unwrap: Callable[[RawData], TofData],
+) -> Union[Iterator[TofData], AsyncIterator[TofData]]:
+    """Apply unwrap lazily to each chunk of a sync or async stream."""
+    if hasattr(chunks, '__aiter__'):
+        return _unwrap_async_stream(chunks, unwrap)
+    return (unwrap_stream_chunk(chunk, unwrap) for chunk in chunks)
+
+
+async def _unwrap_async_stream(
+    chunks: AsyncIterable[sc.DataArray], unwrap: Callable[[RawData], TofData]
+) -> AsyncIterator[TofData]:
+    async for chunk in chunks:
+        yield unwrap_stream_chunk(chunk, unwrap)
+
+
+def _rename_stream_coords(events: sc.DataArray) -> None:
+    for name, nexus_name in (
+        ('tof', 'event_time_offset'),
+        ('pulse_time', 'event_time_zero'),
+    ):
+        events.coords[nexus_name] = events.coords.pop(name)
+
+
+def unwrap_stream_chunk(
+    chunk: sc.DataArray, unwrap: Callable[[RawData], TofData]
+) -> TofData:
+    """Apply unwrap to a chunk yielded by data_stream."""
+    chunk = chunk.copy(deep=False)
+    if chunk.bins is not None:
+        constituents = chunk.bins.constituents
+        constituents['data'] = constituents['data'].copy(deep=False)
+        _rename_stream_coords(constituents['data'])
+        chunk.data = sc.bins(**constituents)
+    elif 'event' in chunk.dims:
+        _rename_stream_coords(chunk)
+    else:
+        raise ValueError(
+            "Histogrammed chunks cannot be unwrapped, "
+            "stream events without tof_bins instead."
+        )
+    return unwrap(RawData(chunk))
+
+
+def fused_time_of_flight(
+    da: RawData,
+    frame_bounds: FrameBounds,
+    frame_period: FramePeriod,
+    origin: TimeOfFlightOrigin,
+    ltotal: Ltotal,
+) -> TofData:
+    """Compute TofData from RawData using :py:func:`unwrap_to_time_of_flight`."""
+    return unwrap_to_time_of_flight(
+        da,
+        frame_bounds=frame_bounds,
+        frame_period=frame_period,
+        origin=origin,
+        ltotal=ltotal,
+    )
+
+
+def fused_time_of_flight_pulse_skipping(
+    da: RawData,
+    frame_bounds: FrameBounds,
+    frame_period: FramePeriod,
+    origin: TimeOfFlightOrigin,
+    ltotal: Ltotal,
+    pulse_offset: PulseOffset,
+) -> TofData:
+    """Pulse-skipping version of :py:func:`fused_time_of_flight`."""
+    return unwrap_to_time_of_flight(
+        da,
+        frame_bounds=frame_bounds,
+        frame_period=frame_period,
+        origin=origin,
+        ltotal=ltotal,
+        pulse_offset=pulse_offset,
+    )
 
 
 _common_providers = (
@@ -581,3 +923,21 @@ def unwrap_providers(pulse_skipping: bool = False):
     """
     skipping = _skipping if pulse_skipping else _non_skipping
     return _common_providers + skipping
+
+
+def fused_unwrap_providers(pulse_skipping: bool = False):
+    """
+    Return the list of providers for computing TofData directly from RawData.
+
+    This replaces the combination of :py:func:`unwrap_providers` and
+    :py:func:`time_of_flight_providers`, without computing UnwrappedData.
+
+    Parameters
+    ----------
+    pulse_skipping :
+        If True, the pulse-skipping mode is assumed.
+    """
+    common = (frame_at_detector, frame_bounds, frame_period)
+    if pulse_skipping:
+        return common + (pulse_offset, time_zero, fused_time_of_flight_pulse_skipping)
+    return common + (fused_time_of_flight,)
@@ -0,0 +1,481 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
+"""
+Precomputed tables for unwrapping frames and computing time-of-flight.
+
+The frame bounds and time-of-flight origin of a chopper cascade depend only on the
+chopper settings and the detector distances, which typically do not change during a
+run. An :py:class:`UnwrapPlan` computes them once and stores, for each distance, the
+offset from the raw event_time_offset to the time-of-flight as a piecewise constant
+function. Using a uniform grid of cells, the section of each event is found without a
+binary search, so that plans can be applied cheaply to every chunk of a run.
+"""
+from __future__ import annotations
+
+import functools
+from dataclasses import dataclass
+from typing import Any, AsyncIterable, Dict, Iterable, Optional, Tuple, Union
+
+import numpy as np
+import scipp as sc
+
+from .._utils import per_event
+from . import chopper_cascade, unwrap
+
+# Pixels closer than this share a table by default
+_DISTANCE_RESOLUTION = sc.scalar(1.0, unit='mm')
+
+
+def _to_float(var: sc.Variable, unit: str) -> float:
+    return float(var.to(unit=unit, dtype='float64').value)
+
+
+def _scale(from_unit: sc.Unit, to_unit: sc.Unit) -> float:
+    return float(sc.scalar(1.0, unit=from_unit).to(unit=to_unit).value)
+
+
+def _searchsorted_rows(
+    sorted_rows: np.ndarray, values: np.ndarray, row: np.ndarray
+) -> np.ndarray:
+    """
+    ``np.searchsorted(sorted_rows[r], v, side='right')`` for each value v and its row r.
+
+    All rows are searched at once in a single flat array of complex numbers with the
+    row index as real part, since NumPy orders complex numbers lexicographically.
+    """
+    n_rows, width = sorted_rows.shape
+    keys = np.empty((n_rows, width), dtype=np.complex128)
+    keys.real = np.arange(n_rows)[:, np.newaxis]
+    keys.imag = sorted_rows
+    query = np.empty(np.shape(values), dtype=np.complex128)
+    query.real = row
+    query.imag = values
+    return np.searchsorted(keys.ravel(), query, side='right') - row * width
+
+
+def _shift_tables(
+    stacked: sc.DataGroup,
+    frame_period: unwrap.FramePeriod,
+    source_chopper: unwrap.SourceChopper,
+    wfm: bool,
+) -> Tuple[np.ndarray, np.ndarray, np.ndarray, np.ndarray]:
+    """
+    Section edges in the wrapped time offset padded with infinity, the shift from
+    wrapped time offset to time-of-flight and the time-of-flight origin in each
+    section padded with NaN, and the start of the frame in the wrapped time offset,
+    all in seconds, with one row for each distance of the result of FrameSequence.at.
+    Section k is [edges[:, k-1], edges[:, k]).
+    """
+    offsets = unwrap.offset_from_wrapped_table(
+        stacked['bounds'], frame_period, unit='s'
+    )
+    dims = ['distance', 'section']
+    wrapped_time_min = offsets.coords['section'].transpose(dims).values[:, 1]
+    delta = offsets.data.to(unit='s').transpose(dims).values
+    n_rows = len(wrapped_time_min)
+    if not wfm:
+        origin = unwrap.time_of_flight_origin_from_chopper(source_chopper)
+        edges = np.full((n_rows, 2), np.inf)
+        edges[:, 0] = wrapped_time_min
+        origin_time = np.full_like(delta, _to_float(origin.time, 's'))
+        return edges, delta - origin_time, origin_time, wrapped_time_min
+
+    subbounds = stacked['subbounds']
+    origin = unwrap.time_of_flight_origin_wfm_from_chopper(
+        source_chopper, chopper_cascade.present_subframes(subbounds['distance', 0])
+    )
+    subframe_shift = origin.time.data.to(unit='s').values
+    n_subframes = (len(subframe_shift) - 1) // 2
+    times = (
+        subbounds['time']
+        .to(unit='s', dtype='float64')
+        .transpose(['distance', 'subframe', 'bound'])
+        .values
+    )
+    n_present = np.count_nonzero(~np.isnan(times[:, :, 0]), axis=1)
+    for i in np.flatnonzero(n_present != n_subframes)[:1]:
+        # Raises because the subframes do not match the source chopper openings
+        unwrap.time_of_flight_origin_wfm_from_chopper(
+            source_chopper, chopper_cascade.present_subframes(subbounds['distance', i])
+        )
+    times = times[:, :n_subframes].reshape(n_rows, -1)
+    # Padded as in time_of_flight_origin_wfm_from_chopper
+    subframe_edges = np.concatenate(
+        [times[:, :1] - 1e9, times, times[:, -1:] + 1e9], axis=1
+    )
+    # Subframe edges are given in the unwrapped time offset, which depends on the
+    # section of the frame-unwrapping table the wrapped time offset falls into
+    below = subframe_edges - delta[:, :1]
+    above = subframe_edges - delta[:, 1:]
+    start = wrapped_time_min[:, np.newaxis]
+    candidates = np.concatenate(
+        [
+            np.where(below < start, below, np.inf),
+            start,
+            np.where(above > start, above, np.inf),
+        ],
+        axis=1,
+    )
+    candidates.sort(axis=1)
+    # Remove duplicates of each row, like np.unique
+    candidates[:, 1:][candidates[:, 1:] == candidates[:, :-1]] = np.inf
+    candidates.sort(axis=1)
+    n_edges = int(np.count_nonzero(np.isfinite(candidates), axis=1).max())
+    edges = np.full((n_rows, n_edges + 1), np.inf)
+    edges[:, :n_edges] = candidates[:, :n_edges]
+
+    section_start = np.concatenate([np.full((n_rows, 1), -np.inf), edges[:, :-1]], 1)
+    section_delta = np.where(section_start < start, delta[:, :1], delta[:, 1:])
+    rows = np.broadcast_to(np.arange(n_rows)[:, np.newaxis], section_start.shape)
+    subframe = _searchsorted_rows(subframe_edges, section_start + section_delta, rows)
+    subframe -= 1
+    inside = (subframe >= 0) & (subframe < len(subframe_shift))
+    origin_time = np.where(
+        inside, subframe_shift[np.clip(subframe, 0, len(subframe_shift) - 1)], np.nan
+    )
+    # Padding of rows with fewer sections
+    origin_time[:, 1:][np.isinf(edges[:, :-1])] = np.nan
+    return edges, section_delta - origin_time, origin_time, wrapped_time_min
+
+
+def _time_zero_shift(
+    shift: np.ndarray,
+    origin: np.ndarray,
+    *,
+    to_seconds: float,
+    unit: sc.Unit,
+    time_zero_unit: sc.Unit,
+) -> np.ndarray:
+    """
+    Shift of the time_zero of each event, as int64 in time_zero_unit.
+
+    The unwrapping offset and the origin are rounded separately and from the unit of
+    the time offset, as in :py:func:`unwrap.unwrap_to_time_of_flight`. The shift of
+    events outside of all subframes is NaN, their time_zero is left as it is.
+    """
+    finite = np.isfinite(shift)
+
+    def to_time_zero_unit(seconds: np.ndarray) -> np.ndarray:
+        values = np.where(finite, seconds, 0.0) / to_seconds
+        return (
+            sc.array(dims=['event'], values=values, unit=unit)
+            .to(unit=time_zero_unit, dtype='int64')
+            .values
+        )
+
+    return to_time_zero_unit(shift + origin) - to_time_zero_unit(origin)
+
+
+def _as_int64(values: np.ndarray) -> np.ndarray:
+    # Works for datetime64 and integer time stamps alike
+    return np.asarray(values).astype(np.int64, copy=False)
+
+
+def _as_time_stamps(values: np.ndarray, like: np.ndarray) -> np.ndarray:
+    if like.dtype.kind == 'M':
+        return values.view(like.dtype)
+    return values
+
+
+@dataclass(frozen=True, eq=False)
+class UnwrapPlan:
+    """
+    Precomputed frame unwrapping and time-of-flight lookup for a number of distances.
+
+    Create a plan using :py:meth:`from_frame_sequence` at the start of a run, then
+    apply it with :py:meth:`apply` to raw event data or with :py:meth:`apply_to_stream`
+    to the chunks of :py:func:`scippneutron.data_stream`. This is equivalent to
+    :py:func:`scippneutron.tof.unwrap.unwrap_to_time_of_flight`, except that 'tof' may
+    differ by rounding errors, and that tables are computed for distances rounded to
+    a resolution, see :py:meth:`from_frame_sequence`.
+
+    Plans can be pickled, or converted to a dict of NumPy arrays using
+    :py:meth:`to_dict`, e.g., for storing them in a file.
+
+    For each distance, the wrapped time offset is split into sections within which the
+    shift to time-of-flight is constant. A uniform grid of ``n_cells`` cells covers two
+    frame periods around the start of the frame. Each cell stores the index of the
+    first section edge after the cell start, so the section of a time offset is found
+    using a single comparison. Only time offsets in cells with more than one edge and
+    time offsets outside of the grid fall back to a binary search, done for all of
+    them at once.
+    """
+
+    ltotal: sc.Variable
+    """Distances the plan was computed for."""
+    source_distance: sc.Variable
+    """Distance of the source chopper, defining the time-of-flight origin."""
+    row: np.ndarray
+    """Index of the table of each element of ltotal."""
+    edges: np.ndarray
+    """Section edges of each table in seconds, padded with infinity."""
+    shift: np.ndarray
+    """Shift from wrapped time offset to time-of-flight in each section in seconds."""
+    origin: np.ndarray
+    """Time-of-flight origin in each section in seconds, NaN outside of subframes."""
+    grid_start: np.ndarray
+    """Start of the grid of each table in seconds."""
+    cell_width: np.ndarray
+    """Width of the grid cells of each table in seconds."""
+    first_edge: np.ndarray
+    """Index of the first edge after the start of each cell and the grid end."""
+
+    @staticmethod
+    def from_frame_sequence(
+        frames: chopper_cascade.FrameSequence,
+        ltotal: unwrap.Ltotal,
+        frame_period: unwrap.FramePeriod,
+        source_chopper: unwrap.SourceChopper,
+        *,
+        wfm: bool = False,
+        n_cells: int = 1024,
+        distance_resolution: Optional[sc.Variable] = None,
+    ) -> UnwrapPlan:
+        """
+        Compute the plan for the given distances.
+
+        Parameters
+        ----------
+        frames:
+            Result of applying the chopper cascade to the source pulse, see
+            :py:meth:`chopper_cascade.FrameSequence.chop`.
+        ltotal:
+            Total distance between the source and the detector(s). A table is computed
+            for every unique value after rounding to ``distance_resolution``.
+        frame_period:
+            Time between the start of two consecutive frames.
+        source_chopper:
+            Chopper defining the source location and time-of-flight time origin.
+        wfm:
+            If True, the time-of-flight origin is computed for each subframe.
+        n_cells:
+            Number of grid cells of each table.
+        distance_resolution:
+            Distances are rounded to multiples of this before computing the tables,
+            so that pixels at almost the same distance share a table. Defaults to
+            1 mm, pass zero to use the exact distances.
+        """
+        if distance_resolution is None:
+            distance_resolution = _DISTANCE_RESOLUTION
+        values = ltotal.to(unit='m', dtype='float64').values
+        resolution = _to_float(distance_resolution, 'm')
+        if resolution > 0:
+            values = np.round(values / resolution) * resolution
+        distances, row = np.unique(values, return_inverse=True)
+        period = _to_float(frame_period, 's')
+        cell_width = 2 * period / n_cells
+        stacked = frames.at(sc.array(dims=['distance'], values=distances, unit='m'))
+        edges, shift, origin, wrapped_time_min = _shift_tables(
+            stacked, frame_period, source_chopper, wfm
+        )
+        grid_start = wrapped_time_min - period
+        cell_start = grid_start[:, np.newaxis] + np.arange(n_cells + 1) * cell_width
+        rows = np.arange(len(distances))[:, np.newaxis]
+        rows = np.broadcast_to(rows, cell_start.shape)
+        first_edge = _searchsorted_rows(edges, cell_start, rows).astype(np.int32)
+        return UnwrapPlan(
+            ltotal=ltotal.copy(),
+            source_distance=source_chopper.distance,
+            row=row.reshape(ltotal.shape),
+            edges=edges,
+            shift=shift,
+            origin=origin,
+            grid_start=grid_start,
+            cell_width=np.full(len(distances), cell_width),
+            first_edge=first_edge,
+        )
+
+    @property
+    def n_cells(self) -> int:
+        return self.first_edge.shape[1] - 1
+
+    def to_dict(self) -> Dict[str, Any]:
+        """Convert the plan to a dict of NumPy arrays and strings."""
+        return {
+            'ltotal_dims': np.array(self.ltotal.dims, dtype=str),
+            'ltotal': self.ltotal.values,
+            'ltotal_unit': str(self.ltotal.unit),
+            'source_distance': self.source_distance.value,
+            'source_distance_unit': str(self.source_distance.unit),
+            'row': self.row,
+            'edges': self.edges,
+            'shift': self.shift,
+            'origin': self.origin,
+            'grid_start': self.grid_start,
+            'cell_width': self.cell_width,
+            'first_edge': self.first_edge,
+        }
+
+    @staticmethod
+    def from_dict(d: Dict[str, Any]) -> UnwrapPlan:
+        """Inverse of :py:meth:`to_dict`."""
+        return UnwrapPlan(
+            ltotal=sc.array(
+                dims=[str(dim) for dim in d['ltotal_dims']],
+                values=np.asarray(d['ltotal']),
+                unit=str(d['ltotal_unit']),
+            ),
+            source_distance=sc.scalar(
+                float(d['source_distance']), unit=str(d['source_distance_unit'])
+            ),
+            row=np.asarray(d['row']),
+            edges=np.asarray(d['edges']),
+            shift=np.asarray(d['shift']),
+            origin=np.asarray(d['origin']),
+            grid_start=np.asarray(d['grid_start']),
+            cell_width=np.asarray(d['cell_width']),
+            first_edge=np.asarray(d['first_edge']),
+        )
+
+    def _section(self, time: np.ndarray, row: np.ndarray) -> np.ndarray:
+        grid_start = self.grid_start[row]
+        cell_width = self.cell_width[row]
+        cell = np.floor((time - grid_start) / cell_width)
+        on_grid = (cell >= 0) & (cell < self.n_cells)
+        cell = np.where(on_grid, cell, 0).astype(np.intp)
+        first = self.first_edge[row, cell]
+        section = first + (time >= self.edges[row, first])
+        # Rounding may place a time offset next to the cell it was assigned to.
+        # Cell boundaries are computed as in from_frame_sequence.
+        needs_search = (
+            ~on_grid
+            | (self.first_edge[row, cell + 1] - first > 1)
+            | (time < grid_start + cell * cell_width)
+            | (time >= grid_start + (cell + 1) * cell_width)
+        )
+        if np.any(needs_search):
+            section[needs_search] = _searchsorted_rows(
+                self.edges, time[needs_search], row[needs_search]
+            )
+        return np.minimum(section, self.shift.shape[1] - 1)
+
+    def shift_of(self, time_offset: np.ndarray, row: np.ndarray) -> np.ndarray:
+        """
+        Shift from wrapped time offset to time-of-flight, in seconds.
+
+        Parameters
+        ----------
+        time_offset:
+            Wrapped time offsets in seconds.
+        row:
+            Index of the table of each time offset, see :py:attr:`row`.
+        """
+        return self.shift[row, self._section(time_offset, row)]
+
+    def _rows(self, da: sc.DataArray) -> np.ndarray:
+        row = sc.array(dims=self.ltotal.dims, values=self.row, unit=None)
+        return sc.broadcast(row, sizes=da.sizes).transpose(da.dims).values.ravel()
+
+    def apply(self, da: unwrap.RawData, *, in_place: bool = False) -> unwrap.TofData:
+        """
+        Return the input data with 'tof', 'time_zero', and corrected 'Ltotal'
+        coordinates, see :py:func:`scippneutron.tof.unwrap.unwrap_to_time_of_flight`.
+        With WFM, events outside of all subframes get a 'tof' of NaN and their
+        'time_zero' is the time of their pulse.
+
+        Parameters
+        ----------
+        da:
+            Event data with 'event_time_offset' and 'event_time_zero' coordinates,
+            either binned with the dims of :py:attr:`ltotal` or a 1-D table with an
+            'event' dim if the plan is for a single distance.
+        in_place:
+            If True, 'tof' and 'time_zero' overwrite the 'event_time_offset' and
+            'event_time_zero' event coordinates of the input, which is modified and
+            returned.
+        """
+        if da.bins is None and 'event' not in da.dims:
+            raise ValueError("Unwrap plans can only be applied to event data.")
+        if not in_place:
+            da = da.copy(deep=False)
+        if da.bins is None:
+            if self.row.size != 1:
+                raise ValueError(
+                    "Tables of events can only be unwrapped with a plan for a single "
+                    f"distance, got distances {self.ltotal}."
+                )
+            events = da
+            row = np.zeros(da.sizes['event'], dtype=np.intp)
+        else:
+            constituents = da.bins.constituents
+            events = constituents['data']
+            if not in_place:
+                events = events.copy(deep=False)
+            begin = constituents['begin'].values.ravel()
+            end = constituents['end'].values.ravel()
+            n_events = events.sizes[constituents['dim']]
+            row = per_event(self._rows(da), begin, end, n_events)
+
+        offset = events.coords['event_time_offset']
+        to_seconds = _scale(offset.unit, 's')
+        time = np.asarray(offset.values, dtype=np.float64) * to_seconds
+        section = self._section(time, row)
+        shift = self.shift[row, section]
+        tof = (time + shift) / to_seconds
+
+        events_have_time_zero = 'event_time_zero' in events.coords
+        if events_have_time_zero:
+            time_zero = events.coords['event_time_zero']
+            time_zero_values = _as_int64(time_zero.values)
+        else:
+            # Bin edges are now invalid so we pop them
+            time_zero = da.coords.pop('event_time_zero')
+            per_bin = sc.broadcast(time_zero, sizes=da.sizes).transpose(da.dims)
+            time_zero_values = per_event(
+                _as_int64(per_bin.values).ravel(), begin, end, n_events
+            )
+        time_zero_values = _as_time_stamps(
+            time_zero_values
+            - _time_zero_shift(
+                shift,
+                self.origin[row, section],
+                to_seconds=to_seconds,
+                unit=offset.unit,
+                time_zero_unit=time_zero.unit,
+            ),
+            time_zero.values,
+        )
+
+        dims = offset.dims
+        if in_place and offset.dtype == sc.DType.float64:
+            offset.values = tof
+            events.coords['tof'] = events.coords.pop('event_time_offset')
+        else:
+            if in_place:
+                del events.coords['event_time_offset']
+            events.coords['tof'] = sc.array(dims=dims, values=tof, unit=offset.unit)
+        if in_place and events_have_time_zero:
+            time_zero.values = time_zero_values
+            events.coords['time_zero'] = events.coords.pop('event_time_zero')
+        else:
+            events.coords['time_zero'] = sc.array(
+                dims=dims, values=time_zero_values, unit=time_zero.unit
+            )
+        if da.bins is not None:
+            da.data = sc.bins(
+                begin=constituents['begin'],
+                end=constituents['end'],
+                dim=constituents['dim'],
+                data=events,
+            )
+        return unwrap.TofData(
+            unwrap.set_ltotal(
+                da, ltotal=self.ltotal, source_distance=self.source_distance
+            )
+        )
+
+    def apply_to_stream(
+        self,
+        chunks: Union[Iterable[sc.DataArray], AsyncIterable[sc.DataArray]],
+        *,
+        in_place: bool = True,
+    ):
+        """
+        Apply the plan to each chunk of events.
+
+        See :py:func:`scippneutron.tof.unwrap.unwrap_stream_to_time_of_flight` for the
+        supported chunks. Returns an asynchronous generator if chunks is asynchronous.
+        """
+        return unwrap.map_stream(
+            chunks, functools.partial(self.apply, in_place=in_place)
+        )
@@ -0,0 +1,104 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
+import numpy as np
+import pytest
+import scipp as sc
+import scipp.testing
+
+from scippneutron import compact_events
+
+
+def make_events(pulse_time=(300, 100, 100, 200)):
+    n = len(pulse_time)
+    return sc.DataArray(
+        sc.ones(dims=['event'], shape=[n], with_variances=True, unit='counts'),
+        coords={
+            'tof': sc.linspace('event', 1.0, 2.0, n, unit='ms'),
+            'detector_id': sc.arange('event', n, unit=None),
+            'pulse_time': sc.array(dims=['event'], values=list(pulse_time), unit='ns'),
+        },
+    )
+
+
+def test_unit_weights_are_stored_as_float32_without_variances():
+    events = make_events()
+    del events.coords['pulse_time']
+    compact = compact_events(events)
+    assert compact.dtype == sc.DType.float32
+    assert compact.variances is None
+    assert compact.unit == 'counts'
+    np.testing.assert_array_equal(compact.values, np.ones(4))
+
+
+def test_weights_other_than_one_keep_their_variances():
+    events = make_events()
+    del events.coords['pulse_time']
+    events.variances = np.full(4, 2.0)
+    compact = compact_events(events)
+    assert compact.dtype == sc.DType.float32
+    np.testing.assert_array_equal(compact.variances, np.full(4, 2.0))
+
+
+def test_coords_are_narrowed_except_absolute_times():
+    events = make_events()
+    del events.coords['pulse_time']
+    events.coords['time_zero'] = sc.arange('event', 4, unit='ns')
+    compact = compact_events(events)
+    assert compact.coords['tof'].dtype == sc.DType.float32
+    assert compact.coords['detector_id'].dtype == sc.DType.int32
+    assert compact.coords['time_zero'].dtype == sc.DType.int64
+
+
+def test_int64_coords_out_of_int32_range_are_kept():
+    events = make_events()
+    del events.coords['pulse_time']
+    events.coords['detector_id'] = sc.array(
+        dims=['event'], values=np.arange(4) + 2**40, unit=None
+    )
+    compact = compact_events(events)
+    assert compact.coords['detector_id'].dtype == sc.DType.int64
+
+
+def test_float_dtype_float64_keeps_float_coords():
+    compact = compact_events(make_events(), float_dtype='float64')
+    content = compact.bins.constituents['data']
+    assert content.coords['tof'].dtype == sc.DType.float64
+
+
+def test_flat_table_is_binned_by_pulse():
+    events = make_events()
+    compact = compact_events(events)
+    sc.testing.assert_identical(
+        compact.coords['pulse_time'],
+        sc.array(dims=['pulse'], values=[100, 200, 300], unit='ns'),
+    )
+    np.testing.assert_array_equal(compact.bins.size().values, [2, 1, 1])
+    assert 'pulse_time' not in compact.bins.coords
+    np.testing.assert_array_equal(
+        compact.bins.constituents['data'].coords['detector_id'].values, [1, 2, 3, 0]
+    )
+    assert compact.hist().sum().value == 4.0
+    assert 'pulse_time' in events.coords
+
+
+def test_binned_events_keep_their_bins():
+    events = make_events()
+    binned = sc.DataArray(
+        sc.bins(
+            begin=sc.array(dims=['pixel'], values=[0, 3], unit=None),
+            dim='event',
+            data=events,
+        ),
+        coords={'pixel': sc.arange('pixel', 2, unit=None)},
+    )
+    compact = compact_events(binned)
+    np.testing.assert_array_equal(compact.bins.size().values, [3, 1])
+    content = compact.bins.constituents['data']
+    assert content.coords['tof'].dtype == sc.DType.float32
+    assert content.coords['pulse_time'].dtype == sc.DType.int64
+    sc.testing.assert_identical(compact.coords['pixel'], binned.coords['pixel'])
+
+
+def test_raises_for_dense_data_with_other_dims():
+    with pytest.raises(ValueError):
+        compact_events(sc.DataArray(sc.ones(dims=['x'], shape=[2])))
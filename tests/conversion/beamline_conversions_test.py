@@ -121,3 +121,64 @@ def test_two_theta_orthogonal_beams():
     assert sc.allclose(
         two_theta, sc.full(value=np.pi / 2, dims=['beam'], shape=[2], unit='rad')
     )
+
+
+def _translation_table(times_ns, offsets):
+    return sc.DataArray(
+        sc.spatial.translations(
+            dims=['time'], values=[[0.0, 0.0, z] for z in offsets], unit='m'
+        ),
+        coords={'time': sc.datetimes(dims=['time'], values=times_ns, unit='ns')},
+    )
+
+
+def test_position_from_transformation_table_dense():
+    base_position = sc.vectors(
+        dims=['pixel'], values=[[1.0, 0.0, 0.0], [2.0, 0.0, 0.0]], unit='m'
+    )
+    table = _translation_table([10, 20], [0.5, 1.5])
+    pulse_time = sc.datetimes(dims=['pulse'], values=[5, 15, 25], unit='ns')
+    position = beamline.position_from_transformation_table(
+        base_position=base_position,
+        position_transformations=sc.scalar(table),
+        pulse_time=pulse_time,
+    )
+    assert position.dims == ('pixel', 'pulse')
+    np.testing.assert_allclose(
+        position.values[..., 2], [[0.5, 0.5, 1.5], [0.5, 0.5, 1.5]]
+    )
+    np.testing.assert_allclose(position.values[..., 0], [[1.0] * 3, [2.0] * 3])
+
+
+def test_position_from_transformation_table_binned():
+    base_position = sc.vectors(
+        dims=['pixel'], values=[[1.0, 0.0, 0.0], [2.0, 0.0, 0.0]], unit='m'
+    )
+    table = _translation_table([10, 20], [0.5, 1.5])
+    # Bins out of order and with an event in no bin
+    pulse_time = sc.bins(
+        begin=sc.array(dims=['pixel'], values=[2, 0], unit=None),
+        end=sc.array(dims=['pixel'], values=[4, 1], unit=None),
+        dim='event',
+        data=sc.datetimes(dims=['event'], values=[25, 99, 15, 5], unit='ns'),
+    )
+    position = beamline.position_from_transformation_table(
+        base_position=base_position,
+        position_transformations=sc.scalar(table),
+        pulse_time=pulse_time,
+    )
+    assert position.bins is not None
+    np.testing.assert_allclose(position['pixel', 0].value.values, [[1, 0, 0.5]] * 2)
+    np.testing.assert_allclose(position['pixel', 1].value.values, [[2, 0, 1.5]])
+
+
+def test_sample_position_from_transformation_table():
+    table = _translation_table([10, 20], [0.5, 1.5])
+    pulse_time = sc.datetimes(dims=['pulse'], values=[10, 30], unit='ns')
+    sample_position = beamline.sample_position_from_transformation_table(
+        sample_position_transformations=sc.scalar(table), pulse_time=pulse_time
+    )
+    assert sc.allclose(
+        sample_position,
+        sc.vectors(dims=['pulse'], values=[[0, 0, 0.5], [0, 0, 1.5]], unit='m'),
+    )
@@ -54,6 +54,23 @@ def test_beamline_has_correct_keys():
     }
 
 
+def test_time_dependent_beamline_has_correct_keys():
+    assert set(beamline.beamline(scatter=False, time_dependent=True).keys()) == {
+        'position',
+        'Ltotal',
+    }
+    assert set(beamline.beamline(scatter=True, time_dependent=True).keys()) == {
+        'position',
+        'sample_position',
+        'scattered_beam',
+        'incident_beam',
+        'L1',
+        'L2',
+        'Ltotal',
+        'two_theta',
+    }
+
+
 @pytest.mark.parametrize(
     'fn',
     (
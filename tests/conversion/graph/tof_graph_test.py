@@ -40,6 +40,12 @@ def test_elastic_unsupported_starts(start):
         tof.elastic(start)
 
 
+def test_elastic_fused():
+    assert set(tof.elastic_fused('tof').keys()) == set(tof.elastic('tof').keys())
+    assert tof.elastic_fused('tof')['Q'] is not tof.elastic('tof')['Q']
+    assert tof.elastic_fused('wavelength') == tof.elastic('wavelength')
+
+
 def test_kinematic():
     assert set(tof.kinematic('tof').keys()) == {'energy', 'wavelength'}
     assert set(tof.kinematic('wavelength').keys()) == {'energy'}
@@ -122,6 +128,7 @@ def test_indirect_inelastic_unsupported_starts(start):
     'arg',
     (
         (tof.elastic, ('energy', 'tof', 'Q', 'wavelength')),
+        (tof.elastic_fused, ('energy', 'tof', 'Q', 'wavelength')),
         (tof.kinematic, ('tof', 'wavelength', 'energy')),
         (tof.elastic_dspacing, ('tof', 'wavelength', 'energy')),
         (tof.elastic_energy, ('tof', 'wavelength')),
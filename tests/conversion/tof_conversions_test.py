@@ -315,6 +315,35 @@ def test_Q_from_wavelength(wavelength, two_theta):
     assert sc.allclose(Q, 4 * np.pi * sc.sin(two_theta / 2) / wavelength)
 
 
+@given(
+    tof=time_variables(),
+    Ltotal_and_two_theta=n_space_variables(2),
+    two_theta_unit=st.sampled_from(('deg', 'rad')),
+)
+@settings(**global_settings)
+def test_Q_from_tof_consistent_with_wavelength(
+    tof, Ltotal_and_two_theta, two_theta_unit
+):
+    Ltotal, two_theta = Ltotal_and_two_theta
+    two_theta.unit = two_theta_unit
+    Q = tof_conv.Q_from_tof(tof=tof, Ltotal=Ltotal, two_theta=two_theta)
+    wavelength = tof_conv.wavelength_from_tof(tof=tof, Ltotal=Ltotal)
+    assert sc.allclose(
+        Q, tof_conv.Q_from_wavelength(wavelength=wavelength, two_theta=two_theta)
+    )
+
+
+@pytest.mark.parametrize('tof_dtype', ('float64', 'float32'))
+def test_Q_from_tof_keeps_precision_of_tof(tof_dtype):
+    tof = sc.scalar(52.0, unit='s', dtype=tof_dtype)
+    Ltotal = sc.scalar(0.341, unit='m')
+    two_theta = sc.scalar(1.68, unit='rad')
+    assert (
+        tof_conv.Q_from_tof(tof=tof, Ltotal=Ltotal, two_theta=two_theta).dtype
+        == tof_dtype
+    )
+
+
 @pytest.mark.parametrize('wavelength_dtype', ('float64', 'int64'))
 @pytest.mark.parametrize('two_theta_dtype', ('float64', 'float32', 'int64'))
 def test_Q_from_wavelength_double_precision(wavelength_dtype, two_theta_dtype):
@@ -400,6 +429,30 @@ def test_Q_elements_from_wavelength_consistent_with_Q(
     assert sc.allclose(sc.norm(Q_vec), Q)
 
 
+def test_Q_elements_from_tof_consistent_with_wavelength():
+    incident_beam = sc.vector([0.0, 0.0, 10.0], unit='m')
+    scattered_beam = sc.vectors(
+        dims=['pos'],
+        values=[[1.0, 0.0, 0.0], [0.0, 1.0, 0.0], [0.0, 1.0, 2.0]],
+        unit='cm',
+    )
+    Ltotal = sc.norm(incident_beam) + sc.norm(scattered_beam)
+    tof = sc.array(dims=['tof'], values=[1500.0, 8000.0], unit='us')
+    Q_from_tof = tof_conv.Q_elements_from_tof(
+        tof=tof,
+        Ltotal=Ltotal,
+        incident_beam=incident_beam,
+        scattered_beam=scattered_beam,
+    )
+    Q_from_wavelength = tof_conv.Q_elements_from_wavelength(
+        wavelength=tof_conv.wavelength_from_tof(tof=tof, Ltotal=Ltotal),
+        incident_beam=incident_beam,
+        scattered_beam=scattered_beam,
+    )
+    for a, b in zip(Q_from_tof, Q_from_wavelength):
+        assert sc.allclose(a, b)
+
+
 def test_Q_elements_from_wavelength():
     incident_beam = sc.vector([0.0, 0.0, 10.0], unit='m')
     scattered_beam = sc.vectors(
@@ -369,6 +369,169 @@ def test_convert_tof_to_Q():
         )
 
 
+@pytest.mark.parametrize('target', ('Q', 'dspacing'))
+def test_convert_tof_without_intermediates(target):
+    tof = make_test_data(coords=('tof', 'Ltotal', 'two_theta'))
+    converted = scn.convert(tof, origin='tof', target=target, scatter=True)
+    fused = scn.convert(
+        tof, origin='tof', target=target, scatter=True, keep_intermediate=False
+    )
+    assert 'wavelength' not in fused.coords
+    assert sc.allclose(fused.coords[target], converted.coords[target])
+    assert set(fused.coords) <= set(converted.coords)
+
+
+def test_convert_with_geometry_cache_reuses_beamline_quantities():
+    cache = scn.GeometryCache()
+    tof = make_test_data(
+        coords=('tof', 'position', 'sample_position', 'source_position')
+    )
+    expected = scn.convert(tof, origin='tof', target='wavelength', scatter=True)
+
+    first = scn.convert(
+        tof, origin='tof', target='wavelength', scatter=True, geometry_cache=cache
+    )
+    assert cache.hits == 0
+    n_computed = cache.misses
+    # A new but equal position coord, as in a new chunk of streamed data
+    tof.coords['position'] = make_position()
+    second = scn.convert(
+        tof, origin='tof', target='wavelength', scatter=True, geometry_cache=cache
+    )
+    assert cache.misses == n_computed
+    assert cache.hits > 0
+    assert sc.identical(first, expected)
+    assert sc.identical(second, expected)
+
+
+def test_convert_with_geometry_cache_recomputes_when_position_changes():
+    cache = scn.GeometryCache()
+    tof = make_test_data(
+        coords=('tof', 'position', 'sample_position', 'source_position')
+    )
+    scn.convert(
+        tof, origin='tof', target='wavelength', scatter=True, geometry_cache=cache
+    )
+    tof.coords['position'] = make_position() * 2.0
+    converted = scn.convert(
+        tof, origin='tof', target='wavelength', scatter=True, geometry_cache=cache
+    )
+    expected = scn.convert(tof, origin='tof', target='wavelength', scatter=True)
+    assert sc.identical(converted, expected)
+
+
+@pytest.mark.parametrize('target', ('wavelength', 'Q'))
+def test_convert_chunked_dense_matches_convert(target):
+    tof = make_test_data(
+        coords=('tof', 'position', 'sample_position', 'source_position')
+    )
+    expected = scn.convert(tof, origin='tof', target=target, scatter=True)
+    converted = scn.convert_chunked(
+        tof, origin='tof', target=target, scatter=True, items_per_block=3
+    )
+    assert sc.identical(converted, expected)
+
+
+@pytest.mark.parametrize('target', ('wavelength', 'dspacing'))
+def test_convert_chunked_binned_matches_convert(target):
+    tof = make_test_data(coords=('tof', 'Ltotal', 'two_theta'))['tof', 0].copy()
+    tof.data = make_tof_binned_events()
+    tof.masks['spectrum_mask'] = sc.array(dims=['spectrum'], values=[False, True])
+    expected = scn.convert(tof, origin='tof', target=target, scatter=True)
+    for max_workers in (1, 2):
+        converted = scn.convert_chunked(
+            tof,
+            origin='tof',
+            target=target,
+            scatter=True,
+            items_per_block=2,
+            max_workers=max_workers,
+        )
+        assert sc.identical(converted, expected)
+
+
+def test_convert_chunked_with_geometry_cache():
+    cache = scn.GeometryCache()
+    tof = make_test_data(
+        coords=('tof', 'position', 'sample_position', 'source_position')
+    )
+    expected = scn.convert(tof, origin='tof', target='wavelength', scatter=True)
+    for _ in range(2):
+        converted = scn.convert_chunked(
+            tof,
+            origin='tof',
+            target='wavelength',
+            scatter=True,
+            geometry_cache=cache,
+            items_per_block=3,
+        )
+        assert sc.identical(converted, expected)
+    assert cache.hits > 0
+
+
+def test_map_chunked_slices_pixel_dependent_arguments():
+    tof = make_test_data(coords=('tof', 'Ltotal'))
+    offset = sc.array(dims=['spectrum'], values=[1.0, 2.0], unit='counts')
+    result = scn.map_chunked(
+        lambda da, offset: da + offset, tof, items_per_block=1, offset=offset
+    )
+    assert sc.identical(result, tof + offset)
+
+
+def test_map_chunked_raises_if_number_of_events_changes():
+    tof = make_test_data(coords=('tof',))['tof', 0].copy()
+    tof.data = make_tof_binned_events()
+    with pytest.raises(ValueError):
+        scn.map_chunked(
+            lambda da: da.bins['tof', sc.scalar(2500.0, unit='us') :].copy(),
+            tof,
+            items_per_block=2,
+        )
+
+
+def test_convert_with_time_dependent_positions_uses_position_at_pulse_time():
+    constituents = make_tof_binned_events().bins.constituents
+    buffer = constituents['data'].copy()
+    n_events = buffer.sizes['event']
+    # Pulse times in ns since the epoch, the detector moves by 1 m at t=100ns
+    buffer.coords['pulse_time'] = sc.datetimes(
+        dims=['event'], values=[0, 150, 99, 100, 20, 300, 50], unit='ns'
+    )
+    events = sc.bins(**{**constituents, 'data': buffer})
+    transformations = sc.DataArray(
+        sc.spatial.translations(
+            dims=['time'], values=[[0.0, 0.0, 0.0], [0.0, 0.0, 1.0]], unit='m'
+        ),
+        coords={'time': sc.datetimes(dims=['time'], values=[0, 100], unit='ns')},
+    )
+    da = sc.DataArray(
+        events,
+        coords={
+            'base_position': make_position(),
+            'position_transformations': sc.scalar(transformations),
+            'source_position': make_source_position(),
+            'sample_position': make_sample_position(),
+        },
+    )
+    converted = scn.convert(da, origin='tof', target='wavelength', scatter=True)
+
+    expected = buffer.copy()
+    spectrum = np.repeat([0, 1], [4, 3])
+    moved = np.isin(np.arange(n_events), [1, 3, 5])
+    positions = make_position().values[spectrum]
+    positions[moved, 2] += 1.0
+    expected.coords['position'] = sc.vectors(
+        dims=['event'], values=positions, unit='m'
+    )
+    expected.coords['source_position'] = make_source_position()
+    expected.coords['sample_position'] = make_sample_position()
+    expected = scn.convert(expected, origin='tof', target='wavelength', scatter=True)
+    assert sc.allclose(
+        converted.bins.constituents['data'].coords['wavelength'],
+        expected.coords['wavelength'],
+    )
+
+
 def test_convert_Q_to_wavelength():
     tof = make_test_data(coords=('tof', 'Ltotal', 'two_theta'))
     Q = scn.convert(tof, origin='tof', target='Q', scatter=True)
@@ -4,6 +4,7 @@ import datetime
 import multiprocessing as mp
 import platform
 import sys
+import time
 import warnings
 from cmath import isclose
 from pathlib import Path
@@ -12,6 +13,7 @@ from typing import List, Optional, Tuple, Union
 import numpy as np
 import pytest
 import scipp as sc
+from scipp.testing import assert_identical
 
 from scippneutron._utils import get_attrs
 from scippneutron.data_streaming._consumer_type import ConsumerType
@@ -39,6 +41,7 @@ try:
     from streaming_data_types.sample_environment_senv import Location, serialise_senv
     from streaming_data_types.timestamps_tdct import serialise_tdct
 
+    from scippneutron.data_streaming import data_stream as data_stream_module
     from scippneutron.data_streaming._consumer import RunStartError
     from scippneutron.data_streaming.data_stream import _data_stream  # noqa: E402
     from scippneutron.data_streaming.data_stream import StopTime
@@ -227,6 +230,422 @@ async def test_data_stream_returns_data_from_multiple_event_messages(queues):
     assert reached_asserts
 
 
+@pytest.mark.asyncio
+async def test_data_stream_returns_event_data_via_shared_memory(queues):
+    data_queue, worker_instruction_queue, test_message_queue = queues
+    time_of_flight = np.array([1.0, 2.0, 3.0])
+    detector_ids = np.array([4, 5, 6])
+    pulse_time = 123456
+    test_message = FakeMessage(
+        serialise_ev42("detector", 0, pulse_time, time_of_flight, detector_ids)
+    )
+    test_message_queue.put(test_message)
+
+    reached_assert = False
+    async for data in _data_stream(
+        data_queue,
+        worker_instruction_queue,
+        halt_after_n_data_chunks=1,
+        test_message_queue=test_message_queue,
+        query_consumer=FakeQueryConsumer(),
+        shared_memory_slots=2,
+        **TEST_STREAM_ARGS,
+    ):
+        assert np.allclose(data.coords['tof'].values, time_of_flight)
+        assert np.array_equal(data.coords['detector_id'].values, detector_ids)
+        assert np.array_equal(
+            data.coords['pulse_time'].values, np.full(3, pulse_time, dtype=np.int64)
+        )
+        assert np.array_equal(data.variances, np.ones(3))
+        reached_assert = True
+    assert reached_assert
+
+
+def test_shared_memory_ring_round_trip():
+    from scippneutron.data_streaming._shared_memory import (
+        SharedMemoryChunk,
+        SharedMemoryRing,
+        chunk_nbytes,
+    )
+
+    data = sc.DataArray(
+        sc.array(dims=['event'], values=[1.0, 2.0], variances=[1.0, 4.0]),
+        coords={
+            'tof': sc.array(dims=['event'], values=[11, 12], unit='ns', dtype='int32'),
+            'detector_id': sc.array(
+                dims=['event'], values=[3, 4], unit=None, dtype='int32'
+            ),
+        },
+        attrs={'log': sc.scalar(sc.arange('log', 3.0, unit='K'))},
+    )
+    ring = SharedMemoryRing.create(
+        n_slots=1, slot_nbytes=chunk_nbytes(data), ctx=mp.get_context("spawn")
+    )
+    try:
+        chunk = ring.write(data)
+        assert isinstance(chunk, SharedMemoryChunk)
+        # The only slot is in use until the chunk has been read
+        assert ring.write(data) is None
+        assert_identical(ring.read(chunk), data)
+        assert ring.write(data) is not None
+    finally:
+        ring.close()
+        ring.free_slots.close()
+
+
+def test_shared_memory_ring_rejects_chunk_larger_than_slot():
+    from scippneutron.data_streaming._shared_memory import SharedMemoryRing
+
+    data = sc.DataArray(sc.ones(dims=['event'], shape=[16]))
+    ring = SharedMemoryRing.create(
+        n_slots=1, slot_nbytes=8, ctx=mp.get_context("spawn")
+    )
+    try:
+        assert ring.write(data) is None
+    finally:
+        ring.close()
+        ring.free_slots.close()
+
+
+def _drain_queue(queue) -> list:
+    items = []
+    while not queue.empty():
+        items.append(queue.get_nowait())
+    return items
+
+
+def test_buffer_keeps_all_events_from_concurrent_consumer_threads():
+    import queue
+    import threading
+
+    from scippneutron.data_streaming._data_buffer import StreamedDataBuffer
+    from scippneutron.data_streaming._serialisation import (
+        convert_from_pickleable_dict,
+    )
+
+    emit_queue = queue.Queue()
+    buffer = StreamedDataBuffer(
+        emit_queue,
+        event_buffer_size=7,
+        slow_metadata_buffer_size=1,
+        fast_metadata_buffer_size=1,
+        chopper_buffer_size=1,
+        interval_s=0.01,
+        run_id="",
+    )
+    n_threads = 4
+    n_messages = 50
+    messages = [
+        [
+            serialise_ev42(
+                "detector",
+                0,
+                0,
+                np.array([thread, message, 0]),
+                np.arange(3) + 3 * (thread * n_messages + message),
+            )
+            for message in range(n_messages)
+        ]
+        for thread in range(n_threads)
+    ]
+
+    def consume(thread_messages):
+        for message in thread_messages:
+            buffer.new_data(message)
+
+    buffer.start()
+    threads = [threading.Thread(target=consume, args=(m,)) for m in messages]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    buffer.stop()
+
+    chunks = [convert_from_pickleable_dict(c) for c in _drain_queue(emit_queue)]
+    assert all(chunk.sizes['event'] <= 7 for chunk in chunks)
+    detector_ids = np.concatenate(
+        [chunk.coords['detector_id'].values for chunk in chunks]
+    )
+    assert np.array_equal(np.sort(detector_ids), np.arange(3 * n_threads * n_messages))
+
+
+def test_buffer_gives_each_event_the_pulse_time_of_its_message():
+    import queue
+
+    from scippneutron.data_streaming._data_buffer import StreamedDataBuffer
+    from scippneutron.data_streaming._serialisation import (
+        convert_from_pickleable_dict,
+    )
+
+    emit_queue = queue.Queue()
+    buffer = StreamedDataBuffer(
+        emit_queue,
+        event_buffer_size=TEST_BUFFER_SIZE,
+        slow_metadata_buffer_size=1,
+        fast_metadata_buffer_size=1,
+        chopper_buffer_size=1,
+        interval_s=10.0,
+        run_id="",
+    )
+    buffer.new_data_batch(
+        [
+            serialise_ev42("detector", 0, 100, np.array([1, 2]), np.array([3, 4])),
+            serialise_ev42("detector", 2, 200, np.array([5]), np.array([6])),
+            b"abcd0000",
+            serialise_ev42("detector", 3, 300, np.array([7, 8]), np.array([9, 10])),
+        ]
+    )
+    buffer.stop()
+
+    chunks = _drain_queue(emit_queue)
+    assert isinstance(chunks[0], UnknownFlatbufferIdWarning)
+    data = convert_from_pickleable_dict(chunks[1])
+    assert np.array_equal(data.coords['tof'].values, [1, 2, 5, 7, 8])
+    assert np.array_equal(data.coords['detector_id'].values, [3, 4, 6, 9, 10])
+    assert np.array_equal(data.coords['pulse_time'].values, [100, 100, 200, 300, 300])
+    assert np.array_equal(data.values, np.ones(5))
+
+
+def test_buffer_emits_events_preceding_run_stop_before_stop_time_update():
+    import queue
+
+    from streaming_data_types.run_stop_6s4t import serialise_6s4t
+
+    from scippneutron.data_streaming._serialisation import (
+        convert_from_pickleable_dict,
+    )
+    from scippneutron.data_streaming._stop_time import StopTimeUpdate
+
+    emit_queue = queue.Queue()
+    buffer = _make_buffer(emit_queue)
+    buffer.new_data_batch(
+        [
+            serialise_ev42("detector", 0, 100, np.array([1, 2]), np.array([3, 4])),
+            serialise_6s4t(job_id="", stop_time=1000),
+            serialise_ev42("detector", 1, 200, np.array([5]), np.array([6])),
+        ]
+    )
+    buffer.stop()
+
+    chunks = _drain_queue(emit_queue)
+    assert len(chunks) == 3
+    assert np.array_equal(
+        convert_from_pickleable_dict(chunks[0]).coords['tof'].values, [1, 2]
+    )
+    assert isinstance(chunks[1], StopTimeUpdate)
+    assert np.array_equal(
+        convert_from_pickleable_dict(chunks[2]).coords['tof'].values, [5]
+    )
+
+
+def _make_buffer(emit_queue, event_buffer_size=TEST_BUFFER_SIZE, **kwargs):
+    from scippneutron.data_streaming._data_buffer import StreamedDataBuffer
+
+    return StreamedDataBuffer(
+        emit_queue,
+        event_buffer_size=event_buffer_size,
+        slow_metadata_buffer_size=1,
+        fast_metadata_buffer_size=1,
+        chopper_buffer_size=1,
+        interval_s=10.0,
+        run_id="",
+        **kwargs,
+    )
+
+
+def test_buffer_grows_to_keep_messages_larger_than_event_buffer_size():
+    import queue
+
+    from scippneutron.data_streaming._serialisation import (
+        convert_from_pickleable_dict,
+    )
+
+    emit_queue = queue.Queue()
+    buffer = _make_buffer(
+        emit_queue, event_buffer_size=2, event_buffer_memory_limit=1024
+    )
+    buffer.new_data_batch(
+        [
+            serialise_ev42("detector", 0, 0, np.arange(5), np.arange(5)),
+            serialise_ev42("detector", 1, 0, np.arange(3), np.arange(5, 8)),
+        ]
+    )
+    buffer.stop()
+
+    chunks = _drain_queue(emit_queue)
+    assert not any(isinstance(chunk, Warning) for chunk in chunks)
+    detector_ids = np.concatenate(
+        [convert_from_pickleable_dict(c).coords['detector_id'].values for c in chunks]
+    )
+    assert np.array_equal(detector_ids, np.arange(8))
+
+
+def test_buffer_records_metrics():
+    import queue
+
+    emit_queue = queue.Queue()
+    buffer = _make_buffer(emit_queue, event_buffer_size=2)
+    buffer.new_data_batch(
+        [
+            serialise_ev42("detector", 0, 0, np.arange(2), np.arange(2)),
+            # Too large for the buffer, so it is dropped
+            serialise_ev42("detector", 1, 0, np.arange(3), np.arange(3)),
+            b"abcd0000",
+        ]
+    )
+    buffer.stop()
+
+    stats = buffer.metrics.snapshot()
+    assert stats.events_per_s > 0
+    assert stats.dropped_messages == 1
+    assert stats.dropped_events == 3
+    assert stats.emitted_chunks == 1
+    assert stats.mean_emit_size == 2
+    assert set(stats.deserialise_s) == {"ev42", "0000"}
+
+
+def test_buffer_groups_events_by_detector_id():
+    import queue
+
+    from scippneutron.data_streaming._serialisation import (
+        BinnedDataChunk,
+        convert_from_pickleable_dict,
+    )
+
+    emit_queue = queue.Queue()
+    buffer = _make_buffer(emit_queue, detector_ids=np.array([7, 3, 5]))
+    buffer.new_data_batch(
+        [
+            serialise_ev42(
+                "detector", 0, 100, np.array([1, 2, 3]), np.array([3, 7, 3])
+            ),
+            # Detector id 4 is not in detector_ids, so that event is dropped
+            serialise_ev42("detector", 1, 200, np.array([4, 5]), np.array([4, 3])),
+        ]
+    )
+    buffer.stop()
+
+    chunks = _drain_queue(emit_queue)
+    assert len(chunks) == 1
+    assert isinstance(chunks[0], BinnedDataChunk)
+    data = chunks[0].to_data_array(convert_from_pickleable_dict(chunks[0].events))
+    assert np.array_equal(data.coords['detector_id'].values, [7, 3, 5])
+    assert np.array_equal(data.bins.size().values, [1, 3, 0])
+    assert np.array_equal(data['detector_id', 0].values.coords['tof'].values, [2])
+    assert np.array_equal(data['detector_id', 1].values.coords['tof'].values, [1, 3, 5])
+    assert np.array_equal(
+        data['detector_id', 1].values.coords['pulse_time'].values, [100, 100, 200]
+    )
+
+
+def test_buffer_groups_events_of_more_than_2_to_16_detectors():
+    import queue
+
+    from scippneutron.data_streaming._serialisation import (
+        convert_from_pickleable_dict,
+    )
+
+    emit_queue = queue.Queue()
+    buffer = _make_buffer(emit_queue, detector_ids=np.arange(100_000))
+    detector_id = np.array([99_999, 3, 70_000, 3, 99_999, 65_536])
+    buffer.new_data(
+        serialise_ev42("detector", 0, 100, np.arange(len(detector_id)), detector_id)
+    )
+    buffer.stop()
+
+    chunk = _drain_queue(emit_queue)[0]
+    data = chunk.to_data_array(convert_from_pickleable_dict(chunk.events))
+    events = data.bins.constituents['data']
+    assert np.array_equal(events.coords['tof'].values, [1, 3, 5, 2, 0, 4])
+    assert np.array_equal(
+        np.flatnonzero(data.bins.size().values), [3, 65_536, 70_000, 99_999]
+    )
+
+
+def test_buffer_histograms_events_by_detector_id_and_tof():
+    import queue
+
+    from scippneutron.data_streaming._serialisation import (
+        convert_from_pickleable_dict,
+    )
+
+    emit_queue = queue.Queue()
+    buffer = _make_buffer(
+        emit_queue,
+        detector_ids=np.array([1, 2]),
+        tof_bin_edges=np.array([0.0, 10.0, 20.0]),
+    )
+    buffer.new_data(
+        serialise_ev42(
+            "detector", 0, 0, np.array([1, 15, 12, 5, 25]), np.array([1, 1, 2, 2, 1])
+        )
+    )
+    buffer.stop()
+
+    chunks = _drain_queue(emit_queue)
+    data = convert_from_pickleable_dict(chunks[0])
+    assert data.dims == ('detector_id', 'tof')
+    assert np.array_equal(data.values, [[1, 1], [1, 1]])
+    assert np.array_equal(data.variances, [[1, 1], [1, 1]])
+    assert np.array_equal(data.coords['tof'].values, [0.0, 10.0, 20.0])
+
+
+def test_buffer_emits_implicit_unit_weights_with_compact_events():
+    import queue
+
+    from scippneutron.data_streaming._serialisation import (
+        convert_from_pickleable_dict,
+    )
+
+    emit_queue = queue.Queue()
+    buffer = _make_buffer(emit_queue, compact_events=True)
+    buffer.new_data_batch(
+        [serialise_ev42("detector", 0, 100, np.array([1, 2]), np.array([3, 4]))]
+    )
+    buffer.stop()
+
+    data = convert_from_pickleable_dict(_drain_queue(emit_queue)[0])
+    assert data.dtype == sc.DType.float32
+    assert data.variances is None
+    assert np.array_equal(data.values, np.ones(2))
+    assert np.array_equal(data.coords['pulse_time'].values, [100, 100])
+
+
+def test_merge_chunks_from_shards_concatenates_events_and_metadata():
+    from scippneutron.data_streaming._data_consumption_manager import merge_chunks
+
+    def chunk(tof, log_values):
+        data = sc.DataArray(
+            sc.ones(dims=['event'], shape=[len(tof)], with_variances=True),
+            coords={'tof': sc.array(dims=['event'], values=tof, unit='ns')},
+        )
+        get_attrs(data)['log'] = sc.scalar(
+            sc.DataArray(sc.array(dims=['log'], values=log_values, unit='K'))
+        )
+        return data
+
+    merged = merge_chunks([chunk([1, 2], [10.0]), chunk([3], [])])
+    assert np.array_equal(merged.coords['tof'].values, [1, 2, 3])
+    assert np.array_equal(get_attrs(merged)['log'].value.values, [10.0])
+
+
+def test_merge_chunks_from_shards_sums_histograms():
+    from scippneutron.data_streaming._data_consumption_manager import merge_chunks
+
+    def histogram(counts):
+        return sc.DataArray(
+            sc.array(dims=['detector_id', 'tof'], values=counts, variances=counts),
+            coords={
+                'detector_id': sc.array(dims=['detector_id'], values=[1, 2]),
+                'tof': sc.array(dims=['tof'], values=[0.0, 1.0], unit='ns'),
+            },
+        )
+
+    merged = merge_chunks([histogram([[1.0], [2.0]]), histogram([[3.0], [0.0]])])
+    assert np.array_equal(merged.values, [[4.0], [2.0]])
+    assert np.array_equal(merged.variances, [[4.0], [2.0]])
+
+
 @pytest.mark.asyncio
 async def test_warn_if_unrecognised_message_was_encountered(queues):
     warnings.filterwarnings("error")
@@ -1220,3 +1639,55 @@ async def test_stream_loop_exits_if_stop_time_reached_and_later_message_seen(que
             )
 
         n_chunks += 1
+
+
+class StoppableWidget:
+    stop_requested = False
+
+    def __init__(self, **kwargs):
+        pass
+
+    def set_stats(self, stats):
+        pass
+
+    def set_stop_time(self, stop_time_ms):
+        pass
+
+    def set_stopped(self):
+        pass
+
+
+@pytest.mark.asyncio
+async def test_data_flushed_into_full_queue_is_yielded_when_stream_stops(
+    queues, monkeypatch
+):
+    _, worker_instruction_queue, test_message_queue = queues
+    # Room for a single chunk, so that the flush at stop has to wait for it
+    data_queue = mp.get_context("spawn").Queue(maxsize=1)
+    monkeypatch.setattr(data_stream_module, "DataStreamWidget", StoppableWidget)
+    monkeypatch.setattr(StoppableWidget, "stop_requested", False)
+    first_tof = np.array([1.0, 2.0, 3.0])
+    last_tof = np.array([7.0, 8.0])
+    test_message_queue.put(
+        FakeMessage(serialise_ev42("detector", 0, 0, first_tof, np.array([1, 2, 3])))
+    )
+
+    received = []
+    async for data in _data_stream(
+        data_queue,
+        worker_instruction_queue,
+        test_message_queue=test_message_queue,
+        query_consumer=FakeQueryConsumer(),
+        **TEST_STREAM_ARGS,
+    ):
+        if 'tof' in data.coords:
+            received.append(data.coords['tof'].values)
+        if not StoppableWidget.stop_requested:
+            last_message = serialise_ev42("detector", 1, 0, last_tof, np.array([4, 5]))
+            test_message_queue.put(FakeMessage(last_message))
+            # Give the consumer time to fill the queue before stopping
+            time.sleep(1.0)
+            StoppableWidget.stop_requested = True
+
+    received = np.concatenate(received)
+    assert np.allclose(received, np.concatenate((first_tof, last_tof)))
@@ -148,3 +148,55 @@ def test_neutron_instrument_view_components_with_invalid_size_unit():
                 'sample': _make_component_settings(data=d, size_unit=sc.units.us)
             },
         )
+
+
+def test_pixel_aggregation_sums_pixels_of_each_voxel():
+    positions = sc.vectors(
+        dims=['pixel'],
+        values=[[0, 0, 0], [0.1, 0, 0], [10, 0, 0], [10, 0.1, 0]],
+        unit='m',
+    )
+    aggregation = scn.PixelAggregation(positions, max_points=2)
+    da = sc.DataArray(
+        sc.array(dims=['pixel'], values=[1.0, 2.0, 3.0, 4.0], unit='counts'),
+        coords={'position': positions},
+    )
+    aggregated = aggregation(da)
+    assert aggregated.sizes == {'voxel': 2}
+    np.testing.assert_array_equal(aggregated.values, [3.0, 7.0])
+    np.testing.assert_allclose(
+        aggregated.coords['position'].values, [[0.05, 0, 0], [10, 0.05, 0]]
+    )
+    # The grid is refined until the two pixels of the second voxel would split
+    assert aggregation.voxel_size == 10.0 / 64
+
+
+def test_pixel_aggregation_keeps_other_dims():
+    d = make_dataset_with_beamline()
+    aggregation = scn.PixelAggregation(d.coords['position'], max_points=3)
+    aggregated = aggregation(d['a'])
+    assert aggregated.sizes['tof'] == 9
+    assert aggregated.sizes['voxel'] <= 3
+    np.testing.assert_allclose(
+        aggregated.sum('voxel').values, d['a'].sum('position').values
+    )
+
+
+def test_neutron_instrument_view_with_max_points():
+    d = make_dataset_with_beamline()
+    scn.instrument_view(d["a"], max_points=2)
+
+
+def test_neutron_instrument_view_of_node_updates_values():
+    import plopp as pp
+
+    d = make_dataset_with_beamline()
+    node = pp.Node(d['a'])
+    scn.instrument_view(node, max_points=2)
+    updated = d['a'] * 2.0
+    node.func = lambda: updated
+    node.notify_children('updated')
+    (aggregation,) = node.children
+    np.testing.assert_allclose(
+        aggregation().sum('voxel').values, updated.sum('position').values
+    )
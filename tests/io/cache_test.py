@@ -0,0 +1,139 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
+import os
+
+import numpy as np
+import pytest
+import scipp as sc
+from scipp.testing import assert_identical
+
+from scippneutron.io.cache import RunCache
+
+
+def make_events() -> sc.DataArray:
+    events = sc.DataArray(
+        sc.ones(dims=['event'], shape=[5], with_variances=True, unit='counts'),
+        coords={
+            'event_time_offset': sc.array(
+                dims=['event'], values=[1.0, 2.0, 3.0, 4.0, 5.0], unit='ms'
+            ),
+            'event_time_zero': sc.datetimes(
+                dims=['event'], values=[0, 0, 1, 1, 2], unit='ns'
+            ),
+        },
+        masks={'bad': sc.array(dims=['event'], values=[False] * 4 + [True])},
+    )
+    return sc.DataArray(
+        sc.bins(
+            begin=sc.array(dims=['detector_id'], values=[0, 3], unit=None),
+            end=sc.array(dims=['detector_id'], values=[3, 5], unit=None),
+            dim='event',
+            data=events,
+        ),
+        coords={
+            'detector_id': sc.array(dims=['detector_id'], values=[1, 2], unit=None),
+            'position': sc.vectors(
+                dims=['detector_id'], values=[[1, 0, 0], [0, 1, 0]], unit='m'
+            ),
+            'sample_position': sc.vector([0, 0, 0], unit='m'),
+        },
+    )
+
+
+class CountingLoader:
+    def __init__(self):
+        self.calls = 0
+
+    def __call__(self, path, **kwargs):
+        self.calls += 1
+        return make_events()
+
+
+@pytest.fixture
+def run_file(tmp_path):
+    path = tmp_path / 'run.nxs'
+    path.write_bytes(b'data')
+    return path
+
+
+def test_load_reads_cache_on_second_call(tmp_path, run_file):
+    cache = RunCache(tmp_path / 'cache')
+    loader = CountingLoader()
+    first = cache.load(loader, run_file)
+    second = cache.load(loader, run_file)
+    assert loader.calls == 1
+    assert_identical(first, make_events())
+    assert_identical(second, make_events())
+
+
+def test_entry_is_stored_as_columns(tmp_path, run_file):
+    cache = RunCache(tmp_path / 'cache')
+    cache.load(CountingLoader(), run_file)
+    (entry,) = cache.directory.iterdir()
+    columns = sorted(path.name for path in entry.glob('column*.npy'))
+    assert columns == ['column0.npy', 'column1.npy', 'column2.npy', 'column3.npy']
+    np.testing.assert_array_equal(np.load(entry / 'begin.npy'), [0, 3])
+
+
+def test_loader_args_and_modified_files_give_new_entries(tmp_path, run_file):
+    cache = RunCache(tmp_path / 'cache')
+    loader = CountingLoader()
+    cache.load(loader, run_file)
+    cache.load(loader, run_file, detector_ids=np.array([1, 2]))
+    cache.load(loader, run_file, detector_ids=np.array([1, 2]))
+    assert loader.calls == 2
+    stat = run_file.stat()
+    os.utime(run_file, ns=(stat.st_atime_ns, stat.st_mtime_ns + 1_000_000))
+    cache.load(loader, run_file)
+    assert loader.calls == 3
+
+
+def test_dense_data_is_cached(tmp_path, run_file):
+    cache = RunCache(tmp_path / 'cache')
+    histogram = make_events().hist()
+    cache.put('hist', histogram)
+    assert_identical(cache.get('hist'), histogram)
+    assert cache.get('other') is None
+
+
+class FakePlan:
+    def __init__(self, shift):
+        self.shift = shift
+        self.calls = 0
+
+    def to_dict(self):
+        return {'shift': np.array([self.shift]), 'unit': 'ms'}
+
+    def apply(self, da, *, in_place=False):
+        self.calls += 1
+        da = da if in_place else da.copy(deep=False)
+        da.bins.coords['tof'] = da.bins.coords['event_time_offset'] + sc.scalar(
+            self.shift, unit='ms'
+        )
+        return da
+
+
+def test_unwrapped_data_is_cached_by_plan(tmp_path, run_file):
+    cache = RunCache(tmp_path / 'cache')
+    loader = CountingLoader()
+    plan = FakePlan(1.0)
+    first = cache.load(loader, run_file, unwrap_plan=plan)
+    second = cache.load(loader, run_file, unwrap_plan=FakePlan(1.0))
+    assert loader.calls == 1
+    assert plan.calls == 1
+    assert_identical(second, first)
+    other = cache.load(loader, run_file, unwrap_plan=FakePlan(2.0))
+    assert loader.calls == 1
+    assert_identical(
+        other.bins.coords['tof'],
+        first.bins.coords['tof'] + sc.scalar(1.0, unit='ms'),
+    )
+
+
+def test_clear_removes_entries(tmp_path, run_file):
+    cache = RunCache(tmp_path / 'cache')
+    loader = CountingLoader()
+    cache.load(loader, run_file)
+    cache.clear()
+    cache.load(loader, run_file)
+    assert loader.calls == 2
@@ -5,6 +5,7 @@ import io
 from datetime import datetime, timezone
 from pathlib import Path
 
+import numpy as np
 import pytest
 import scipp as sc
 
@@ -470,6 +471,28 @@ DIFA 2 1.2e-05
     )
 
 
+def test_write_block_single_loop_more_rows_than_chunk_size():
+    from scippneutron.io._table import CHUNK_SIZE
+
+    n = CHUNK_SIZE + 3
+    difc = sc.linspace('detector', 1000.0, 2000.0, n)
+    detector = sc.arange('detector', n)
+    block = cif.Block(
+        'looped',
+        [cif.Loop({'pd_calib.detector_id': detector, 'pd_calib.difc': difc})],
+    )
+    res = write_to_str(block)
+    rows = ''.join(
+        f'{i} {d}\n' for i, d in zip(detector.values.tolist(), difc.values.tolist())
+    )
+    assert res == f'''data_looped
+
+loop_
+_pd_calib.detector_id
+_pd_calib.difc
+{rows}'''
+
+
 def test_write_block_single_loop_numbers_errors():
     coeff = sc.array(
         dims=['cal'],
@@ -767,6 +790,43 @@ _audit.creation_method 'written by scippneutron'
         )
 
 
+def test_save_cif_loop_file_round_trip(tmpdir):
+    path = Path(tmpdir) / "test_save_cif_loop.cif"
+    tof = sc.array(dims=['tof'], values=[1.2, 1.4, 2.3], unit='us')
+    intensity = sc.array(
+        dims=['tof'], values=[13.6, 26.0, 9.7], variances=[0.7, 1.1, 0.5]
+    )
+    block = cif.Block(
+        'looped',
+        [
+            cif.Loop(
+                {
+                    'pd_meas.time_of_flight': tof,
+                    'pd_meas.intensity_total': sc.values(intensity),
+                    'pd_meas.intensity_total_su': sc.stddevs(intensity),
+                }
+            )
+        ],
+    )
+
+    cif.save_cif(path, block)
+    with open(path, 'r') as f:
+        lines = f.read().splitlines()
+    assert lines[:7] == [
+        r'#\#CIF_1.1',
+        'data_looped',
+        '',
+        'loop_',
+        '_pd_meas.time_of_flight',
+        '_pd_meas.intensity_total',
+        '_pd_meas.intensity_total_su',
+    ]
+    loaded = np.loadtxt(lines[7:])
+    np.testing.assert_array_equal(loaded[:, 0], tof.values)
+    np.testing.assert_array_equal(loaded[:, 1], intensity.values)
+    np.testing.assert_allclose(loaded[:, 2], np.sqrt(intensity.variances))
+
+
 def test_loop_requires_1d():
     with pytest.raises(sc.DimensionError):
         cif.Loop({'fake': sc.zeros(sizes={'x': 4, 'y': 3})})
@@ -222,3 +222,43 @@ def test_nexus_json_load_array_dataset(examples):
         dg['slit_edges'],
         sc.array(dims=['dim_0'], values=[0.0, 15.0, 180.0, 195.0], unit='deg'),
     )
+
+
+def test_json_group_finds_children_added_after_first_lookup():
+    from scippneutron.io.nexus._json_nexus import JSONGroup
+
+    root = JSONGroup({'children': []})
+    entry = root.create_group('entry')
+    assert 'title' not in entry
+    entry.create_dataset('title', 'my experiment')
+    assert 'title' in root['entry']
+    assert root['/entry/title'][()] == 'my experiment'
+    assert root['entry'].keys() == ['title']
+
+
+def test_json_dataset_reads_values_replaced_after_first_read():
+    from scippneutron.io.nexus._json_nexus import JSONGroup
+
+    root = JSONGroup({'children': []})
+    root.create_dataset('detector_number', np.array([1, 2, 3]))
+    assert root['detector_number'].shape == (3,)
+    root._node['children'][0]['config']['values'] = [4, 5]
+    np.testing.assert_array_equal(root['detector_number'][()], [4, 5])
+
+
+def test_get_streams_info_finds_streams_depth_first():
+    from scippneutron.io.nexus._json_nexus import get_streams_info
+
+    def stream(source):
+        return {
+            'module': 'f144',
+            'config': {'topic': 't', 'source': source, 'dtype': 'double'},
+        }
+
+    tree = {
+        'children': [
+            {'name': 'a', 'children': [stream('a1'), {'children': [stream('a2')]}]},
+            stream('b'),
+        ]
+    }
+    assert [info.source_name for info in get_streams_info(tree)] == ['a1', 'a2', 'b']
@@ -347,6 +347,156 @@ def test_loads_data_from_multiple_event_data_groups(load_function: Callable):
     )
 
 
+def _single_bank_event_data() -> EventData:
+    return EventData(
+        event_id=np.array([1, 2, 3, 1, 3]),
+        event_time_offset=np.array([456, 743, 347, 345, 632]),
+        event_time_zero=np.array(
+            [
+                1600766730000000000,
+                1600766731000000000,
+                1600766732000000000,
+                1600766733000000000,
+            ]
+        ),
+        event_index=np.array([0, 3, 3, 5]),
+    )
+
+
+def test_loads_only_events_in_pulse_range():
+    builder = NexusBuilder()
+    builder.add_event_data(_single_bank_event_data())
+
+    loaded_data = load_from_nexus(builder, pulse_range=(2, 4))
+
+    # Only pulse 2 has events in this range
+    events = loaded_data.bins.concat('detector_id').values[0]
+    assert np.array_equal(np.sort(events.coords['tof'].values), [345, 632])
+    # Detector ids range over the ids of the loaded events only
+    assert np.array_equal(loaded_data.coords['detector_id'].values, [1, 2, 3])
+    assert np.array_equal(loaded_data.bins.sum().data.values, [[1], [0], [1]])
+
+
+def test_loads_only_selected_detector_ids():
+    builder = NexusBuilder()
+    builder.add_detector(
+        Detector(np.array([0, 1, 2, 3]), event_data=_single_bank_event_data())
+    )
+
+    loaded_data = load_from_nexus(builder, detector_ids=[3, 1])
+
+    assert np.array_equal(loaded_data.coords['detector_id'].values, [1, 3])
+    assert np.array_equal(loaded_data.bins.sum().data.values, [[2], [2]])
+
+
+def test_loads_only_selected_detector_ids_from_event_data():
+    builder = NexusBuilder()
+    builder.add_event_data(_single_bank_event_data())
+
+    loaded_data = load_from_nexus(builder, detector_ids=[2, 3])
+
+    assert np.array_equal(loaded_data.coords['detector_id'].values, [2, 3])
+    assert np.array_equal(loaded_data.bins.sum().data.values, [[1], [2]])
+
+
+def test_groups_events_of_each_event_data_group_by_its_detector_ids(
+    load_function: Callable,
+):
+    builder = NexusBuilder()
+    builder.add_event_data(_single_bank_event_data())
+    builder.add_event_data(
+        EventData(
+            event_id=np.array([3, 5, 5]),
+            event_time_offset=np.array([12, 1000, 34]),
+            event_time_zero=np.array([1600766730000000000, 1600766731000000000]),
+            event_index=np.array([0, 1]),
+        )
+    )
+
+    loaded_data = load_function(builder)
+
+    # Each group gets the range of detector ids found in it, like in make_binned
+    assert np.array_equal(
+        loaded_data.coords['detector_id'].values, [1, 2, 3, 3, 4, 5]
+    )
+    assert np.array_equal(
+        loaded_data.bins.sum().data.values, [[2], [1], [2], [1], [0], [2]]
+    )
+    assert np.array_equal(
+        loaded_data['detector_id', 2].values[0].coords['tof'].values, [347, 632]
+    )
+    assert np.array_equal(
+        loaded_data['detector_id', 5].values[0].coords['tof'].values, [1000, 34]
+    )
+    assert sc.identical(
+        loaded_data.coords['tof'],
+        sc.array(dims=['tof'], values=[12.0, np.nextafter(1000.0, np.inf)], unit='ns'),
+    )
+
+
+def test_event_data_groups_with_distant_detector_ids_get_no_bins_in_between():
+    builder = NexusBuilder()
+    builder.add_event_data(_single_bank_event_data())
+    builder.add_event_data(
+        EventData(
+            event_id=np.array([100001, 100000]),
+            event_time_offset=np.array([12, 34]),
+            event_time_zero=np.array([1600766730000000000]),
+            event_index=np.array([0]),
+        )
+    )
+
+    loaded_data = load_from_nexus(builder)
+
+    assert np.array_equal(
+        loaded_data.coords['detector_id'].values, [1, 2, 3, 100000, 100001]
+    )
+    assert np.array_equal(loaded_data.bins.sum().data.values, [[2], [1], [2], [1], [1]])
+
+
+def test_loads_events_in_chunks_of_pulses():
+    builder = NexusBuilder()
+    builder.add_event_data(_single_bank_event_data())
+    builder.add_log(Log("test_log", np.array([1, 2, 3]), np.array([4, 5, 6])))
+
+    with builder.file() as nexus_file:
+        full = scippneutron.load_nexus(nexus_file)
+        chunks = list(scippneutron.load_nexus(nexus_file, chunk_pulses=3))
+
+    # All events are in the first chunk of pulses 0-2, none in pulse 3
+    assert len(chunks) == 2
+    assert chunks[0].bins.size().sum().value == 5
+    assert chunks[1].bins.size().sum().value == 0
+    tof = chunks[0].bins.concat('detector_id').values[0].coords['tof']
+    assert np.array_equal(
+        np.sort(tof.values),
+        np.sort(full.bins.concat('detector_id').values[0].coords['tof'].values),
+    )
+    for chunk in chunks:
+        assert sc.identical(get_attrs(chunk)['test_log'], get_attrs(full)['test_log'])
+
+
+def test_chunks_of_pulses_with_different_detector_ids_get_same_bins():
+    builder = NexusBuilder()
+    builder.add_event_data(
+        EventData(
+            event_id=np.array([1, 2, 2, 5, 6]),
+            event_time_offset=np.array([12, 34, 56, 78, 90]),
+            event_time_zero=np.array([1600766730000000000, 1600766731000000000]),
+            event_index=np.array([0, 3]),
+        )
+    )
+
+    with builder.file() as nexus_file:
+        chunks = list(scippneutron.load_nexus(nexus_file, chunk_pulses=1))
+
+    assert len(chunks) == 2
+    for chunk in chunks:
+        assert np.array_equal(chunk.coords['detector_id'].values, [1, 2, 3, 4, 5, 6])
+    assert np.array_equal(chunks[0].bins.size().values[:, 0], [1, 2, 0, 0, 0, 0])
+    assert np.array_equal(chunks[1].bins.size().values[:, 0], [0, 0, 0, 0, 1, 1])
+
+
 def test_skips_event_data_group_with_non_integer_event_ids(load_function: Callable):
     event_time_offsets = np.array([456, 743, 347, 345, 632])
     event_data = EventData(
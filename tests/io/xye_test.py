@@ -231,3 +231,34 @@ def test_loads_correct_values():
         },
     )
     assert sc.identical(loaded, expected)
+
+
+def test_roundtrip_of_more_rows_than_chunk_size_is_exact():
+    from scippneutron.io._table import CHUNK_SIZE
+
+    n = CHUNK_SIZE + 3
+    rng = np.random.default_rng(8471)
+    da = sc.DataArray(
+        sc.array(
+            dims=['x'], values=rng.normal(size=n), variances=rng.uniform(size=n) ** 2
+        ),
+        coords={'x': sc.array(dims=['x'], values=rng.uniform(size=n), unit='us')},
+    )
+    loaded = roundtrip(da, coord='x')
+    np.testing.assert_array_equal(loaded.coords['x'].values, da.coords['x'].values)
+    np.testing.assert_array_equal(loaded.values, da.values)
+    np.testing.assert_allclose(loaded.variances, da.variances, rtol=1e-15)
+
+
+def test_loads_file_with_comments_after_header():
+    file_contents = '''# x y e
+1 2 3
+# a comment in the table
+4 5 6
+'''
+    loaded = scn.io.load_xye(
+        StringIO(file_contents), dim='x', unit='one', coord_unit='us'
+    )
+    np.testing.assert_array_equal(loaded.coords['x'].values, [1, 4])
+    np.testing.assert_array_equal(loaded.values, [2, 5])
+    np.testing.assert_array_equal(loaded.variances, [9, 36])
@@ -0,0 +1,148 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
+import numpy as np
+import pytest
+import scipp as sc
+import scipp.testing
+
+from scippneutron import LogStore
+from scippneutron.log_store import sort_by_time
+
+
+def make_log(times_ns, values, unit='K'):
+    return sc.DataArray(
+        sc.array(dims=['T'], values=values, unit=unit),
+        coords={
+            'time': sc.array(
+                dims=['T'],
+                values=np.asarray(times_ns).astype('datetime64[ns]'),
+                unit='ns',
+            )
+        },
+    )
+
+
+def test_append_grows_beyond_capacity():
+    store = LogStore('T', unit='K', capacity=2)
+    for i in range(5):
+        store.append(10 * i, float(i))
+    assert len(store) == 5
+    np.testing.assert_array_equal(store.times, [0, 10, 20, 30, 40])
+    np.testing.assert_array_equal(store.values, [0.0, 1.0, 2.0, 3.0, 4.0])
+
+
+def test_out_of_order_values_are_sorted_stably():
+    store = LogStore('T', unit='K', capacity=2)
+    store.extend(np.array([20, 10]), np.array([2.0, 1.0]))
+    store.append(10, 1.5)
+    np.testing.assert_array_equal(store.times, [10, 10, 20])
+    np.testing.assert_array_equal(store.values, [1.0, 1.5, 2.0])
+
+
+def test_data_array_round_trip():
+    log = make_log([1, 2, 3], [4.0, 5.0, 6.0])
+    sc.testing.assert_identical(LogStore.from_data_array(log).to_data_array(), log)
+
+
+def test_clear_removes_values():
+    store = LogStore.from_data_array(make_log([1, 2, 3], [4.0, 5.0, 6.0]))
+    store.clear()
+    assert len(store) == 0
+    assert store.to_data_array().sizes == {'T': 0}
+
+
+def test_value_at_returns_latest_value_at_or_before_time():
+    store = LogStore.from_data_array(make_log([10, 20, 30], [1.0, 2.0, 3.0]))
+    time = sc.array(dims=['event'], values=[5, 10, 15, 30, 99], unit='ns')
+    sc.testing.assert_identical(
+        store.value_at(time),
+        sc.array(dims=['event'], values=[np.nan, 1.0, 1.0, 3.0, 3.0], unit='K'),
+    )
+
+
+def test_value_at_accepts_datetimes():
+    store = LogStore.from_data_array(make_log([10, 20, 30], [1.0, 2.0, 3.0]))
+    time = sc.datetimes(dims=['event'], values=[25], unit='ns')
+    assert store.value_at(time).values[0] == 2.0
+
+
+def test_value_at_requires_fill_for_integers_before_first_value():
+    store = LogStore.from_data_array(make_log([10], np.array([1], dtype=np.int64)))
+    time = sc.array(dims=['event'], values=[5, 15], unit='ns')
+    with pytest.raises(ValueError):
+        store.value_at(time)
+    np.testing.assert_array_equal(store.value_at(time, fill=-1).values, [-1, 1])
+
+
+def test_in_range_converts_bounds_to_unit_of_log():
+    store = LogStore.from_data_array(make_log([10, 20, 30], [270.0, 280.0, 290.0]))
+    time = sc.array(dims=['event'], values=[5, 10, 25, 35], unit='ns')
+    in_range = store.in_range(
+        time, low=sc.scalar(275_000.0, unit='mK'), high=sc.scalar(290.0, unit='K')
+    )
+    np.testing.assert_array_equal(in_range.values, [False, False, True, False])
+
+
+def test_mask_events_masks_flat_events():
+    store = LogStore.from_data_array(make_log([10, 20], [1.0, 2.0]))
+    events = sc.DataArray(
+        sc.ones(dims=['event'], shape=[3]),
+        coords={'pulse_time': sc.array(dims=['event'], values=[5, 15, 25], unit='ns')},
+    )
+    masked = store.mask_events(events, high=sc.scalar(1.5, unit='K'))
+    np.testing.assert_array_equal(masked.masks['T'].values, [True, False, True])
+    assert 'T' not in events.masks
+
+
+def test_mask_events_masks_binned_events():
+    store = LogStore.from_data_array(make_log([10, 20], [1.0, 2.0]))
+    events = sc.DataArray(
+        sc.ones(dims=['event'], shape=[4]),
+        coords={
+            'pulse_time': sc.array(dims=['event'], values=[15, 25, 15, 5], unit='ns')
+        },
+    )
+    binned = sc.bins(
+        begin=sc.array(dims=['pixel'], values=[0, 2], unit=None),
+        dim='event',
+        data=events,
+    )
+    masked = store.mask_events(
+        sc.DataArray(binned), low=sc.scalar(1.5, unit='K'), name='cold'
+    )
+    np.testing.assert_array_equal(
+        masked.bins.constituents['data'].masks['cold'].values,
+        [True, False, True, True],
+    )
+    assert masked.hist().values.tolist() == [1.0, 0.0]
+
+
+def test_mask_events_masks_bins_by_their_pulse_time():
+    store = LogStore.from_data_array(make_log([10, 20], [1.0, 2.0]))
+    events = sc.DataArray(sc.ones(dims=['event'], shape=[3]))
+    binned = sc.DataArray(
+        sc.bins(
+            begin=sc.array(dims=['pulse'], values=[0, 1], unit=None),
+            dim='event',
+            data=events,
+        ),
+        coords={
+            'event_time_zero': sc.datetimes(dims=['pulse'], values=[12, 22], unit='ns')
+        },
+    )
+    masked = store.mask_events(
+        binned, low=sc.scalar(1.5, unit='K'), time='event_time_zero'
+    )
+    np.testing.assert_array_equal(masked.masks['T'].values, [True, False])
+
+
+def test_sort_by_time_returns_sorted_log_unchanged():
+    log = make_log([1, 2, 3], [4.0, 5.0, 6.0])
+    assert sort_by_time(log) is log
+
+
+def test_sort_by_time_sorts_unsorted_log():
+    log = make_log([3, 1, 2], [6.0, 4.0, 5.0])
+    sc.testing.assert_identical(
+        sort_by_time(log), make_log([1, 2, 3], [4.0, 5.0, 6.0])
+    )
@@ -1207,6 +1207,40 @@ def test_EventWorkspace_with_pulse_times():
     )
 
 
+def test_EventWorkspace_copies_events_and_positions_of_all_spectra():
+    ws = mantid.CreateSampleWorkspace(
+        WorkspaceType='Event',
+        NumBanks=1,
+        BankPixelWidth=2,
+        NumEvents=10,
+        StoreInADS=False,
+    )
+    # Scaling turns the events into weighted events
+    ws = mantid.Scale(ws, Factor=2.0, StoreInADS=False)
+    d = scn.mantid.convert_EventWorkspace_to_data_group(ws, load_pulse_times=True)
+    spectra = [ws.getSpectrum(i) for i in range(ws.getNumberHistograms())]
+    events = d['data'].bins.constituents['data']
+
+    np.testing.assert_array_equal(
+        events.coords['tof'].values, np.concatenate([sp.getTofs() for sp in spectra])
+    )
+    np.testing.assert_array_equal(
+        events.coords['pulse_time'].values,
+        np.concatenate([sp.getPulseTimesAsNumpy() for sp in spectra]),
+    )
+    np.testing.assert_array_equal(
+        events.values, np.concatenate([sp.getWeights() for sp in spectra])
+    )
+    spec_info = ws.spectrumInfo()
+    np.testing.assert_array_equal(
+        d['data'].coords['position'].values,
+        [
+            [p.X(), p.Y(), p.Z()]
+            for p in (spec_info.position(i) for i in range(len(spectra)))
+        ],
+    )
+
+
 @pytest.mark.filterwarnings("ignore:convert_EventWorkspace_to_data_array")
 def test_EventWorkspace_with_pulse_times_array():
     small_event_ws = mantid.CreateSampleWorkspace(
@@ -1288,3 +1322,64 @@ def test_load_via_exact_match():
         # Sanity check corrupt full path will fail
         with pytest.raises(ValueError):
             scn.load_with_mantid("fictional_" + fp.name, mantid_alg="DummyLoader")
+
+
+def test_to_event_workspace():
+    from mantid.simpleapi import mtd
+
+    mtd.clear()
+
+    events = sc.DataArray(
+        sc.ones(dims=['event'], shape=[3], with_variances=True, unit='counts'),
+        coords={
+            'tof': sc.array(dims=['event'], values=[10.0, 20.0, 30.0], unit='us'),
+            'pulse_time': sc.datetimes(
+                dims=['event'],
+                values=[
+                    '2023-01-01T00:00:00',
+                    '2023-01-01T00:00:01',
+                    '2023-01-01T00:00:02',
+                ],
+                unit='ns',
+            ),
+        },
+    )
+    data = sc.DataArray(
+        sc.bins(
+            begin=sc.array(dims=['spectrum'], values=[0, 2, 2], unit=None),
+            end=sc.array(dims=['spectrum'], values=[2, 2, 3], unit=None),
+            dim='event',
+            data=events,
+        )
+    )
+
+    ws = scn.to_mantid(data, 'tof')
+
+    assert ws.id() == 'EventWorkspace'
+    assert ws.getNumberHistograms() == 3
+    assert ws.getNumberEvents() == 3
+    assert len(mtd) == 0, f"Workspaces present: {mtd.getObjectNames()}"
+    np.testing.assert_array_equal(ws.getSpectrum(0).getTofs(), [10.0, 20.0])
+    assert ws.getSpectrum(1).getNumberEvents() == 0
+    for i in range(3):
+        np.testing.assert_array_equal(ws.readX(i), [10.0, 30.0])
+    np.testing.assert_array_equal(
+        ws.getSpectrum(2).getPulseTimesAsNumpy(),
+        events.coords['pulse_time'].values[2:],
+    )
+
+
+def test_to_event_workspace_requires_unit_weights():
+    events = sc.DataArray(
+        sc.full(dims=['event'], shape=[2], value=2.0, unit='counts'),
+        coords={'tof': sc.array(dims=['event'], values=[10.0, 20.0], unit='us')},
+    )
+    data = sc.DataArray(
+        sc.bins(
+            begin=sc.array(dims=['spectrum'], values=[0], unit=None),
+            dim='event',
+            data=events,
+        )
+    )
+    with pytest.raises(ValueError):
+        scn.to_mantid(data, 'tof')
@@ -1,7 +1,39 @@
 # SPDX-License-Identifier: BSD-3-Clause
 # Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
+import subprocess
+import sys
+
+import pytest
+
 import scippneutron as pkg
 
 
 def test_has_version():
     assert hasattr(pkg, '__version__')
+
+
+def test_import_does_not_import_heavy_subsystems():
+    code = (
+        'import sys, scippneutron; '
+        'print(",".join(m for m in ("scippneutron.io.nexus.load_nexus", '
+        '"scippneutron.data_streaming.data_stream", "scippneutron.mantid") '
+        'if m in sys.modules))'
+    )
+    result = subprocess.run(
+        [sys.executable, '-c', code], capture_output=True, text=True, check=True
+    )
+    assert result.stdout.strip() == ''
+
+
+def test_lazy_attributes_are_loaded_on_access():
+    from scippneutron.io.nexus.load_nexus import load_nexus
+
+    assert pkg.load_nexus is load_nexus
+    assert 'data_stream' in dir(pkg)
+    assert callable(pkg.data_stream)
+    assert pkg.io.save_xye is not None
+
+
+def test_unknown_attribute_raises_attribute_error():
+    with pytest.raises(AttributeError):
+        pkg.not_an_attribute
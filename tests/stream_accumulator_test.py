@@ -0,0 +1,146 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
+import numpy as np
+import pytest
+import scipp as sc
+from scipp.testing import assert_identical
+
+import scippneutron as scn
+from scippneutron.tof import UnwrapPlan, fakes
+
+# Pulse times of the chunks, one second apart
+_PULSE_TIMES_S = [0, 1, 2, 3, 4]
+
+
+def _stream_chunk(index: int, n_events: int = 100) -> sc.DataArray:
+    """Flat event table as yielded by data_stream"""
+    rng = np.random.default_rng(index)
+    return sc.DataArray(
+        sc.ones(sizes={'event': n_events}, with_variances=True, unit='counts'),
+        coords={
+            'tof': sc.array(
+                dims=['event'], values=rng.uniform(1e6, 5e7, n_events), unit='ns'
+            ),
+            'pulse_time': sc.full(
+                sizes={'event': n_events},
+                value=_PULSE_TIMES_S[index] * 10**9,
+                unit='ns',
+                dtype='int64',
+            ),
+            'detector_id': sc.array(
+                dims=['event'], values=rng.integers(0, 3, n_events), unit=None
+            ),
+        },
+    )
+
+
+def _wavelength_accumulator(**kwargs) -> scn.StreamAccumulator:
+    return scn.StreamAccumulator(
+        {'wavelength': sc.linspace('wavelength', 0.0, 20.0, 11, unit='angstrom')},
+        graph=scn.conversion_graph('tof', 'wavelength', scatter=False),
+        coords={'Ltotal': sc.scalar(50.0, unit='m')},
+        **kwargs,
+    )
+
+
+def _expected(chunks) -> sc.DataArray:
+    events = sc.concat(chunks, 'event')
+    events.coords['Ltotal'] = sc.scalar(50.0, unit='m')
+    wavelength = events.transform_coords(
+        'wavelength',
+        graph=scn.conversion_graph('tof', 'wavelength', scatter=False),
+        keep_intermediate=False,
+    )
+    return wavelength.hist(
+        wavelength=sc.linspace('wavelength', 0.0, 20.0, 11, unit='angstrom')
+    )
+
+
+def test_accumulator_matches_reduction_of_all_events():
+    chunks = [_stream_chunk(i) for i in range(3)]
+    accumulator = _wavelength_accumulator()
+    results = list(accumulator.accumulate(chunks))
+    assert len(results) == 3
+    assert sc.allclose(results[-1].data, _expected(chunks).data)
+    assert sc.allclose(results[0].data, _expected(chunks[:1]).data)
+
+
+def test_accumulator_subtracts_chunks_which_leave_the_window():
+    chunks = [_stream_chunk(i) for i in range(5)]
+    accumulator = _wavelength_accumulator(window=sc.scalar(1.5, unit='s'))
+    for chunk in chunks:
+        result = accumulator.add(chunk)
+    # Pulses at 3 s and 4 s are within 1.5 s of the latest pulse
+    assert sc.allclose(result.data, _expected(chunks[3:]).data)
+
+
+def test_accumulator_ignores_empty_chunks_and_can_be_cleared():
+    accumulator = _wavelength_accumulator()
+    assert accumulator.add(_stream_chunk(0, n_events=0)) is None
+    assert accumulator.add(_stream_chunk(0)) is not None
+    accumulator.clear()
+    assert accumulator.value is None
+
+
+def test_accumulator_bins_by_detector_with_geometry():
+    chunks = [
+        _stream_chunk(i).group(sc.arange('detector_id', 3, unit=None))
+        for i in range(2)
+    ]
+    position = sc.vectors(
+        dims=['detector_id'],
+        values=[[1.0, 0.0, 0.0], [0.0, 0.0, 1.0], [0.0, 1.0, 1.0]],
+        unit='m',
+    )
+    coords = {
+        'position': position,
+        'sample_position': sc.vector([0.0, 0.0, 0.0], unit='m'),
+        'source_position': sc.vector([0.0, 0.0, -50.0], unit='m'),
+    }
+    dspacing = sc.linspace('dspacing', 0.0, 10.0, 21, unit='angstrom')
+    graph = scn.conversion_graph(
+        'tof', 'dspacing', scatter=True, geometry_cache=scn.GeometryCache()
+    )
+    accumulator = scn.StreamAccumulator(
+        {'dspacing': dspacing}, graph=graph, coords=coords
+    )
+    for chunk in chunks:
+        result = accumulator.add(chunk)
+
+    events = sc.concat(chunks, 'pulse').bins.concat('pulse')
+    events.coords.update(coords)
+    expected = events.transform_coords('dspacing', graph=graph).hist(dspacing=dspacing)
+    assert result.dims == ('detector_id', 'dspacing')
+    assert sc.allclose(result.data, expected.data)
+
+
+def test_accumulator_applies_unwrap_plan():
+    source = fakes.FakeSource(
+        frequency=sc.scalar(14.0, unit='Hz'), run_length=sc.scalar(1.0, unit='s')
+    )
+    pulse = fakes.FakePulse(
+        time_min=sc.scalar(0.0, unit='ms'),
+        time_max=sc.scalar(3.0, unit='ms'),
+        wavelength_min=sc.scalar(0.1, unit='angstrom'),
+        wavelength_max=sc.scalar(10.0, unit='angstrom'),
+    )
+    distance = sc.scalar(46.0, unit='m')
+    plan = UnwrapPlan.from_frame_sequence(
+        pulse.chop(fakes.psc_choppers.values()),
+        distance,
+        source.pulse_period,
+        fakes.psc_choppers['psc1'],
+    )
+    chunk = _stream_chunk(0)
+    tof = sc.linspace('tof', 0.0, 2e8, 11, unit='ns')
+    accumulator = scn.StreamAccumulator({'tof': tof}, unwrap_plan=plan)
+    result = accumulator.add(chunk)
+
+    expected = next(plan.apply_to_stream([chunk], in_place=False)).hist(tof=tof)
+    assert_identical(result.data, expected.data)
+
+
+def test_accumulator_raises_for_histogrammed_chunks():
+    accumulator = _wavelength_accumulator()
+    with pytest.raises(ValueError):
+        accumulator.add(_stream_chunk(0).hist(tof=3))
@@ -461,3 +461,111 @@ def test_frame_sequence_getitem_by_distance_selects_correct_chopper(
     distance = sc.scalar(3.0, unit='m')
     result = frames[distance]
     assert_identical(result.bounds(), frames[2].propagate_to(distance).bounds())
+
+
+def _shifted(chopper: chopper_cascade.Chopper, delay: sc.Variable):
+    return chopper_cascade.Chopper(
+        distance=chopper.distance,
+        time_open=chopper.time_open + delay,
+        time_close=chopper.time_close + delay,
+    )
+
+
+@pytest.fixture
+def two_choppers() -> dict:
+    return {
+        'chopper1': chopper_cascade.Chopper(
+            distance=sc.scalar(1.5, unit='m'),
+            time_open=sc.array(dims=['slit'], values=[0.0, 0.002], unit='s'),
+            time_close=sc.array(dims=['slit'], values=[0.001, 0.003], unit='s'),
+        ),
+        'chopper2': chopper_cascade.Chopper(
+            distance=sc.scalar(2.5, unit='m'),
+            time_open=sc.array(dims=['slit'], values=[0.001], unit='s'),
+            time_close=sc.array(dims=['slit'], values=[0.003], unit='s'),
+        ),
+    }
+
+
+def test_frame_batch_chop_matches_frame_chop(
+    source_frame_sequence: chopper_cascade.FrameSequence, two_choppers
+) -> None:
+    frame = source_frame_sequence[0]
+    batch = chopper_cascade.FrameBatch.from_frame(frame, n_configs=3)
+    for chopper in two_choppers.values():
+        frame = frame.chop(chopper)
+        batch = batch.chop(chopper)
+    assert len(batch) == 3
+    for i in range(3):
+        assert batch[i] == frame
+    assert_identical(batch.bounds()['time']['config', 1], frame.bounds()['time'])
+
+
+def test_chop_scan_matches_chopping_with_shifted_choppers(
+    source_frame_sequence: chopper_cascade.FrameSequence, two_choppers
+) -> None:
+    delays = sc.array(dims=['phase'], values=[0.0, 0.0002, 0.0005], unit='s')
+    batch = chopper_cascade.chop_scan(
+        source_frame_sequence[0], two_choppers, {'chopper2': delays}
+    )
+    assert len(batch) == 3
+    for i in range(3):
+        choppers = [
+            two_choppers['chopper1'],
+            _shifted(two_choppers['chopper2'], delays['phase', i]),
+        ]
+        expected = source_frame_sequence.chop(choppers)[-1]
+        assert batch[i] == expected
+
+
+def test_chop_scan_bounds_are_nan_if_no_neutrons_pass(
+    source_frame_sequence: chopper_cascade.FrameSequence, two_choppers
+) -> None:
+    # The second delay closes chopper2 before any neutrons arrive
+    delays = sc.array(dims=['phase'], values=[0.0, -1.0], unit='s')
+    batch = chopper_cascade.chop_scan(
+        source_frame_sequence[0], two_choppers, {'chopper2': delays}
+    )
+    bounds = batch.propagate_to(sc.scalar(10.0, unit='m')).bounds(dim='phase')
+    assert bounds['time'].sizes == {'phase': 2, 'bound': 2}
+    assert not sc.isnan(bounds['time']['phase', 0]).any().value
+    assert sc.isnan(bounds['time']['phase', 1]).all().value
+    assert batch[1].subframes == []
+
+
+def test_chop_scan_raises_if_delays_have_different_sizes(
+    source_frame_sequence: chopper_cascade.FrameSequence, two_choppers
+) -> None:
+    delays = {
+        'chopper1': sc.zeros(dims=['phase'], shape=[2], unit='s'),
+        'chopper2': sc.zeros(dims=['phase'], shape=[3], unit='s'),
+    }
+    with pytest.raises(sc.DimensionError):
+        chopper_cascade.chop_scan(source_frame_sequence[0], two_choppers, delays)
+
+
+def test_frame_sequence_at_matches_frame_at_each_distance(
+    source_frame_sequence: chopper_cascade.FrameSequence, two_choppers
+) -> None:
+    frames = source_frame_sequence.chop(two_choppers.values())
+    distances = sc.array(
+        dims=['x', 'y'], values=[[0.5, 2.0, 5.0], [12.0, 5.0, 30.0]], unit='m'
+    )
+    stacked = frames.at(distances)
+    assert stacked['time'].dims == ('x', 'y', 'subframe', 'vertex')
+    assert stacked['bounds']['time'].dims == ('x', 'y', 'bound')
+    for x in range(2):
+        for y in range(3):
+            frame = frames[distances['x', x]['y', y]]
+            assert_identical(stacked['bounds']['x', x]['y', y], frame.bounds())
+            subbounds = chopper_cascade.present_subframes(
+                stacked['subbounds']['x', x]['y', y]
+            )
+            assert_identical(subbounds, frame.subbounds())
+
+
+def test_frame_sequence_at_raises_if_distance_is_before_first_frame(
+    source_frame_sequence: chopper_cascade.FrameSequence,
+) -> None:
+    with pytest.raises(ValueError):
+        source_frame_sequence.at(sc.array(dims=['x'], values=[1.0, -1.0], unit='m'))
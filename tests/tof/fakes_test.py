@@ -43,3 +43,78 @@ def test_fake_monitor(ess_10s_14Hz) -> None:
     )
     mon, _ = beamline.get_monitor('monitor')
     assert mon.sizes == {'pulse': 140}
+
+
+@pytest.fixture
+def wfm_beamline(ess_10s_14Hz) -> fakes.FakeBeamline:
+    pulse = fakes.FakePulse(
+        time_min=sc.scalar(0.0, unit='ms'),
+        time_max=sc.scalar(3.0, unit='ms'),
+        wavelength_min=sc.scalar(0.1, unit='angstrom'),
+        wavelength_max=sc.scalar(10.0, unit='angstrom'),
+    )
+    return fakes.FakeBeamline(
+        source=ess_10s_14Hz,
+        pulse=pulse,
+        choppers=fakes.wfm_choppers,
+        monitors={'monitor': sc.scalar(26.0, unit='m')},
+        detectors={'detector': sc.scalar(30.0, unit='m')},
+    )
+
+
+def test_bulk_events_chunks_cover_all_pulses(wfm_beamline, ess_10s_14Hz) -> None:
+    generator = wfm_beamline.bulk_events('monitor', pulses_per_chunk=30)
+    assert generator.n_chunks == 5
+    chunks = list(generator.chunks())
+    assert [chunk.sizes['pulse'] for chunk in chunks] == [30, 30, 30, 30, 20]
+    assert_identical(
+        sc.concat([chunk.coords['event_time_zero'] for chunk in chunks], 'pulse'),
+        ess_10s_14Hz.t0,
+    )
+    event_time_offset = chunks[0].bins.concat().value.coords['event_time_offset']
+    assert (event_time_offset >= sc.scalar(0.0, unit='s')).all().value
+    assert (event_time_offset < ess_10s_14Hz.pulse_period).all().value
+
+
+def test_bulk_events_chunks_are_reproducible_and_independent(wfm_beamline) -> None:
+    generator = wfm_beamline.bulk_events('detector', pulses_per_chunk=40, n_pixels=10)
+    chunks = list(generator.chunks())
+    assert_identical(generator.chunk(2), chunks[2])
+    assert_identical(next(generator.chunks(start=3)), chunks[3])
+    other = wfm_beamline.bulk_events('detector', pulses_per_chunk=40, seed=1)
+    assert not sc.identical(other.chunk(0).bins.size(), chunks[0].bins.size())
+    event_id = chunks[0].bins.concat().value.coords['event_id']
+    assert event_id.min().value >= 0
+    assert event_id.max().value < 10
+
+
+def test_bulk_events_ev42_payloads_match_chunks(wfm_beamline) -> None:
+    ev42 = pytest.importorskip('streaming_data_types.eventdata_ev42')
+    generator = wfm_beamline.bulk_events('detector', pulses_per_chunk=40, n_pixels=10)
+    payloads = list(generator.ev42_payloads(stop=1))
+    chunk = generator.chunk(0)
+    assert len(payloads) == 40
+    for i in (0, 39):
+        message = ev42.deserialise_ev42(payloads[i])
+        events = chunk['pulse', i].value
+        assert message.pulse_time == chunk.coords['event_time_zero'][i].value.astype(
+            'int64'
+        )
+        assert list(message.detector_id) == list(events.coords['event_id'].values)
+        assert len(message.time_of_flight) == events.sizes['event']
+
+
+def test_detector_frames_match_frames_propagated_to_detectors(wfm_beamline) -> None:
+    pulse = fakes.FakePulse(
+        time_min=sc.scalar(0.0, unit='ms'),
+        time_max=sc.scalar(3.0, unit='ms'),
+        wavelength_min=sc.scalar(0.1, unit='angstrom'),
+        wavelength_max=sc.scalar(10.0, unit='angstrom'),
+    )
+    expected = pulse.chop(fakes.wfm_choppers.values())[sc.scalar(30.0, unit='m')]
+    frame = wfm_beamline.detectors['detector']
+    assert_identical(frame.distance, expected.distance)
+    assert len(frame.subframes) == len(expected.subframes)
+    for subframe, expected_subframe in zip(frame.subframes, expected.subframes):
+        assert sc.allclose(subframe.time, expected_subframe.time)
+        assert sc.allclose(subframe.wavelength, expected_subframe.wavelength)
@@ -1,3 +1,5 @@
+import asyncio
+
 import pytest
 import scipp as sc
 from scipp.testing import assert_identical
@@ -61,3 +63,229 @@ def test_to_time_of_flight_event_mode() -> None:
         result.value.coords['time_zero'],
         sc.array(dims=['event'], values=[11.0, 21.0], unit='s'),
     )
+
+
+def _frame_bounds() -> unwrap.FrameBounds:
+    return unwrap.FrameBounds(
+        sc.DataGroup(time=sc.array(dims=['bound'], values=[10.0, 20.0], unit='ms'))
+    )
+
+
+def _origin() -> unwrap.TimeOfFlightOrigin:
+    return unwrap.TimeOfFlightOrigin(
+        time=sc.scalar(5.0, unit='ms'), distance=sc.scalar(1.0, unit='m')
+    )
+
+
+def _raw_events() -> sc.DataArray:
+    return sc.DataArray(
+        data=sc.ones(dims=['event'], shape=[3], unit='counts'),
+        coords={
+            'event_time_offset': sc.array(
+                dims=['event'], values=[5.0, 15.0, 50.0], unit='ms'
+            ),
+            'event_time_zero': sc.array(
+                dims=['event'], values=[0, 100_000_000, 200_000_000], unit='ns'
+            ),
+        },
+    )
+
+
+@pytest.mark.parametrize('in_place', [False, True])
+def test_unwrap_to_time_of_flight_event_table(in_place) -> None:
+    raw = _raw_events()
+    original = raw.copy()
+    result = unwrap.unwrap_to_time_of_flight(
+        raw,
+        frame_bounds=_frame_bounds(),
+        frame_period=sc.scalar(100.0, unit='ms'),
+        origin=_origin(),
+        ltotal=sc.scalar(3.0, unit='m'),
+        in_place=in_place,
+    )
+
+    assert_identical(
+        result.coords['tof'],
+        sc.array(dims=['event'], values=[100.0, 10.0, 45.0], unit='ms'),
+    )
+    assert_identical(
+        result.coords['time_zero'],
+        sc.array(
+            dims=['event'], values=[-95_000_000, 105_000_000, 205_000_000], unit='ns'
+        ),
+    )
+    assert_identical(result.coords['Ltotal'], sc.scalar(2.0, unit='m'))
+    if in_place:
+        assert result is raw
+        assert 'event_time_offset' not in result.coords
+        assert 'event_time_zero' not in result.coords
+    else:
+        assert_identical(raw, original)
+        assert_identical(
+            result.coords['event_time_offset'], original.coords['event_time_offset']
+        )
+
+
+def test_unwrap_to_time_of_flight_computes_tof_in_requested_dtype() -> None:
+    result = unwrap.unwrap_to_time_of_flight(
+        _raw_events(),
+        frame_bounds=_frame_bounds(),
+        frame_period=sc.scalar(100.0, unit='ms'),
+        origin=_origin(),
+        ltotal=sc.scalar(3.0, unit='m'),
+        dtype='float32',
+    )
+    assert_identical(
+        result.coords['tof'],
+        sc.array(
+            dims=['event'], values=[100.0, 10.0, 45.0], unit='ms', dtype='float32'
+        ),
+    )
+
+
+def test_unwrap_to_time_of_flight_matches_unwrap_data_and_to_time_of_flight() -> None:
+    events = _raw_events()
+    del events.coords['event_time_zero']
+    raw = sc.DataArray(
+        sc.bins(
+            begin=sc.array(dims=['pulse'], values=[0, 2], unit=None),
+            end=sc.array(dims=['pulse'], values=[2, 3], unit=None),
+            dim='event',
+            data=events,
+        ),
+        coords={
+            'event_time_zero': sc.datetimes(
+                dims=['pulse'], values=[0, 100_000_000], unit='ns'
+            )
+        },
+    )
+    frame_period = sc.scalar(100.0, unit='ms')
+    ltotal = sc.scalar(3.0, unit='m')
+    delta = unwrap.offset_from_wrapped(
+        raw.bins.coords['event_time_offset'], _frame_bounds(), frame_period
+    )
+    expected = unwrap.to_time_of_flight(
+        unwrap.unwrap_data(raw, delta), origin=_origin(), ltotal=ltotal
+    )
+    result = unwrap.unwrap_to_time_of_flight(
+        raw,
+        frame_bounds=_frame_bounds(),
+        frame_period=frame_period,
+        origin=_origin(),
+        ltotal=ltotal,
+    )
+
+    assert 'event_time_zero' in raw.coords
+    assert 'event_time_zero' not in result.coords
+    assert_identical(result.coords['Ltotal'], expected.coords['Ltotal'])
+    for name in ('tof', 'time_zero'):
+        assert_identical(result.bins.coords[name], expected.bins.coords[name])
+
+
+def test_unwrap_to_time_of_flight_rounds_time_zero_like_two_step_path() -> None:
+    # Offsets with fractional nanoseconds, for which rounding the sum of the
+    # unwrapping offset and the origin differs from rounding each of them
+    raw = sc.DataArray(
+        data=sc.ones(dims=['event'], shape=[2], unit='counts'),
+        coords={
+            'event_time_offset': sc.array(
+                dims=['event'], values=[600.0, 100.0], unit='ns'
+            ),
+            'event_time_zero': sc.array(
+                dims=['event'], values=[1_000_000, 2_000_000], unit='ns'
+            ),
+        },
+    )
+    frame_bounds = unwrap.FrameBounds(
+        sc.DataGroup(time=sc.array(dims=['bound'], values=[1500.0, 1600.0], unit='ns'))
+    )
+    frame_period = sc.scalar(1000.6, unit='ns')
+    origin = unwrap.TimeOfFlightOrigin(
+        time=sc.scalar(0.4, unit='ns'), distance=sc.scalar(1.0, unit='m')
+    )
+    ltotal = sc.scalar(3.0, unit='m')
+    binned = sc.DataArray(sc.bins(begin=sc.index(0), dim='event', data=raw))
+    delta = unwrap.offset_from_wrapped(
+        binned.bins.coords['event_time_offset'], frame_bounds, frame_period
+    )
+    expected = unwrap.to_time_of_flight(
+        unwrap.unwrap_data(binned, delta), origin=origin, ltotal=ltotal
+    )
+
+    for in_place in (False, True):
+        result = unwrap.unwrap_to_time_of_flight(
+            binned.copy(),
+            frame_bounds=frame_bounds,
+            frame_period=frame_period,
+            origin=origin,
+            ltotal=ltotal,
+            in_place=in_place,
+        )
+        for name in ('tof', 'time_zero'):
+            assert_identical(result.bins.coords[name], expected.bins.coords[name])
+
+
+def _stream_chunk(pulse_time_ns: int) -> sc.DataArray:
+    return sc.DataArray(
+        data=sc.ones(dims=['event'], shape=[2], with_variances=True),
+        coords={
+            'tof': sc.array(
+                dims=['event'], values=[5_000_000, 15_000_000], unit='ns', dtype='int32'
+            ),
+            'pulse_time': sc.full(
+                dims=['event'], shape=[2], value=pulse_time_ns, unit='ns', dtype='int64'
+            ),
+        },
+    )
+
+
+def _unwrap_stream(chunks):
+    return unwrap.unwrap_stream_to_time_of_flight(
+        chunks,
+        frame_bounds=_frame_bounds(),
+        frame_period=sc.scalar(100.0, unit='ms'),
+        origin=_origin(),
+        ltotal=sc.scalar(3.0, unit='m'),
+    )
+
+
+def test_unwrap_stream_to_time_of_flight() -> None:
+    results = list(_unwrap_stream([_stream_chunk(0), _stream_chunk(100_000_000)]))
+
+    assert len(results) == 2
+    for result, pulse_time in zip(results, (0, 100_000_000)):
+        assert_identical(
+            result.coords['tof'],
+            sc.array(dims=['event'], values=[100_000_000.0, 10_000_000.0], unit='ns'),
+        )
+        assert_identical(
+            result.coords['time_zero'],
+            sc.array(
+                dims=['event'],
+                values=[pulse_time - 95_000_000, pulse_time + 5_000_000],
+                unit='ns',
+            ),
+        )
+
+
+def test_unwrap_stream_to_time_of_flight_of_async_stream() -> None:
+    async def stream():
+        yield _stream_chunk(0)
+
+    async def collect():
+        return [chunk async for chunk in _unwrap_stream(stream())]
+
+    (result,) = asyncio.run(collect())
+    assert_identical(
+        result.coords['tof'],
+        sc.array(dims=['event'], values=[100_000_000.0, 10_000_000.0], unit='ns'),
+    )
+
+
+def test_unwrap_stream_to_time_of_flight_raises_for_histogrammed_chunks() -> None:
+    chunk = sc.DataArray(
+        sc.ones(dims=['tof'], shape=[2]),
+        coords={'tof': sc.array(dims=['tof'], values=[0, 1, 2], unit='ns')},
+    )
+    with pytest.raises(ValueError, match='Histogrammed'):
+        list(_unwrap_stream([chunk]))
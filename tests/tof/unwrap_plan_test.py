@@ -0,0 +1,307 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2023 Scipp contributors (https://github.com/scipp)
+import pickle
+
+import numpy as np
+import pytest
+import scipp as sc
+from scipp.testing import assert_allclose, assert_identical
+
+from scippneutron.tof import UnwrapPlan, chopper_cascade, fakes, unwrap
+
+
+@pytest.fixture
+def ess_10s_14Hz() -> fakes.FakeSource:
+    return fakes.FakeSource(
+        frequency=sc.scalar(14.0, unit='Hz'), run_length=sc.scalar(10.0, unit='s')
+    )
+
+
+@pytest.fixture
+def ess_pulse() -> fakes.FakePulse:
+    return fakes.FakePulse(
+        time_min=sc.scalar(0.0, unit='ms'),
+        time_max=sc.scalar(3.0, unit='ms'),
+        wavelength_min=sc.scalar(0.1, unit='angstrom'),
+        wavelength_max=sc.scalar(10.0, unit='angstrom'),
+    )
+
+
+def _frames(pulse, choppers) -> chopper_cascade.FrameSequence:
+    frames = chopper_cascade.FrameSequence.from_source_pulse(
+        time_min=pulse.time_min,
+        time_max=pulse.time_max,
+        wavelength_min=pulse.wavelength_min,
+        wavelength_max=pulse.wavelength_max,
+    )
+    return frames.chop(choppers.values())
+
+
+def _monitor(source, pulse, choppers, distance, **kwargs) -> sc.DataArray:
+    beamline = fakes.FakeBeamline(
+        source=source,
+        pulse=pulse,
+        choppers=choppers,
+        monitors={'monitor': distance},
+        detectors={},
+        **kwargs,
+    )
+    mon, _ = beamline.get_monitor('monitor')
+    return mon
+
+
+def _assert_same_tof(result: sc.DataArray, expected: sc.DataArray) -> None:
+    result = result.bins.concat().value
+    expected = expected.bins.concat().value
+    assert_allclose(
+        result.coords['tof'],
+        expected.coords['tof'],
+        rtol=sc.scalar(1e-12),
+        equal_nan=True,
+    )
+    # Events outside of all subframes have no time-of-flight, the time_zero of
+    # unwrap_to_time_of_flight is meaningless for them
+    valid = np.isfinite(expected.coords['tof'].values)
+    np.testing.assert_array_equal(
+        result.coords['time_zero'].values[valid],
+        expected.coords['time_zero'].values[valid],
+    )
+
+
+def _expected(mon, frames, frame_period, origin, ltotal) -> sc.DataArray:
+    return unwrap.unwrap_to_time_of_flight(
+        mon,
+        frame_bounds=unwrap.frame_bounds(frames[ltotal]),
+        frame_period=frame_period,
+        origin=origin,
+        ltotal=ltotal,
+    )
+
+
+def test_unwrap_plan_matches_unwrap_to_time_of_flight(ess_10s_14Hz, ess_pulse) -> None:
+    distance = sc.scalar(46.0, unit='m')
+    mon = _monitor(
+        ess_10s_14Hz,
+        ess_pulse,
+        fakes.psc_choppers,
+        distance,
+        time_of_flight_origin='psc1',
+    )
+    frames = _frames(ess_pulse, fakes.psc_choppers)
+    source_chopper = fakes.psc_choppers['psc1']
+    plan = UnwrapPlan.from_frame_sequence(
+        frames, distance, ess_10s_14Hz.pulse_period, source_chopper
+    )
+
+    result = plan.apply(mon)
+    expected = _expected(
+        mon,
+        frames,
+        ess_10s_14Hz.pulse_period,
+        unwrap.time_of_flight_origin_from_chopper(source_chopper),
+        distance,
+    )
+    assert_identical(result.coords['Ltotal'], expected.coords['Ltotal'])
+    _assert_same_tof(result, expected)
+
+
+def test_wfm_unwrap_plan_matches_unwrap_to_time_of_flight(
+    ess_10s_14Hz, ess_pulse
+) -> None:
+    distance = sc.scalar(20.0, unit='m')
+    choppers = fakes.wfm_choppers.copy()
+    choppers['wfm1'] = choppers['wfm1'][2:]
+    mon = _monitor(ess_10s_14Hz, ess_pulse, choppers, distance)
+    frames = _frames(ess_pulse, choppers)
+    plan = UnwrapPlan.from_frame_sequence(
+        frames, distance, ess_10s_14Hz.pulse_period, choppers['wfm1'], wfm=True
+    )
+
+    result = plan.apply(mon)
+    expected = _expected(
+        mon,
+        frames,
+        ess_10s_14Hz.pulse_period,
+        unwrap.time_of_flight_origin_wfm_from_chopper(
+            choppers['wfm1'], unwrap.subframe_bounds(frames[distance])
+        ),
+        distance,
+    )
+    _assert_same_tof(result, expected)
+
+
+def test_wfm_unwrap_plan_keeps_time_zero_of_events_outside_of_subframes(
+    ess_10s_14Hz, ess_pulse
+) -> None:
+    distance = sc.scalar(20.0, unit='m')
+    choppers = fakes.wfm_choppers.copy()
+    choppers['wfm1'] = choppers['wfm1'][2:]
+    mon = _monitor(ess_10s_14Hz, ess_pulse, choppers, distance)
+    plan = UnwrapPlan.from_frame_sequence(
+        _frames(ess_pulse, choppers),
+        distance,
+        ess_10s_14Hz.pulse_period,
+        choppers['wfm1'],
+        wfm=True,
+    )
+    pulse = int(np.flatnonzero(mon.bins.size().values)[0])
+    constituents = mon.bins.constituents
+    events = constituents['data'].copy()
+    offset = events.coords['event_time_offset']
+    first = int(constituents['begin'].values[pulse])
+    # Far outside of the frame, so in no subframe
+    offset.values[first] = -10 * ess_10s_14Hz.pulse_period.to(unit=offset.unit).value
+    mon = sc.DataArray(
+        sc.bins(**{**constituents, 'data': events}), coords=dict(mon.coords)
+    )
+
+    result = plan.apply(mon)['pulse', pulse].values.copy()
+    assert np.isnan(result.coords['tof'].values[0])
+    assert_identical(
+        result.coords['time_zero']['event', 0], mon.coords['event_time_zero'][pulse]
+    )
+
+
+def test_unwrap_plan_uses_table_of_distance_of_each_pixel(
+    ess_10s_14Hz, ess_pulse
+) -> None:
+    distances = sc.array(dims=['detector'], values=[46.0, 50.0, 46.0], unit='m')
+    monitors = [
+        _monitor(
+            ess_10s_14Hz,
+            ess_pulse,
+            fakes.psc_choppers,
+            distances['detector', i],
+            time_of_flight_origin='psc1',
+        )
+        for i in range(len(distances))
+    ]
+    frames = _frames(ess_pulse, fakes.psc_choppers)
+    source_chopper = fakes.psc_choppers['psc1']
+    plan = UnwrapPlan.from_frame_sequence(
+        frames, distances, ess_10s_14Hz.pulse_period, source_chopper
+    )
+    assert plan.row.tolist() == [0, 1, 0]
+
+    result = plan.apply(sc.concat(monitors, 'detector'))
+    assert_identical(result.coords['Ltotal'], distances)
+    for i, mon in enumerate(monitors):
+        expected = _expected(
+            mon,
+            frames,
+            ess_10s_14Hz.pulse_period,
+            unwrap.time_of_flight_origin_from_chopper(source_chopper),
+            distances['detector', i],
+        )
+        _assert_same_tof(result['detector', i], expected)
+
+
+def test_unwrap_plan_shares_tables_of_distances_within_resolution(
+    ess_10s_14Hz, ess_pulse
+) -> None:
+    distances = sc.array(dims=['detector'], values=[46.0, 46.0004, 50.0], unit='m')
+    args = (
+        _frames(ess_pulse, fakes.psc_choppers),
+        distances,
+        ess_10s_14Hz.pulse_period,
+        fakes.psc_choppers['psc1'],
+    )
+    assert UnwrapPlan.from_frame_sequence(*args).row.tolist() == [0, 0, 1]
+    exact = UnwrapPlan.from_frame_sequence(
+        *args, distance_resolution=sc.scalar(0.0, unit='m')
+    )
+    assert exact.row.tolist() == [0, 1, 2]
+
+
+def test_wfm_unwrap_plan_of_many_distances_matches_plans_of_each_distance(
+    ess_10s_14Hz, ess_pulse
+) -> None:
+    distances = sc.array(dims=['detector'], values=[20.0, 21.0], unit='m')
+    choppers = fakes.wfm_choppers.copy()
+    choppers['wfm1'] = choppers['wfm1'][2:]
+    args = (
+        _frames(ess_pulse, choppers),
+        ess_10s_14Hz.pulse_period,
+        choppers['wfm1'],
+    )
+    plan = UnwrapPlan.from_frame_sequence(args[0], distances, *args[1:], wfm=True)
+    for i in range(len(distances)):
+        single = UnwrapPlan.from_frame_sequence(
+            args[0], distances['detector', i], *args[1:], wfm=True
+        )
+        n_edges = np.count_nonzero(np.isfinite(single.edges[0]))
+        row = plan.row[i]
+        np.testing.assert_array_equal(
+            plan.edges[row, :n_edges], single.edges[0, :n_edges]
+        )
+        np.testing.assert_array_equal(
+            plan.shift[row, : n_edges + 1], single.shift[0, : n_edges + 1]
+        )
+        np.testing.assert_array_equal(plan.first_edge[row], single.first_edge[0])
+
+
+def test_unwrap_plan_with_few_cells_falls_back_to_search(
+    ess_10s_14Hz, ess_pulse
+) -> None:
+    distance = sc.scalar(20.0, unit='m')
+    choppers = fakes.wfm_choppers.copy()
+    choppers['wfm1'] = choppers['wfm1'][2:]
+    mon = _monitor(ess_10s_14Hz, ess_pulse, choppers, distance)
+    frames = _frames(ess_pulse, choppers)
+    args = (frames, distance, ess_10s_14Hz.pulse_period, choppers['wfm1'])
+    coarse = UnwrapPlan.from_frame_sequence(*args, wfm=True, n_cells=2)
+    fine = UnwrapPlan.from_frame_sequence(*args, wfm=True)
+
+    _assert_same_tof(coarse.apply(mon), fine.apply(mon))
+
+
+def test_unwrap_plan_can_be_serialised(ess_10s_14Hz, ess_pulse) -> None:
+    distance = sc.scalar(46.0, unit='m')
+    mon = _monitor(
+        ess_10s_14Hz,
+        ess_pulse,
+        fakes.psc_choppers,
+        distance,
+        time_of_flight_origin='psc1',
+    )
+    plan = UnwrapPlan.from_frame_sequence(
+        _frames(ess_pulse, fakes.psc_choppers),
+        distance,
+        ess_10s_14Hz.pulse_period,
+        fakes.psc_choppers['psc1'],
+    )
+    expected = plan.apply(mon)
+
+    for restored in (
+        UnwrapPlan.from_dict(plan.to_dict()),
+        pickle.loads(pickle.dumps(plan)),
+    ):
+        assert_identical(restored.apply(mon), expected)
+
+
+def test_unwrap_plan_in_place_overwrites_event_columns(
+    ess_10s_14Hz, ess_pulse
+) -> None:
+    distance = sc.scalar(46.0, unit='m')
+    mon = _monitor(
+        ess_10s_14Hz,
+        ess_pulse,
+        fakes.psc_choppers,
+        distance,
+        time_of_flight_origin='psc1',
+    )
+    plan = UnwrapPlan.from_frame_sequence(
+        _frames(ess_pulse, fakes.psc_choppers),
+        distance,
+        ess_10s_14Hz.pulse_period,
+        fakes.psc_choppers['psc1'],
+    )
+    expected = plan.apply(mon)
+    result = plan.apply(mon, in_place=True)
+
+    assert result is mon
+    assert 'event_time_offset' not in result.bins.coords
+    assert_identical(
+        result.bins.concat().value.coords['tof'],
+        expected.bins.concat().value.coords['tof'],
+    )
@@ -3,7 +3,7 @@
 # @author Simon Heybrock
 import pytest
 import scipp as sc
-from scipp.testing import assert_identical
+from scipp.testing import assert_allclose, assert_identical
 
 from scippneutron.tof import fakes, unwrap
 
@@ -363,3 +363,95 @@ def test_wfm_unwrap(ess_10s_14Hz, ess_pulse) -> None:
     ref.coords['Ltotal'] = distance - choppers['wfm1'].distance
     # FakeBeamline does not support WFM yet, we cannot run a better check for now.
     assert_identical(result.sum(), ref.sum())
+
+
+def _tof_pipeline(providers, raw, beamline, pulse, choppers, source_chopper_name):
+    pl = sl.Pipeline(providers)
+    pl[unwrap.RawData] = raw
+    pl[unwrap.PulsePeriod] = beamline._source.pulse_period
+    pl[unwrap.SourceTimeRange] = pulse.time_min, pulse.time_max
+    pl[unwrap.SourceWavelengthRange] = (pulse.wavelength_min, pulse.wavelength_max)
+    pl[unwrap.Choppers] = choppers
+    pl[unwrap.SourceChopperName] = source_chopper_name
+    return pl
+
+
+@pytest.mark.parametrize('pulse_skipping', [False, True])
+def test_fused_unwrap_matches_unwrap_then_to_time_of_flight(
+    ess_10s_14Hz, ess_10s_7Hz, ess_pulse, pulse_skipping
+) -> None:
+    distance = sc.scalar(46.0, unit='m')
+    beamline = fakes.FakeBeamline(
+        source=ess_10s_7Hz if pulse_skipping else ess_10s_14Hz,
+        pulse=ess_pulse,
+        choppers=fakes.psc_choppers,
+        monitors={'monitor': distance},
+        detectors={},
+        time_of_flight_origin='psc1',
+    )
+    mon, ref = beamline.get_monitor('monitor')
+
+    origin_providers = unwrap.time_of_flight_origin_from_choppers_providers()
+    results = []
+    for providers in (
+        unwrap.unwrap_providers(pulse_skipping=pulse_skipping)
+        + unwrap.time_of_flight_providers(),
+        unwrap.fused_unwrap_providers(pulse_skipping=pulse_skipping),
+    ):
+        pl = _tof_pipeline(
+            providers + origin_providers,
+            mon,
+            beamline,
+            ess_pulse,
+            fakes.psc_choppers,
+            'psc1',
+        )
+        pl[unwrap.Ltotal] = distance
+        if pulse_skipping:
+            pl[unwrap.PulsePeriod] = 0.5 * beamline._source.pulse_period
+            pl[unwrap.PulseStride] = 2
+        results.append(pl.compute(unwrap.TofData))
+    expected, result = results
+
+    assert 'time_offset' not in result.bins.coords
+    assert_identical(result.coords['Ltotal'], expected.coords['Ltotal'])
+    assert_identical(result.sum(), ref.sum())
+    assert_allclose(
+        result.bins.concat().value.coords['tof'],
+        expected.bins.concat().value.coords['tof'],
+    )
+
+
+def test_fused_wfm_unwrap(ess_10s_14Hz, ess_pulse) -> None:
+    distance = sc.scalar(20.0, unit='m')
+    choppers = fakes.wfm_choppers.copy()
+    choppers['wfm1'] = choppers['wfm1'][2:]
+    beamline = fakes.FakeBeamline(
+        source=ess_10s_14Hz,
+        pulse=ess_pulse,
+        choppers=choppers,
+        monitors={'monitor': distance},
+        detectors={},
+    )
+    mon, ref = beamline.get_monitor('monitor')
+
+    origin_providers = unwrap.time_of_flight_origin_from_choppers_providers(wfm=True)
+    results = []
+    for providers in (
+        unwrap.unwrap_providers() + unwrap.time_of_flight_providers(),
+        unwrap.fused_unwrap_providers(),
+    ):
+        pl = _tof_pipeline(
+            providers + origin_providers, mon, beamline, ess_pulse, choppers, 'wfm1'
+        )
+        pl[unwrap.Ltotal] = distance
+        results.append(pl.compute(unwrap.TofData))
+    expected, result = results
+
+    assert_identical(result.sum(), expected.sum())
+    # Events outside of subframes have NaN tof in both cases
+    assert_allclose(
+        result.bins.concat().value.coords['tof'],
+        expected.bins.concat().value.coords['tof'],
+        equal_nan=True,
+    )